@@ -12,6 +12,9 @@
 #   - taskset is part of util-linux.
 #
 # Adjust the CORE variable below to select the core(s) to bind.
+# Arguments are passed on to the benchmark. With --mode=threads or --mode=huge_pages
+# the process is bound to all cores in THREAD_CORES instead, so the threads can spread
+# out (huge_pages places one replica per NUMA node of the cores it may use).
 
 # Stop TLP (if enabled)
 echo "Stopping TLP..."
@@ -23,12 +26,18 @@ sudo cpupower frequency-set --governor performance
 
 # Specify the CPU core(s) to bind to. (For example, core 1.)
 CORE="1"
+THREAD_CORES="0-$(($(nproc --all) - 1))"
+for arg in "$@"; do
+  if [ "$arg" = "--mode=threads" ] || [ "$arg" = "--mode=huge_pages" ]; then
+    CORE="$THREAD_CORES"
+  fi
+done
 echo "Running benchmark on core(s): $CORE"
 
 # Run the benchmark using taskset to bind to the specified core.
 # Use chrt to set real-time priority (SCHED_FIFO with priority 99).
 # Adjust the command "./benchmark" if your executable is in a different location.
-taskset -c $CORE sudo chrt -f 99 ./benchmark
+taskset -c $CORE sudo chrt -f 99 ./benchmark "$@"
 
 # Restart TLP after benchmark
 echo "Benchmark complete. Restarting TLP..."
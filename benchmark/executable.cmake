@@ -1 +1,2 @@
-target_link_libraries(${TARGET_NAME} PRIVATE tries)
+find_package(Threads REQUIRED)
+target_link_libraries(${TARGET_NAME} PRIVATE tries Threads::Threads)
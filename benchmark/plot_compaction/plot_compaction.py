@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_before_after(df, before, after, ylabel, title, output_file):
+    """
+    Grouped bars of a metric before and after compaction for each variant.
+    """
+    x = range(len(df))
+    width = 0.4
+    plt.figure(figsize=(10, 6))
+    plt.bar([i - width / 2 for i in x], df[before], width, label="after churn")
+    plt.bar([i + width / 2 for i in x], df[after], width, label="after compact()")
+    plt.xticks(list(x), df["variant"])
+    plt.ylabel(ylabel)
+    plt.title(title)
+    plt.legend()
+    plt.grid(True, axis="y")
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_compaction{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plot_before_after(df, "contains_before_ns", "contains_after_ns", "Contains Time (ns)", "Compaction: Contains Time after Churn",
+                      f"plot_compaction_contains{suffix}.png")
+    plot_before_after(df, "size_before", "size_after", "Size (bytes)", "Compaction: Memory after Churn", f"plot_compaction_size{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_workload(df, workload, output_file):
+    """
+    Grouped bars: one group per variant, one bar per dispatch.
+    """
+    data = df[df["workload"] == workload].pivot(index="variant", columns="dispatch", values="throughput_ops_per_s")
+    data.plot(kind="bar", figsize=(10, 6))
+    plt.xticks(rotation=0)
+    plt.xlabel("Variant")
+    plt.ylabel("Throughput (queries/s)")
+    plt.title(f"Dispatch: {workload} Queries")
+    plt.grid(True, axis="y")
+    plt.tight_layout()
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_dispatch{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    for workload in df["workload"].unique():
+        plot_workload(df, workload, f"plot_dispatch_{workload}{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_insert_throughput(csv_file, output_file):
+    """
+    Plots durable insert throughput vs. group commit size (records per fsync) for each variant.
+    """
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plt.figure(figsize=(10, 6))
+    for variant in df["variant"].unique():
+        sub = df[df["variant"] == variant]
+        plt.plot(sub["group_commit"], sub["throughput_ops_per_s"], marker="o", label=variant)
+    plt.xscale("log", base=2)
+    plt.xlabel("Group Commit Size (records per fsync)")
+    plt.ylabel("Insert Throughput (ops/s)")
+    plt.title("Durability: Insert Throughput vs. fsync Batching")
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def plot_startup_time(csv_file, output_file):
+    """
+    Plots restart time vs. number of logged mutations for each (variant, strategy) pair.
+    """
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plt.figure(figsize=(10, 6))
+    for (variant, strategy), sub in df.groupby(["variant", "strategy"], sort=False):
+        linestyle = "-" if strategy == "snapshot_tail" else "--"
+        plt.plot(sub["mutations"], sub["startup_time_ns"], marker="o", linestyle=linestyle, label=f"{variant} ({strategy})")
+    plt.xlabel("Mutations")
+    plt.ylabel("Startup Time (ns)")
+    plt.title("Durability: Startup Time (Snapshot + Log Tail vs. Full Replay)")
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    plot_insert_throughput(f"plot_durability_insert{suffix}.csv", f"plot_durability_insert{suffix}.png")
+    plot_startup_time(f"plot_durability_startup{suffix}.csv", f"plot_durability_startup{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,5 @@
 #!/usr/bin/env python3
+import sys
 import pandas as pd
 import matplotlib.pyplot as plt
 
@@ -28,11 +29,14 @@ def plot_fill_factor(csv_file, output_file, title):
     print(f"Plot saved as {output_file}")
 
 def main():
+    # Optional scenario name (see benchmark --scenarios), e.g. "zipf" for plot_fill_factor_insert_zipf.csv
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+
     # Define the list of CSV files, output PNG filenames, and titles.
     experiments = [
-        ("plot_fill_factor_insert.csv", "plot_fill_factor_insert.png", "Fill Factor: Insert Benchmark"),
-        ("plot_fill_factor_contains.csv", "plot_fill_factor_contains.png", "Fill Factor: Contains Benchmark"),
-        ("plot_fill_factor_remove.csv", "plot_fill_factor_remove.png", "Fill Factor: Remove Benchmark")
+        (f"plot_fill_factor_insert{suffix}.csv", f"plot_fill_factor_insert{suffix}.png", "Fill Factor: Insert Benchmark"),
+        (f"plot_fill_factor_contains{suffix}.csv", f"plot_fill_factor_contains{suffix}.png", "Fill Factor: Contains Benchmark"),
+        (f"plot_fill_factor_remove{suffix}.csv", f"plot_fill_factor_remove{suffix}.png", "Fill Factor: Remove Benchmark")
     ]
 
     for csv_file, output_file, title in experiments:
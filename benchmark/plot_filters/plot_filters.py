@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_throughput(df, output_file):
+    """
+    Contains throughput over the share of absent words, one line per variant and filter.
+    """
+    plt.figure(figsize=(10, 6))
+    for (variant, filt), group in df.groupby(["variant", "filter"]):
+        group = group.sort_values("miss_percent")
+        style = "-" if filt == "none" else "--"
+        plt.plot(group["miss_percent"], group["throughput_ops_per_s"], style, marker="o", label=f"{variant} ({filt})")
+    plt.xlabel("Absent Query Words (%)")
+    plt.ylabel("Throughput (contains/s)")
+    plt.title("Membership Filters: Contains Throughput")
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_filters{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plot_throughput(df, f"plot_filters{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+METRICS = [
+    ("construction_ns_per_word", "Construction (ns/word)"),
+    ("contains_ns", "Contains (ns)"),
+    ("prefix_ns_per_word", "Prefix enumeration (ns/word)"),
+    ("bytes_per_word", "Memory (bytes/word)"),
+]
+
+def plot_variants(df, output_file):
+    """
+    One panel per metric, one bar per variant. The tries cannot enumerate prefixes.
+    """
+    data = df.set_index("variant")
+    fig, axes = plt.subplots(2, 2, figsize=(12, 8))
+    for ax, (column, label) in zip(axes.flat, METRICS):
+        values = data[column]
+        if column == "prefix_ns_per_word":
+            values = values[values > 0]
+        values.plot(kind="bar", ax=ax, logy=True)
+        ax.set_title(label)
+        ax.set_xlabel("")
+        ax.tick_params(axis="x", rotation=0)
+        ax.grid(True, axis="y")
+    fig.suptitle("Front-Coded Dictionary vs. Tries")
+    fig.tight_layout()
+    fig.savefig(output_file)
+    plt.close(fig)
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_front_coded{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plot_variants(df, f"plot_front_coded{suffix}.png")
+
+if __name__ == "__main__":
+    main()
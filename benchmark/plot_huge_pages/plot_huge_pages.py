@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_bars(df, column, ylabel, title, output_file):
+    """
+    One bar per layout (with its thread count).
+    """
+    labels = [f"{layout}\n{threads} thread(s)" for layout, threads in zip(df["layout"], df["threads"])]
+    plt.figure(figsize=(12, 6))
+    plt.bar(labels, df[column])
+    plt.xticks(rotation=20, ha="right")
+    plt.ylabel(ylabel)
+    plt.title(title)
+    plt.grid(True, axis="y")
+    plt.tight_layout()
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_huge_pages{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plot_bars(df, "throughput_lookups_per_s", "Throughput (lookups/s)", "Huge Pages: contains Throughput", f"plot_huge_pages_throughput{suffix}.png")
+    # dTLB misses are -1 where no hardware counter is available
+    counted = df[df["dtlb_misses_per_lookup"] >= 0]
+    if not counted.empty:
+        plot_bars(counted, "dtlb_misses_per_lookup", "dTLB Load Misses per Lookup", "Huge Pages: dTLB Misses", f"plot_huge_pages_dtlb{suffix}.png")
+
+if __name__ == "__main__":
+    main()
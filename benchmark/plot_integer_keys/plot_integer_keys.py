@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+METRICS = [
+    ("build_ns_per_key", "Build, random order (ns/key)"),
+    ("sorted_build_ns_per_key", "Build, ascending (ns/key)"),
+    ("contains_ns", "Contains (ns)"),
+    ("lower_bound_ns", "Lower bound (ns)"),
+    ("range_ns_per_key", "Range scan (ns/key)"),
+    ("bytes_per_key", "Memory (bytes/key)"),
+]
+
+def plot_keys(df, keys, output_file):
+    """
+    One panel per metric, one bar per structure.
+    """
+    data = df[df["keys"] == keys].set_index("structure")
+    fig, axes = plt.subplots(2, 3, figsize=(15, 8))
+    for ax, (column, label) in zip(axes.flat, METRICS):
+        data[column].plot(kind="bar", ax=ax, logy=True)
+        ax.set_title(label)
+        ax.set_xlabel("")
+        ax.tick_params(axis="x", rotation=0)
+        ax.grid(True, axis="y")
+    fig.suptitle(f"Integer Keys: {keys}")
+    fig.tight_layout()
+    fig.savefig(output_file)
+    plt.close(fig)
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_integer_keys{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    for keys in df["keys"].unique():
+        plot_keys(df, keys, f"plot_integer_keys_{keys}{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_latency(csv_file, output_file, percentile, title):
+    """
+    Reads the CSV file and plots the given percentile column as grouped bars:
+    one group per (operation, outcome) pair and one bar per variant.
+    """
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    df["case"] = df["operation"] + "/" + df["outcome"]
+    cases = list(df["case"].unique())
+    variants = list(df["variant"].unique())
+    width = 0.8 / len(variants)
+
+    plt.figure(figsize=(10, 6))
+    for i, variant in enumerate(variants):
+        sub = df[df["variant"] == variant].set_index("case").reindex(cases)
+        positions = [c + i * width for c in range(len(cases))]
+        plt.bar(positions, sub[percentile], width=width, label=variant)
+    plt.xticks([c + 0.4 - width / 2 for c in range(len(cases))], cases)
+    plt.yscale("log")
+    plt.xlabel("Operation / Outcome")
+    plt.ylabel("Latency (ns)")
+    plt.title(title)
+    plt.legend()
+    plt.grid(True, axis="y")
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+
+    experiments = [
+        ("p50_ns", f"plot_latency_p50{suffix}.png", "Latency: p50"),
+        ("p99_ns", f"plot_latency_p99{suffix}.png", "Latency: p99"),
+        ("p999_ns", f"plot_latency_p999{suffix}.png", "Latency: p99.9"),
+    ]
+
+    for percentile, output_file, title in experiments:
+        plot_latency(f"plot_latency{suffix}.csv", output_file, percentile, title)
+
+if __name__ == "__main__":
+    main()
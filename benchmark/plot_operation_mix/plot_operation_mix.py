@@ -1,11 +1,12 @@
 #!/usr/bin/env python3
+import sys
 import matplotlib.pyplot as plt
 import pandas as pd
 
 
-def plot_operation_mix():
+def plot_operation_mix(suffix):
     # Read the CSV file generated by your benchmark
-    df = pd.read_csv("plot_operation_mix.csv")
+    df = pd.read_csv(f"plot_operation_mix{suffix}.csv")
 
     plt.figure(figsize=(10, 6))
 
@@ -21,14 +22,16 @@ def plot_operation_mix():
     plt.grid(True)
 
     # Save the plot as a PNG file
-    output_filename = "plot_operation_mix.png"
+    output_filename = f"plot_operation_mix{suffix}.png"
     plt.savefig(output_filename)
     plt.close()
     print(f"Plot saved as {output_filename}")
 
 
 def main():
-    plot_operation_mix()
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    plot_operation_mix(suffix)
 
 
 if __name__ == "__main__":
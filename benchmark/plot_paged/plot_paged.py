@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_metric(df, column, ylabel, title, output_file, log=False):
+    """
+    One line per operation over the size of the buffer pool relative to the file.
+    """
+    plt.figure(figsize=(10, 6))
+    for operation, group in df.groupby("operation"):
+        ratio = group["file_pages"] / group["pool_pages"]
+        plt.plot(ratio, group[column], marker="o", label=operation)
+    plt.xscale("log")
+    if log:
+        plt.yscale("log")
+    plt.xlabel("File Pages / Buffer Pool Pages")
+    plt.ylabel(ylabel)
+    plt.title(title)
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_paged{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plot_metric(df, "hit_rate", "Buffer Pool Hit Rate", "Paged Trie: Page-Cache Hit Rate", f"plot_paged_hit_rate{suffix}.png")
+    plot_metric(df, "p50_ns", "p50 Latency (ns)", "Paged Trie: Median Latency", f"plot_paged_p50{suffix}.png", log=True)
+    plot_metric(df, "p99_ns", "p99 Latency (ns)", "Paged Trie: p99 Latency", f"plot_paged_p99{suffix}.png", log=True)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_column(df, column, ylabel, title, output_file):
+    """
+    Plots one column vs. number of words for each variant.
+    """
+    plt.figure(figsize=(10, 6))
+    for variant in df["variant"].unique():
+        sub = df[df["variant"] == variant]
+        plt.plot(sub["num_words"], sub[column], marker="o", label=variant)
+    plt.yscale("log")
+    plt.xlabel("Number of Words")
+    plt.ylabel(ylabel)
+    plt.title(title)
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_persistence{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    df["total_bytes"] = df["live_size_bytes"] + df["snapshot_bytes"]
+    plot_column(df, "total_bytes", "Memory incl. 10 Snapshots (bytes)", "Persistence: Memory Overhead of Snapshots",
+                f"plot_persistence_memory{suffix}.png")
+    plot_column(df, "bytes_written_per_mutation", "Bytes Written per Mutation", "Persistence: Write Amplification",
+                f"plot_persistence_writes{suffix}.png")
+    plot_column(df, "mutation_time_ns", "Mutation Time incl. Snapshots (ns)", "Persistence: Mutation Time",
+                f"plot_persistence_time{suffix}.png")
+
+if __name__ == "__main__":
+    main()
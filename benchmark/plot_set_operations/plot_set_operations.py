@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_operation(df, operation, output_file):
+    """
+    Throughput of one set operation over the number of words, structural versus naive per variant.
+    """
+    sub = df[df["operation"] == operation]
+    plt.figure(figsize=(10, 6))
+    for (variant, method), group in sub.groupby(["variant", "method"]):
+        style = "-" if method == "structural" else "--"
+        plt.plot(group["num_words"], group["throughput_words_per_s"], style, marker="o", label=f"{variant} ({method})")
+    plt.xlabel("Number of Words per Trie")
+    plt.ylabel("Throughput (words/s)")
+    plt.title(f"Set Operations: {operation.capitalize()}")
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    csv_file = f"plot_set_operations{suffix}.csv"
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    for operation in df["operation"].unique():
+        plot_operation(df, operation, f"plot_set_operations_{operation}{suffix}.png")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+import sys
+import pandas as pd
+import matplotlib.pyplot as plt
+
+def plot_thread_scaling(csv_file, output_file, column, ylabel, title):
+    """
+    Reads the CSV file, plots the given column vs. threads for each
+    (variant, placement) pair, and saves the plot to output_file.
+    """
+    try:
+        df = pd.read_csv(csv_file)
+    except Exception as e:
+        print(f"Error reading {csv_file}: {e}")
+        return
+
+    plt.figure(figsize=(10, 6))
+    # Plot a line for each variant and thread placement (compact / scatter across numa nodes).
+    for (variant, placement), sub in df.groupby(["variant", "placement"], sort=False):
+        linestyle = "-" if placement == "compact" else "--"
+        plt.plot(sub["threads"], sub[column], marker="o", linestyle=linestyle, label=f"{variant} ({placement})")
+    plt.xlabel("Threads")
+    plt.ylabel(ylabel)
+    plt.title(title)
+    plt.legend()
+    plt.grid(True)
+    plt.savefig(output_file)
+    plt.close()
+    print(f"Plot saved as {output_file}")
+
+def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+
+    # Define the list of CSV files, output PNG filenames, and titles.
+    experiments = [
+        (f"plot_thread_scaling_contains{suffix}.csv", "Thread Scaling: Read-Only Contains"),
+        (f"plot_thread_scaling_mixed{suffix}.csv", "Thread Scaling: Mixed Read/Write"),
+        (f"plot_thread_scaling_batch{suffix}.csv", "Thread Scaling: Sharded Batches (50% Writes)"),
+    ]
+
+    for csv_file, title in experiments:
+        stem = csv_file[:-len(".csv")]
+        plot_thread_scaling(csv_file, f"{stem}_throughput.png", "throughput_ops_per_s", "Throughput (ops/s)", title)
+        plot_thread_scaling(csv_file, f"{stem}_speedup.png", "speedup", "Speedup over 1 Thread", title)
+
+if __name__ == "__main__":
+    main()
@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 import os
+import sys
 import pandas as pd
 import matplotlib.pyplot as plt
 
@@ -33,6 +34,9 @@ def plot_csv(csv_file, output_file, title):
     print(f"Plot saved as {output_file}")
 
 def main():
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+
     # List of CSV files produced by your benchmark function
     # and the corresponding titles for the plots.
     files = [
@@ -45,6 +49,7 @@ def main():
     ]
 
     for csv_file, title in files:
+        csv_file = csv_file.replace(".csv", f"{suffix}.csv")
         # Create an output PNG filename based on the CSV filename.
         output_file = os.path.splitext(csv_file)[0] + ".png"
         plot_csv(csv_file, output_file, title)
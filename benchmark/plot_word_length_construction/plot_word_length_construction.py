@@ -1,10 +1,11 @@
 #!/usr/bin/env python3
+import sys
 import pandas as pd
 import matplotlib.pyplot as plt
 
-def plot_construction_time():
+def plot_construction_time(suffix):
     # Read the CSV file that contains construction time data.
-    df = pd.read_csv("plot_word_length_construction_time.csv")
+    df = pd.read_csv(f"plot_word_length_construction_time{suffix}.csv")
 
     plt.figure(figsize=(10, 6))
     # Plot construction_time_ns vs. word_length for each variant.
@@ -16,13 +17,13 @@ def plot_construction_time():
     plt.title("Construction Time vs. Word Length")
     plt.legend()
     plt.grid(True)
-    plt.savefig("plot_word_length_construction_time.png")
+    plt.savefig(f"plot_word_length_construction_time{suffix}.png")
     plt.close()
-    print("Saved plot_word_length_construction_time.png")
+    print(f"Saved plot_word_length_construction_time{suffix}.png")
 
-def plot_construction_size():
+def plot_construction_size(suffix):
     # Read the CSV file that contains construction size data.
-    df = pd.read_csv("plot_word_length_construction_size.csv")
+    df = pd.read_csv(f"plot_word_length_construction_size{suffix}.csv")
 
     plt.figure(figsize=(10, 6))
     # Plot construction_size vs. word_length for each variant.
@@ -34,13 +35,15 @@ def plot_construction_size():
     plt.title("Construction Size vs. Word Length")
     plt.legend()
     plt.grid(True)
-    plt.savefig("plot_word_length_construction_size.png")
+    plt.savefig(f"plot_word_length_construction_size{suffix}.png")
     plt.close()
-    print("Saved plot_word_length_construction_size.png")
+    print(f"Saved plot_word_length_construction_size{suffix}.png")
 
 def main():
-    plot_construction_time()
-    plot_construction_size()
+    # Optional scenario name (see benchmark --scenarios)
+    suffix = f"_{sys.argv[1]}" if len(sys.argv) > 1 else ""
+    plot_construction_time(suffix)
+    plot_construction_size(suffix)
 
 if __name__ == "__main__":
     main()
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm> // for std::max, std::shuffle
+#include <cstdint>   // for std::uint32_t
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for std::size_t
+#include <fstream>   // for std::ofstream
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+struct CompactionResult
+{
+  std::size_t size_before;
+  std::size_t size_after;
+  long long contains_before; // in nanoseconds
+  long long contains_after;  // in nanoseconds
+  long long compaction_time; // in nanoseconds, all slices
+  long long max_slice_time;  // in nanoseconds
+};
+
+template<typename Trie>
+long long
+time_contains(const Trie& trie, const std::vector<std::string>& probes)
+{
+  bool accum = false;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& word : probes)
+    accum ^= trie.contains(word);
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(accum);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Builds the trie, runs the churn queries and measures contains before and after an incremental compaction.
+template<typename Trie>
+CompactionResult
+run_compaction(const Instance& churn, const std::vector<std::string>& probes, std::size_t slice_nodes)
+{
+  Trie trie;
+  for (const auto& word : churn.words)
+    trie.insert(word);
+  for (const auto& [op, word] : churn.queries)
+    op == 0 ? trie.insert(word) : trie.remove(word);
+
+  CompactionResult result{};
+  result.size_before = trie.size();
+  time_contains(trie, probes); // warm up
+  result.contains_before = time_contains(trie, probes);
+
+  for (bool done = false; !done;) {
+    const auto start = std::chrono::steady_clock::now();
+    done = trie.compact_step(slice_nodes);
+    const long long slice = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    result.compaction_time += slice;
+    result.max_slice_time = std::max(result.max_slice_time, slice);
+  }
+
+  result.size_after = trie.size();
+  time_contains(trie, probes);
+  result.contains_after = time_contains(trie, probes);
+  return result;
+}
+
+inline void
+plot_compaction()
+{
+  const auto num_words = 100'000;
+  const auto num_churn = 1'000'000;
+  const auto min_word_length = 4, max_word_length = 24;
+  const auto chance_random_query = 50;
+  const std::size_t slice_nodes = 4096;
+
+  // half inserts of new and existing words, half removes, so nodes are freed and reallocated all over the heap
+  Instance churn = create_instance(num_words, min_word_length, max_word_length, num_churn / 2, 0, num_churn / 2, chance_random_query);
+  auto probes = churn.words;
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(static_cast<std::uint32_t>(workload_config().seed)));
+
+  std::ofstream ofs(csv_path("plot_compaction"));
+  ofs << "variant,size_before,size_after,contains_before_ns,contains_after_ns,compaction_time_ns,max_slice_ns\n";
+  const auto write = [&ofs](const char* variant, const CompactionResult& r) {
+    ofs << variant << ',' << r.size_before << ',' << r.size_after << ',' << r.contains_before << ',' << r.contains_after << ',' << r.compaction_time << ','
+        << r.max_slice_time << '\n';
+  };
+  write("VectorTrie", run_compaction<VectorTrie>(churn, probes, slice_nodes));
+  write("ArrayTrie", run_compaction<ArrayTrie>(churn, probes, slice_nodes));
+  write("HashTrie", run_compaction<HashTrie>(churn, probes, slice_nodes));
+
+  std::cout << "Plot data for Compaction written to plot_compaction.csv\n";
+}
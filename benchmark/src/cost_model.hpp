@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>     // for std::min
+#include <chrono>        // for std::chrono::steady_clock
+#include <cstddef>       // for std::size_t
+#include <fstream>       // for std::ofstream
+#include <iostream>      // for std::cout
+#include <string>        // for std::string
+#include <unordered_set> // for std::unordered_set
+#include <vector>        // for std::vector
+
+#include <array_trie.hpp>
+#include <cost_model.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+// Measures the costs of Trie per node of the operation paths, the minimum of runs repetitions.
+// Every word is inserted, found and removed once, so every operation reaches length + 1 nodes.
+template<typename Trie>
+VariantCost
+measure_variant_cost(const std::vector<std::string>& words, int runs)
+{
+  std::size_t path_nodes = 0;
+  for (const auto& word : words)
+    path_nodes += word.size() + 1;
+  const auto per_node = [](long long time_ns, std::size_t nodes) { return static_cast<double>(time_ns) / static_cast<double>(nodes); };
+  const auto elapsed_ns = [](auto start) { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(); };
+
+  VariantCost best{ 1e18, 1e18, 1e18, 0.0 };
+  for (int run = 0; run < runs; ++run) {
+    Trie trie;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& word : words)
+      trie.insert(word);
+    const auto build_ns = elapsed_ns(start);
+
+    const auto stats = trie.stats();
+    const auto allocated = stats.nodes() - 1; // the root exists before the first insert
+
+    std::size_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& word : words)
+      if (trie.contains(word))
+        ++hits;
+    const auto contains_ns = elapsed_ns(start);
+    DoNotOptimize(hits);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& word : words)
+      trie.remove(word);
+    const auto remove_ns = elapsed_ns(start);
+
+    const auto visit = per_node(contains_ns, path_nodes);
+    best.visit_ns = std::min(best.visit_ns, visit);
+    best.alloc_ns = std::min(best.alloc_ns, (static_cast<double>(build_ns) - visit * static_cast<double>(path_nodes)) / static_cast<double>(allocated));
+    best.remove_ns = std::min(best.remove_ns, per_node(remove_ns, path_nodes));
+    best.node_bytes = static_cast<double>(stats.bytes()) / static_cast<double>(stats.nodes());
+  }
+  return best;
+}
+
+// Calibrates the CostModel of ti_programm -variant_value=auto for the configured key distribution
+// and writes it to cost_model.csv, the input of ti_programm -cost_model=<csv>
+inline void
+calibrate_cost_model()
+{
+  const auto num_words = 100'000, min_word_length = 4, max_word_length = 16;
+  const auto runs = 3;
+
+  // distinct words only, so the counted paths are the ones taken
+  const auto instance = create_instance(num_words, min_word_length, max_word_length, 0, 0, 0, 0);
+  std::vector<std::string> words;
+  std::unordered_set<std::string> seen;
+  for (const auto& word : instance.words)
+    if (seen.insert(word).second)
+      words.push_back(word);
+
+  CostModel model;
+  model.variants[0] = measure_variant_cost<VectorTrie>(words, runs);
+  model.variants[1] = measure_variant_cost<ArrayTrie>(words, runs);
+  model.variants[2] = measure_variant_cost<HashTrie>(words, runs);
+
+  std::ofstream ofs(csv_path("cost_model"));
+  CostModel::writeCsvHeader(ofs);
+  model.writeCsv(ofs);
+
+  CostModel::writeCsvHeader(std::cout);
+  model.writeCsv(std::cout);
+  std::cout << "Cost model for " << key_distribution_name(workload_config().keys) << " keys written to " << csv_path("cost_model") << "\n";
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>   // for std::chrono::steady_clock
+#include <cstddef>  // for std::size_t
+#include <fstream>  // for std::ofstream
+#include <iostream> // for std::cout
+#include <memory>   // for std::unique_ptr, std::make_unique
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <query_engine.hpp>
+#include <query_protocol.hpp>
+#include <trie_adapter.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+// The instance queries in batches of batch_size as read by ti_programm
+inline std::vector<QueryBatch>
+query_batches(const Instance& instance, std::size_t batch_size)
+{
+  std::vector<QueryBatch> batches;
+  for (const auto& [op, word] : instance.queries) {
+    if (batches.empty() || batches.back().size() == batch_size)
+      batches.emplace_back().reserve(batch_size);
+    batches.back().push_back({ word, op == 0 ? 'i' : op == 1 ? 'd' : 'c' });
+  }
+  return batches;
+}
+
+// The variant is chosen at run time like in ti_programm, so the calls stay virtual
+inline std::unique_ptr<TrieInterface>
+make_adapter(int variant)
+{
+  switch (variant) {
+    case 1:
+      return std::make_unique<TrieAdapter<VectorTrie>>();
+    case 2:
+      return std::make_unique<TrieAdapter<ArrayTrie>>();
+    default:
+      return std::make_unique<TrieAdapter<HashTrie>>();
+  }
+}
+
+// Executes and formats the batches with one virtual call and a switch per query, returns nanoseconds
+inline long long
+time_virtual_dispatch(const Instance& instance, const std::vector<QueryBatch>& batches, int variant)
+{
+  auto trie = make_adapter(variant);
+  for (const auto& word : instance.words)
+    (void)trie->insert(word);
+
+  std::size_t bytes = 0;
+  std::string results;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& batch : batches) {
+    results.clear();
+    for (const auto& [word, operation] : batch) {
+      bool result = false;
+      switch (operation) {
+        case 'c':
+          result = trie->contains(word);
+          break;
+        case 'i':
+          result = trie->insert(word);
+          break;
+        case 'd':
+          result = trie->remove(word);
+          break;
+        default:
+          break;
+      }
+      results += result ? "true\n" : "false\n";
+    }
+    bytes += results.size();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(bytes);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Executes and formats the batches through the QueryEngine of Trie, returns nanoseconds
+template<typename Trie>
+long long
+time_static_dispatch(const Instance& instance, const std::vector<QueryBatch>& batches)
+{
+  Trie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+
+  auto engine = QueryEngine(trie);
+  std::size_t bytes = 0;
+  std::string results;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& batch : batches) {
+    results.clear();
+    engine(batch, results);
+    bytes += results.size();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(bytes);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Query throughput of ti_programm's former per-query TrieInterface path against the QueryEngine,
+// for a contains-only workload (one run per batch) and a shuffled mix (runs of about two queries)
+inline void
+plot_dispatch()
+{
+  const auto num_words = 100'000, min_word_length = 4, max_word_length = 16;
+  const auto runs = 5;
+
+  std::ofstream ofs(csv_path("plot_dispatch"));
+  ofs << "workload,variant,dispatch,throughput_ops_per_s\n";
+  for (const auto mixed : { false, true }) {
+    const Instance instance = mixed ? create_instance(num_words, min_word_length, max_word_length, 300'000, 300'000, 300'000, 50)
+                                    : create_instance(num_words, min_word_length, max_word_length, 0, 900'000, 0, 50);
+    const auto batches = query_batches(instance, 4096);
+    const auto queries = static_cast<double>(instance.queries.size());
+    const auto write = [&](const char* variant, const char* dispatch, long long time_ns) {
+      ofs << (mixed ? "mixed" : "contains") << ',' << variant << ',' << dispatch << ',' << static_cast<long>(queries * 1e9 / static_cast<double>(time_ns)) << '\n';
+    };
+    const auto best = [&](auto&& measure) {
+      long long time_ns = measure();
+      for (int i = 1; i < runs; ++i) {
+        const auto t = measure();
+        time_ns = t < time_ns ? t : time_ns;
+      }
+      return time_ns;
+    };
+
+    write("VectorTrie", "virtual", best([&] { return time_virtual_dispatch(instance, batches, 1); }));
+    write("VectorTrie", "static", best([&] { return time_static_dispatch<VectorTrie>(instance, batches); }));
+    write("ArrayTrie", "virtual", best([&] { return time_virtual_dispatch(instance, batches, 2); }));
+    write("ArrayTrie", "static", best([&] { return time_static_dispatch<ArrayTrie>(instance, batches); }));
+    write("HashTrie", "virtual", best([&] { return time_virtual_dispatch(instance, batches, 3); }));
+    write("HashTrie", "static", best([&] { return time_static_dispatch<HashTrie>(instance, batches); }));
+  }
+
+  std::cout << "Plot data for Dispatch written to plot_dispatch.csv\n";
+}
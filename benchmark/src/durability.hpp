@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>           // for std::chrono::steady_clock
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for SIZE_MAX
+#include <filesystem>       // for std::filesystem::temp_directory_path, remove_all
+#include <fstream>          // for std::ofstream
+#include <initializer_list> // for std::initializer_list
+#include <iostream>         // for std::cout
+#include <string>           // for std::string
+
+#include <array_trie.hpp>
+#include <durable_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+inline std::filesystem::path
+durability_directory()
+{
+  return std::filesystem::temp_directory_path() / "trie_benchmark_durability";
+}
+
+// Insert throughput of a durable trie for one group commit size (records per fsync).
+template<typename Trie>
+double
+run_durable_insert(const Instance& instance, std::size_t group_commit)
+{
+  const auto directory = durability_directory();
+  std::filesystem::remove_all(directory);
+  double throughput = 0.0;
+  {
+    DurableTrie<Trie> trie(directory, group_commit, SIZE_MAX);
+    trie.open();
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& word : instance.words)
+      trie.insert(word);
+    trie.sync();
+    const auto end = std::chrono::steady_clock::now();
+    const auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    throughput = static_cast<double>(instance.words.size()) * 1e9 / static_cast<double>(time_ns);
+  }
+  std::filesystem::remove_all(directory);
+  return throughput;
+}
+
+// Applies the construction and all mutations of the instance, then measures the restart.
+// checkpoint_interval = SIZE_MAX replays the whole history from the log.
+template<typename Trie>
+long long
+run_durable_restart(const Instance& instance, std::size_t checkpoint_interval)
+{
+  const auto directory = durability_directory();
+  std::filesystem::remove_all(directory);
+  {
+    DurableTrie<Trie> trie(directory, 4096, checkpoint_interval);
+    trie.open();
+    for (const auto& word : instance.words)
+      trie.insert(word);
+    for (const auto& [op, word] : instance.queries) {
+      if (op == 0)
+        trie.insert(word);
+      else if (op == 1)
+        trie.remove(word);
+    }
+  }
+  const auto start = std::chrono::steady_clock::now();
+  long long time_ns = 0;
+  {
+    DurableTrie<Trie> trie(directory, 4096, checkpoint_interval);
+    trie.open();
+    time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    DoNotOptimize(trie.size());
+  }
+  std::filesystem::remove_all(directory);
+  return time_ns;
+}
+
+inline void
+plot_durability()
+{
+  const auto min_word_length = 4, max_word_length = 24;
+  std::ofstream ofs;
+
+  ofs = std::ofstream(csv_path("plot_durability_insert"));
+  ofs << "group_commit,variant,throughput_ops_per_s\n";
+  {
+    Instance instance = create_instance(20'000, min_word_length, max_word_length, 0, 0, 0, 0);
+    for (const std::size_t group_commit : std::initializer_list<std::size_t>{ 1, 4, 16, 64, 256, 1024, 4096 }) {
+      ofs << group_commit << ",VectorTrie," << static_cast<long>(run_durable_insert<VectorTrie>(instance, group_commit)) << "\n";
+      ofs << group_commit << ",ArrayTrie," << static_cast<long>(run_durable_insert<ArrayTrie>(instance, group_commit)) << "\n";
+      ofs << group_commit << ",HashTrie," << static_cast<long>(run_durable_insert<HashTrie>(instance, group_commit)) << "\n";
+    }
+  }
+
+  // restart after num_words inserts plus as many insert/remove mutations,
+  // once replaying the full log and once from the latest snapshot (taken every 10% of the mutations) plus the log tail
+  ofs = std::ofstream(csv_path("plot_durability_startup"));
+  ofs << "mutations,variant,strategy,startup_time_ns\n";
+  for (const auto num_words : { 50'000, 100'000, 200'000, 400'000 }) {
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, num_words / 2, 0, num_words / 2, 50);
+    const auto mutations = static_cast<std::size_t>(2 * num_words);
+    ofs << mutations << ",VectorTrie,full_replay," << run_durable_restart<VectorTrie>(instance, SIZE_MAX) << "\n";
+    ofs << mutations << ",VectorTrie,snapshot_tail," << run_durable_restart<VectorTrie>(instance, mutations / 10) << "\n";
+    ofs << mutations << ",ArrayTrie,full_replay," << run_durable_restart<ArrayTrie>(instance, SIZE_MAX) << "\n";
+    ofs << mutations << ",ArrayTrie,snapshot_tail," << run_durable_restart<ArrayTrie>(instance, mutations / 10) << "\n";
+    ofs << mutations << ",HashTrie,full_replay," << run_durable_restart<HashTrie>(instance, SIZE_MAX) << "\n";
+    ofs << mutations << ",HashTrie,snapshot_tail," << run_durable_restart<HashTrie>(instance, mutations / 10) << "\n";
+  }
+
+  std::cout << "Plot data for Durability written to plot_durability_insert.csv and plot_durability_startup.csv\n";
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm> // for std::sort, std::unique
+#include <chrono>    // for std::chrono::steady_clock
+#include <fstream>   // for std::ofstream
+#include <iostream>  // for std::cout
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include <array_trie.hpp>
+#include <dawg.hpp>
+#include <hash_trie.hpp>
+#include <membership_filter.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+inline double
+throughput(std::size_t operations, long long time_ns)
+{
+  return static_cast<double>(operations) * 1e9 / static_cast<double>(time_ns);
+}
+
+template<typename Dictionary>
+long long
+time_static_contains(const Dictionary& dictionary, const Instance& instance)
+{
+  bool accum = false;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& query : instance.queries)
+    accum ^= dictionary.contains(query.second);
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(accum);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+inline Dawg
+build_dawg(std::vector<std::string> words)
+{
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  auto builder = DawgBuilder{};
+  for (const auto& word : words)
+    builder.add(word);
+  return builder.finish();
+}
+
+// contains throughput for a growing share of absent words, each variant without and with its pre-filter
+inline void
+plot_filters()
+{
+  const auto num_words = 200'000;
+  const auto num_queries = 500'000;
+  const auto min_word_length = 4, max_word_length = 24;
+  const auto runs = 5;
+
+  std::ofstream ofs(csv_path("plot_filters"));
+  ofs << "miss_percent,variant,filter,throughput_ops_per_s\n";
+  for (const auto miss_percent : { 0, 25, 50, 75, 90, 100 }) {
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, num_queries, 0, miss_percent);
+    const auto queries = instance.queries.size();
+    const auto write = [&](const char* variant, const char* filter, long long time_ns) {
+      ofs << miss_percent << ',' << variant << ',' << filter << ',' << static_cast<long>(throughput(queries, time_ns)) << '\n';
+    };
+    write("VectorTrie", "none", run_benchmark_average<VectorTrie>(instance, "VectorTrie", runs).query_time);
+    write("VectorTrie", "bloom", run_benchmark_average<FilteredTrie<VectorTrie>>(instance, "VectorTrie", runs).query_time);
+    write("ArrayTrie", "none", run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", runs).query_time);
+    write("ArrayTrie", "bloom", run_benchmark_average<FilteredTrie<ArrayTrie>>(instance, "ArrayTrie", runs).query_time);
+    write("HashTrie", "none", run_benchmark_average<HashTrie>(instance, "HashTrie", runs).query_time);
+    write("HashTrie", "bloom", run_benchmark_average<FilteredTrie<HashTrie>>(instance, "HashTrie", runs).query_time);
+
+    const auto dawg = build_dawg(instance.words);
+    write("Dawg", "none", time_static_contains(dawg, instance));
+    const auto filtered_dawg = XorFilteredDictionary<Dawg>(build_dawg(instance.words));
+    write("Dawg", "xor", time_static_contains(filtered_dawg, instance));
+  }
+
+  std::cout << "Plot data for Filters written to plot_filters.csv\n";
+}
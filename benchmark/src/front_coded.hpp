@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm> // for std::sort, std::unique
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t
+#include <fstream>   // for std::ofstream
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937, std::uniform_int_distribution
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include <array_trie.hpp>
+#include <front_coded_dictionary.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "filters.hpp"      // for time_static_contains
+#include "integer_keys.hpp" // for nanoseconds_since
+#include "runner.hpp"
+#include "workload.hpp"
+
+struct FrontCodedResult
+{
+  double construction_ns = 0; // per input word
+  double contains_ns = 0;
+  double prefix_ns = 0; // per enumerated word, 0 if the variant cannot enumerate
+  double bytes = 0;     // per distinct word
+};
+
+inline FrontCodedDictionary
+build_front_coded(std::vector<std::string> words)
+{
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  auto builder = FrontCodedBuilder{};
+  for (const auto& word : words)
+    builder.add(word);
+  return builder.finish();
+}
+
+template<typename Dictionary>
+double
+static_contains_ns(const Dictionary& dictionary, const Instance& instance)
+{
+  return static_cast<double>(time_static_contains(dictionary, instance)) / static_cast<double>(instance.queries.size());
+}
+
+template<typename Trie>
+FrontCodedResult
+run_front_coded_trie(const std::vector<std::string>& words, const Instance& instance, std::size_t distinct)
+{
+  FrontCodedResult result;
+  Trie trie;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& word : words)
+    trie.insert(word);
+  result.construction_ns = nanoseconds_since(start) / static_cast<double>(words.size());
+  result.bytes = static_cast<double>(trie.size()) / static_cast<double>(distinct);
+  result.contains_ns = static_contains_ns(trie, instance);
+  return result;
+}
+
+// FrontCodedDictionary against the three tries on the words of --corpus (the ti_programm input
+// format) or 500,000 generated words: construction (sorting included), memory, contains on half
+// present and half random words, and enumeration of the words below three-character prefixes.
+inline void
+plot_front_coded()
+{
+  const auto num_words = 500'000, num_queries = 500'000, num_prefixes = 10'000;
+  const auto min_word_length = 4, max_word_length = 24;
+
+  const auto& config = workload_config();
+  auto instance = create_instance(num_words, min_word_length, max_word_length, 0, 0, 0, 0);
+  if (!config.corpus.empty()) {
+    instance.words.clear();
+    for (const auto& word : config.corpus)
+      instance.words.push_back(word + '$');
+  }
+  const auto& words = instance.words;
+
+  std::mt19937 rng(static_cast<std::uint32_t>(config.seed));
+  auto index = std::uniform_int_distribution<std::size_t>(0, words.size() - 1);
+  for (int i = 0; i < num_queries; ++i)
+    instance.queries.emplace_back(2, i % 2 ? words[index(rng)] : random_word(rng, min_word_length, max_word_length));
+
+  FrontCodedResult front_coded;
+  auto start = std::chrono::steady_clock::now();
+  const auto dictionary = build_front_coded(words);
+  front_coded.construction_ns = nanoseconds_since(start) / static_cast<double>(words.size());
+  const auto distinct = dictionary.word_count();
+  front_coded.bytes = static_cast<double>(dictionary.size()) / static_cast<double>(distinct);
+  front_coded.contains_ns = static_contains_ns(dictionary, instance);
+
+  std::vector<std::string> prefixes;
+  for (int i = 0; i < num_prefixes; ++i)
+    prefixes.push_back(words[index(rng)].substr(0, 3));
+  std::size_t enumerated = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto& prefix : prefixes)
+    dictionary.for_each_with_prefix(prefix, [&enumerated](const std::string&) { ++enumerated; });
+  front_coded.prefix_ns = nanoseconds_since(start) / static_cast<double>(enumerated ? enumerated : 1);
+
+  std::ofstream ofs(csv_path("plot_front_coded"));
+  ofs << "variant,construction_ns_per_word,contains_ns,prefix_ns_per_word,bytes_per_word\n";
+  const auto write = [&](const char* variant, const FrontCodedResult& r) {
+    ofs << variant << ',' << r.construction_ns << ',' << r.contains_ns << ',' << r.prefix_ns << ',' << r.bytes << '\n';
+  };
+  write("FrontCoded", front_coded);
+  write("VectorTrie", run_front_coded_trie<VectorTrie>(words, instance, distinct));
+  write("ArrayTrie", run_front_coded_trie<ArrayTrie>(words, instance, distinct));
+  write("HashTrie", run_front_coded_trie<HashTrie>(words, instance, distinct));
+
+  std::cout << "Plot data for Front Coding written to plot_front_coded.csv (" << distinct << " words, " << dictionary.num_blocks() << " blocks)\n";
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>   // for std::atomic
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+#include <fstream>  // for std::ifstream, std::ofstream
+#include <iostream> // for std::cout
+#include <string>   // for std::string, std::stoll
+#include <vector>   // for std::vector
+
+#if defined(__linux__)
+#include <linux/perf_event.h> // for perf_event_attr, PERF_COUNT_HW_CACHE_DTLB
+#include <sys/ioctl.h>        // for ioctl
+#include <sys/syscall.h>      // for SYS_perf_event_open
+#include <unistd.h>           // for syscall, read, close
+#endif
+
+#include <array_trie.hpp>
+#include <cpu_topology.hpp>
+#include <replicated_array_trie.hpp>
+
+#include "runner.hpp"
+#include "thread_scaling.hpp"
+#include "workload.hpp"
+
+// dTLB load misses of the calling thread in user space, counted with perf_event_open.
+// Unavailable (-1) outside Linux, without a PMU (many VMs) or with perf_event_paranoid > 2.
+class DtlbMissCounter
+{
+private:
+  int fd = -1;
+
+public:
+  DtlbMissCounter()
+  {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  DtlbMissCounter(const DtlbMissCounter&) = delete;
+  DtlbMissCounter& operator=(const DtlbMissCounter&) = delete;
+
+  ~DtlbMissCounter()
+  {
+#if defined(__linux__)
+    if (fd >= 0)
+      close(fd);
+#endif
+  }
+
+  void start()
+  {
+#if defined(__linux__)
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  long long stop()
+  {
+#if defined(__linux__)
+    std::uint64_t count = 0;
+    if (fd >= 0 && ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &count, sizeof(count)) == sizeof(count))
+      return static_cast<long long>(count);
+#endif
+    return -1;
+  }
+};
+
+// Transparent huge pages mapped by this process in MiB, -1 where unknown
+inline double
+anon_huge_pages_mb()
+{
+  auto smaps = std::ifstream{ "/proc/self/smaps_rollup" };
+  std::string key;
+  long long kb = 0;
+  while (smaps >> key) {
+    if (key == "AnonHugePages:") {
+      smaps >> kb;
+      return static_cast<double>(kb) / 1024.0;
+    }
+    smaps.ignore(1 << 10, '\n');
+  }
+  return -1.0;
+}
+
+struct LookupMeasurement
+{
+  double throughput;         // lookups per second
+  double misses_per_lookup;  // dTLB load misses, -1 if not counted
+};
+
+// Runs the contains queries split over `threads` threads pinned along cpus, each thread
+// querying lookup(t) for the structure it should read.
+template<typename Lookup>
+LookupMeasurement
+measure_lookups(const Instance& instance, std::size_t threads, const std::vector<int>& cpus, Lookup&& lookup)
+{
+  std::atomic<long long> misses{ 0 };
+  std::atomic<bool> counted{ true };
+  const auto& queries = instance.queries;
+  const auto time_ns = run_pinned_threads(threads, cpus, [&](std::size_t t) {
+    const auto& trie = lookup(t);
+    DtlbMissCounter counter;
+    std::size_t found = 0;
+    counter.start();
+    for (std::size_t i = t; i < queries.size(); i += threads)
+      found += trie.contains(queries[i].second);
+    const auto thread_misses = counter.stop();
+    DoNotOptimize(found);
+    if (thread_misses < 0)
+      counted = false;
+    misses += thread_misses;
+  });
+  const auto lookups = static_cast<double>(queries.size());
+  return { lookups * 1e9 / static_cast<double>(time_ns), counted ? static_cast<double>(misses.load()) / lookups : -1.0 };
+}
+
+// contains throughput and dTLB misses of the ArrayTrie against its flat read-only copy on
+// 4 KiB and on transparent huge pages, then with all threads reading one copy against reading
+// their NUMA node's replica. On a single-node machine both replica rows use one replica.
+inline void
+plot_huge_pages()
+{
+  const auto num_words = 200'000, min_word_length = 4, max_word_length = 16, num_queries = 2'000'000;
+  const Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, num_queries, 0, 50);
+  const auto& topology = CpuTopology::system();
+  const auto cpus = topology.cpu_order(true);
+  const auto max_threads = topology.cpu_count();
+
+  std::ofstream ofs(csv_path("plot_huge_pages"));
+  ofs << "layout,threads,replicas,throughput_lookups_per_s,dtlb_misses_per_lookup,memory_mb,huge_pages_mb\n";
+  const auto write = [&](const char* layout, std::size_t threads, std::size_t replicas, LookupMeasurement m, std::size_t bytes, double huge_mb) {
+    ofs << layout << ',' << threads << ',' << replicas << ',' << static_cast<long>(m.throughput) << ',' << m.misses_per_lookup << ','
+        << static_cast<double>(bytes) / 1048576.0 << ',' << huge_mb << '\n';
+  };
+
+  ArrayTrie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+  write("ArrayTrie", 1, 1, measure_lookups(instance, 1, cpus, [&](std::size_t) -> const ArrayTrie& { return trie; }), trie.size(), 0.0);
+
+  for (const bool huge : { false, true }) {
+    const auto before = anon_huge_pages_mb();
+    const FlatArrayTrie flat(trie, huge);
+    const auto huge_mb = before < 0 ? -1.0 : anon_huge_pages_mb() - before;
+    write(huge ? "FlatArrayTrie (2 MiB pages)" : "FlatArrayTrie (4 KiB pages)", 1, 1,
+          measure_lookups(instance, 1, cpus, [&](std::size_t) -> const FlatArrayTrie& { return flat; }), flat.size(), huge_mb);
+  }
+
+  for (const bool replicate : { false, true }) {
+    const ReplicatedArrayTrie replicated(trie, true, replicate);
+    write(replicate ? "ReplicatedArrayTrie (local replica)" : "ReplicatedArrayTrie (one copy)", max_threads, replicated.num_replicas(),
+          measure_lookups(instance, max_threads, cpus, [&](std::size_t) -> const FlatArrayTrie& { return replicated.local(); }), replicated.size(), -1.0);
+  }
+
+  std::cout << "Plot data for Huge Pages written to plot_huge_pages.csv\n";
+}
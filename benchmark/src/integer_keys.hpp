@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm> // for std::sort, std::unique, std::shuffle, std::lower_bound, std::upper_bound
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t, std::uint64_t
+#include <fstream>   // for std::ofstream
+#include <iostream>  // for std::cout
+#include <random>    // for std::mt19937_64, std::uniform_int_distribution
+#include <set>       // for std::set
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include <integer_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+// Keys and queries of one integer key distribution
+template<typename Key>
+struct IntegerInstance
+{
+  std::string name;
+  std::vector<Key> keys;    // distinct, in random order
+  std::vector<Key> sorted;  // the keys in ascending order
+  std::vector<Key> lookups; // half stored keys, half random keys from the key range
+  std::vector<Key> ranges;  // range starts, each range spans range_keys stored keys on average
+  Key range_span = 0;
+};
+
+struct IntegerResult
+{
+  double build_ns = 0;        // per key in random order
+  double sorted_build_ns = 0; // per key in ascending order
+  double contains_ns = 0;
+  double lower_bound_ns = 0;
+  double range_ns = 0; // per visited key
+  double bytes = 0;    // per key
+};
+
+template<typename Key>
+IntegerInstance<Key>
+integer_instance(const std::string& name, std::size_t num_keys, bool dense, std::size_t num_lookups, std::size_t num_ranges, std::size_t range_keys)
+{
+  std::mt19937_64 rng(workload_config().seed ^ num_keys ^ (dense ? 1 : 0));
+  IntegerInstance<Key> instance;
+  instance.name = name;
+
+  // dense: timestamps or ids ascending with small gaps, otherwise uniform over the key range
+  if (dense) {
+    auto gap = std::uniform_int_distribution<Key>(1, 64);
+    Key key = static_cast<Key>(1'700'000'000'000ULL);
+    for (std::size_t i = 0; i < num_keys; ++i)
+      instance.sorted.push_back(key += gap(rng));
+  } else {
+    auto any = std::uniform_int_distribution<Key>();
+    for (std::size_t i = 0; i < num_keys; ++i)
+      instance.sorted.push_back(any(rng));
+    std::sort(instance.sorted.begin(), instance.sorted.end());
+    instance.sorted.erase(std::unique(instance.sorted.begin(), instance.sorted.end()), instance.sorted.end());
+  }
+  instance.keys = instance.sorted;
+  std::shuffle(instance.keys.begin(), instance.keys.end(), rng);
+
+  const auto min = instance.sorted.front(), max = instance.sorted.back();
+  auto in_range = std::uniform_int_distribution<Key>(min, max);
+  auto index = std::uniform_int_distribution<std::size_t>(0, instance.keys.size() - 1);
+  for (std::size_t i = 0; i < num_lookups; ++i)
+    instance.lookups.push_back(i % 2 ? instance.keys[index(rng)] : in_range(rng));
+  instance.range_span = static_cast<Key>((max - min) / instance.sorted.size() * range_keys);
+  for (std::size_t i = 0; i < num_ranges; ++i)
+    instance.ranges.push_back(in_range(rng));
+  return instance;
+}
+
+inline double
+nanoseconds_since(std::chrono::steady_clock::time_point start)
+{
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Times the queries of instance on an ordered structure through the given operations
+template<typename Key, typename Contains, typename LowerBound, typename Range>
+void
+time_integer_queries(const IntegerInstance<Key>& instance, IntegerResult& result, Contains&& contains, LowerBound&& lower_bound, Range&& range)
+{
+  std::size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto key : instance.lookups)
+    if (contains(key))
+      ++hits;
+  result.contains_ns = nanoseconds_since(start) / static_cast<double>(instance.lookups.size());
+
+  Key sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto key : instance.lookups)
+    sum = static_cast<Key>(sum + lower_bound(key));
+  result.lower_bound_ns = nanoseconds_since(start) / static_cast<double>(instance.lookups.size());
+
+  std::size_t visited = 0;
+  start = std::chrono::steady_clock::now();
+  for (const auto low : instance.ranges)
+    visited += range(low, static_cast<Key>(low + instance.range_span), sum);
+  result.range_ns = nanoseconds_since(start) / static_cast<double>(visited ? visited : 1);
+  DoNotOptimize(hits);
+  DoNotOptimize(sum);
+}
+
+template<typename Key>
+IntegerResult
+run_integer_trie(const IntegerInstance<Key>& instance)
+{
+  IntegerResult result;
+  {
+    IntegerTrie<Key> trie;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto key : instance.keys)
+      trie.insert(key);
+    result.build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  }
+  IntegerTrie<Key> trie;
+  const auto start = std::chrono::steady_clock::now();
+  trie.insert_sorted(instance.sorted.begin(), instance.sorted.end());
+  result.sorted_build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  result.bytes = static_cast<double>(trie.size()) / static_cast<double>(trie.key_count());
+
+  time_integer_queries(
+    instance,
+    result,
+    [&](Key key) { return trie.contains(key); },
+    [&](Key key) {
+      Key found = 0;
+      return trie.lower_bound(key, found) ? found : Key{ 0 };
+    },
+    [&](Key low, Key high, Key& sum) {
+      std::size_t visited = 0;
+      trie.for_each_in_range(low, high, [&](Key key) {
+        sum = static_cast<Key>(sum + key);
+        ++visited;
+      });
+      return visited;
+    });
+  return result;
+}
+
+template<typename Key>
+IntegerResult
+run_std_set(const IntegerInstance<Key>& instance)
+{
+  IntegerResult result;
+  {
+    std::set<Key> set;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto key : instance.keys)
+      set.insert(key);
+    result.build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  }
+  std::set<Key> set;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto key : instance.sorted)
+    set.insert(set.end(), key);
+  result.sorted_build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  // red-black tree node (three pointers and the color) with the key, plus the allocator header
+  result.bytes = static_cast<double>((4 * sizeof(void*) + sizeof(Key) + 7) / 8 * 8 + sizeof(void*));
+
+  time_integer_queries(
+    instance,
+    result,
+    [&](Key key) { return set.contains(key); },
+    [&](Key key) {
+      const auto it = set.lower_bound(key);
+      return it != set.end() ? *it : Key{ 0 };
+    },
+    [&](Key low, Key high, Key& sum) {
+      std::size_t visited = 0;
+      for (auto it = set.lower_bound(low); it != set.end() && *it <= high; ++it) {
+        sum = static_cast<Key>(sum + *it);
+        ++visited;
+      }
+      return visited;
+    });
+  return result;
+}
+
+template<typename Key>
+IntegerResult
+run_sorted_vector(const IntegerInstance<Key>& instance)
+{
+  IntegerResult result;
+  {
+    // bulk build, point inserts into a sorted vector are linear each
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Key> vector(instance.keys);
+    std::sort(vector.begin(), vector.end());
+    result.build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const std::vector<Key> vector(instance.sorted);
+  result.sorted_build_ns = nanoseconds_since(start) / static_cast<double>(instance.keys.size());
+  result.bytes = sizeof(Key);
+
+  time_integer_queries(
+    instance,
+    result,
+    [&](Key key) { return std::binary_search(vector.begin(), vector.end(), key); },
+    [&](Key key) {
+      const auto it = std::lower_bound(vector.begin(), vector.end(), key);
+      return it != vector.end() ? *it : Key{ 0 };
+    },
+    [&](Key low, Key high, Key& sum) {
+      std::size_t visited = 0;
+      for (auto it = std::lower_bound(vector.begin(), vector.end(), low); it != vector.end() && *it <= high; ++it) {
+        sum = static_cast<Key>(sum + *it);
+        ++visited;
+      }
+      return visited;
+    });
+  return result;
+}
+
+// IntegerTrie against std::set and a sorted std::vector at 10M keys, for dense 64-bit timestamps
+// and uniform 32-bit ids
+inline void
+plot_integer_keys()
+{
+  const std::size_t num_keys = 10'000'000, num_lookups = 1'000'000, num_ranges = 10'000, range_keys = 100;
+
+  std::ofstream ofs(csv_path("plot_integer_keys"));
+  ofs << "keys,structure,build_ns_per_key,sorted_build_ns_per_key,contains_ns,lower_bound_ns,range_ns_per_key,bytes_per_key\n";
+  const auto write = [&](const std::string& keys, const char* structure, const IntegerResult& r) {
+    ofs << keys << ',' << structure << ',' << r.build_ns << ',' << r.sorted_build_ns << ',' << r.contains_ns << ',' << r.lower_bound_ns << ','
+        << r.range_ns << ',' << r.bytes << '\n';
+  };
+  const auto run_all = [&](const auto& instance) {
+    write(instance.name, "IntegerTrie", run_integer_trie(instance));
+    write(instance.name, "std::set", run_std_set(instance));
+    write(instance.name, "sorted_vector", run_sorted_vector(instance));
+  };
+
+  run_all(integer_instance<std::uint64_t>("dense_uint64", num_keys, true, num_lookups, num_ranges, range_keys));
+  run_all(integer_instance<std::uint32_t>("uniform_uint32", num_keys, false, num_lookups, num_ranges, range_keys));
+
+  std::cout << "Plot data for Integer Keys written to plot_integer_keys.csv\n";
+}
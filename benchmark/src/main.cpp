@@ -1,167 +1,34 @@
 #include <algorithm>
-#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <fstream>
 #include <iostream>
-#include <random>
 #include <string>
 #include <vector>
 
 #include <array_trie.hpp>
+#include <dawg.hpp>
 #include <hash_trie.hpp>
+#include <latency_histogram.hpp>
+#include <tail_trie.hpp>
 #include <vector_trie.hpp>
 
-#if defined(__GNUC__) || defined(__clang__)
-template<typename T>
-inline void
-DoNotOptimize(T const& value)
-{
-  asm volatile("" : : "r,m"(value) : "memory");
-}
-#else
-template<typename T>
-inline void
-DoNotOptimize(T const& value)
-{
-  volatile auto dummy = value;
-  (void)dummy;
-}
-#endif
-
-static std::string
-random_word(std::mt19937& rng, int min_word_length, int max_word_length)
-{
-  static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-  std::uniform_int_distribution length_dist(static_cast<std::size_t>(min_word_length), static_cast<std::size_t>(max_word_length));
-  std::uniform_int_distribution<> chars_dist(0, sizeof(chars) - 2);
-  const auto length = length_dist(rng);
-  std::string result;
-  result.reserve((length + 1));
-  for (std::size_t i = 0; i < length; ++i)
-    result.push_back(chars[chars_dist(rng)]);
-  result.push_back('$');
-  return result;
-}
-
-struct Instance
-{
-  int num_words;
-  int min_word_length;
-  int max_word_length;
-  int num_insert_queries;
-  int num_contains_queries;
-  int num_remove_queries;
-  int chance_random_query;
-  std::vector<std::string> words{};
-  std::vector<std::pair<int, std::string>> queries{};
-};
-
-Instance
-create_instance(int num_words,
-                int min_word_length,
-                int max_word_length,
-                int num_insert_queries,
-                int num_contains_queries,
-                int num_remove_queries,
-                int chance_random_query)
-{
-  std::random_device rd;
-  std::mt19937 rng(rd());
-
-  Instance instance{ num_words, min_word_length, max_word_length, num_insert_queries, num_contains_queries, num_remove_queries, chance_random_query };
-
-  instance.words.reserve(static_cast<std::size_t>(num_words));
-  for (int i = 0; i < num_words; ++i)
-    instance.words.push_back(random_word(rng, min_word_length, max_word_length));
-
-  std::uniform_int_distribution percent_dist(0, 99);
-  std::uniform_int_distribution<std::size_t> index_dist(0, static_cast<std::size_t>(num_words - 1));
-  instance.queries.reserve(static_cast<std::size_t>(num_insert_queries + num_remove_queries + num_contains_queries));
-
-  // Insert queries.
-  for (int i = 0; i < num_insert_queries; ++i) {
-    std::string word = (percent_dist(rng) < chance_random_query) ? random_word(rng, min_word_length, max_word_length) : instance.words[index_dist(rng)];
-    instance.queries.emplace_back(0, std::move(word));
-  }
-  // Remove queries.
-  for (int i = 0; i < num_remove_queries; ++i) {
-    std::string word = (percent_dist(rng) < chance_random_query) ? random_word(rng, min_word_length, max_word_length) : instance.words[index_dist(rng)];
-    instance.queries.emplace_back(1, std::move(word));
-  }
-  // Contains queries.
-  for (int i = 0; i < num_contains_queries; ++i) {
-    std::string word = (percent_dist(rng) < chance_random_query) ? random_word(rng, min_word_length, max_word_length) : instance.words[index_dist(rng)];
-    instance.queries.emplace_back(2, std::move(word));
-  }
-  std::shuffle(instance.queries.begin(), instance.queries.end(), rng);
-
-  return instance;
-}
-
-struct BenchmarkResult
-{
-  std::string variant;
-  long construction_time; // in nanoseconds
-  long query_time;        // in nanoseconds
-  std::size_t final_size;
-};
-
-template<typename Trie>
-BenchmarkResult
-run_benchmark_instance(const Instance& instance, const std::string& variant_name)
-{
-  Trie trie;
-
-  // --- Construction Phase ---
-  const auto start_construction = std::chrono::steady_clock::now();
-  for (const auto& word : instance.words)
-    trie.insert(word);
-  const auto end_construction = std::chrono::steady_clock::now();
-  const auto construction_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_construction - start_construction).count();
-  const auto final_size = trie.size();
-
-  // --- Query Phase ---
-  volatile int dummy_accum = 0;
-  const auto start_query = std::chrono::steady_clock::now();
-  for (const auto& [op, word] : instance.queries) {
-    switch (op) {
-      case 0:
-        dummy_accum ^= static_cast<int>(trie.insert(word));
-        break;
-      case 1:
-        dummy_accum ^= static_cast<int>(trie.remove(word));
-        break;
-      case 2:
-        dummy_accum ^= static_cast<int>(trie.contains(word));
-        break;
-      default:
-        break;
-    }
-  }
-  DoNotOptimize(dummy_accum);
-  const auto end_query = std::chrono::steady_clock::now();
-  const auto query_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_query - start_query).count();
-
-  return { variant_name, construction_time, query_time, final_size };
-}
-
-template<typename Trie>
-BenchmarkResult
-run_benchmark_average(const Instance& instance, const std::string& variant_name, int runs)
-{
-  long total_construction = 0;
-  long total_query = 0;
-  std::size_t total_size = 0;
-  for (int i = 0; i < runs; ++i) {
-    BenchmarkResult res = run_benchmark_instance<Trie>(instance, variant_name);
-    total_construction += res.construction_time;
-    total_query += res.query_time;
-    total_size += res.final_size;
-  }
-  return { variant_name,
-           total_construction / static_cast<decltype(total_construction)>(runs),
-           total_query / static_cast<decltype(total_query)>(runs),
-           total_size / static_cast<decltype(total_size)>(runs) };
-}
+#include "compaction.hpp"
+#include "cost_model.hpp"
+#include "dispatch.hpp"
+#include "durability.hpp"
+#include "filters.hpp"
+#include "front_coded.hpp"
+#include "huge_pages.hpp"
+#include "integer_keys.hpp"
+#include "paged.hpp"
+#include "persistence.hpp"
+#include "regression.hpp"
+#include "runner.hpp"
+#include "set_operations.hpp"
+#include "thread_scaling.hpp"
+#include "workload.hpp"
 
 void
 plot_fill_factor()
@@ -173,19 +40,21 @@ plot_fill_factor()
 
   std::ofstream ofs;
 
-  ofs = std::ofstream("plot_fill_factor_insert.csv");
+  ofs = std::ofstream(csv_path("plot_fill_factor_insert"));
   ofs << "num_words,variant,query_time_ns\n";
   for (const auto num_words : num_words_vec) {
     Instance instance = create_instance(num_words, min_word_length, max_word_length, 100000, 0, 0, chance_random_query);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", runs);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", runs);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", runs);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", runs);
     ofs << num_words << ",VectorTrie," << vec.query_time << "\n";
     ofs << num_words << ",ArrayTrie," << arr.query_time << "\n";
     ofs << num_words << ",HashTrie," << hash.query_time << "\n";
+    ofs << num_words << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_fill_factor_contains.csv");
+  ofs = std::ofstream(csv_path("plot_fill_factor_contains"));
   ofs << "num_words,variant,query_time_ns\n";
   for (const auto num_words : num_words_vec) {
     Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, 100000, 0, chance_random_query);
@@ -197,16 +66,18 @@ plot_fill_factor()
     ofs << num_words << ",HashTrie," << hash.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_fill_factor_remove.csv");
+  ofs = std::ofstream(csv_path("plot_fill_factor_remove"));
   ofs << "num_words,variant,query_time_ns\n";
   for (const auto num_words : num_words_vec) {
     Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, 0, 100000, chance_random_query);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", runs);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", runs);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", runs);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", runs);
     ofs << num_words << ",VectorTrie," << vec.query_time << "\n";
     ofs << num_words << ",ArrayTrie," << arr.query_time << "\n";
     ofs << num_words << ",HashTrie," << hash.query_time << "\n";
+    ofs << num_words << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
   std::cout << "Plot data for Fill Factor written to plot_fill_factor.csv\n";
@@ -217,100 +88,118 @@ plot_word_length()
 {
   std::ofstream ofs;
 
-  ofs = std::ofstream("plot_word_length_construction_time.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_construction_time"));
   ofs << "word_length,variant,construction_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(200'000, wl, wl, 0, 0, 0, 0);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult tail = run_benchmark_average<TailTrie>(instance, "TailTrie", 5);
     ofs << wl << ",VectorTrie," << vec.construction_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.construction_time << "\n";
     ofs << wl << ",HashTrie," << hash.construction_time << "\n";
+    ofs << wl << ",TailTrie," << tail.construction_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_construction_size.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_construction_size"));
   ofs << "word_length,variant,construction_size\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(200'000, wl, wl, 0, 0, 0, 0);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 1);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 1);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 1);
+    BenchmarkResult tail = run_benchmark_average<TailTrie>(instance, "TailTrie", 1);
     ofs << wl << ",VectorTrie," << vec.final_size << "\n";
     ofs << wl << ",ArrayTrie," << arr.final_size << "\n";
     ofs << wl << ",HashTrie," << hash.final_size << "\n";
+    ofs << wl << ",TailTrie," << tail.final_size << "\n";
+    ofs << wl << ",Dawg," << build_dawg(instance.words).size() << "\n";
+    ofs << wl << ",FrontCoded," << build_front_coded(instance.words).size() << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_insert_already_inserted.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_insert_already_inserted"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 100000, 0, 0, 0);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_insert_random.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_insert_random"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 100000, 0, 0, 100);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_contain_already_inserted.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_contain_already_inserted"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 0, 100000, 0, 0);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult tail = run_benchmark_average<TailTrie>(instance, "TailTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",TailTrie," << tail.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_contain_random.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_contain_random"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 0, 100000, 0, 100);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult tail = run_benchmark_average<TailTrie>(instance, "TailTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",TailTrie," << tail.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_remove_already_inserted.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_remove_already_inserted"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 0, 0, 100000, 0);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
-  ofs = std::ofstream("plot_word_length_remove_random.csv");
+  ofs = std::ofstream(csv_path("plot_word_length_remove_random"));
   ofs << "word_length,variant,query_time_ns\n";
   for (int wl = 4; wl <= 32; wl += 4) {
     Instance instance = create_instance(100000, wl, wl, 0, 0, 100000, 100);
     BenchmarkResult vec = run_benchmark_average<VectorTrie>(instance, "VectorTrie", 5);
     BenchmarkResult arr = run_benchmark_average<ArrayTrie>(instance, "ArrayTrie", 5);
     BenchmarkResult hash = run_benchmark_average<HashTrie>(instance, "HashTrie", 5);
+    BenchmarkResult counting = run_benchmark_average<CountingArrayTrie>(instance, "CountingArrayTrie", 5);
     ofs << wl << ",VectorTrie," << vec.query_time << "\n";
     ofs << wl << ",ArrayTrie," << arr.query_time << "\n";
     ofs << wl << ",HashTrie," << hash.query_time << "\n";
+    ofs << wl << ",CountingArrayTrie," << counting.query_time << "\n";
   }
 
   std::cout << "Plot data for Word Length written\n";
@@ -327,7 +216,7 @@ plot_operation_mix()
   const auto min_word_length = 4, max_word_length = 24;
   const auto runs = 5;
 
-  ofs = std::ofstream("plot_operation_mix.csv");
+  ofs = std::ofstream(csv_path("plot_operation_mix"));
   ofs << "lookup_ratio,variant,query_time_ns\n";
   for (int ratio = 0; ratio <= 100; ratio += 5) {
     const auto num_lookup = total_queries * ratio / 100;
@@ -345,14 +234,162 @@ plot_operation_mix()
   std::cout << "Plot data for Operation Mix written to plot_operation_mix.csv\n";
 }
 
-int
-main()
+void
+plot_latency()
 {
-  std::cout << "Starting Trie Variant Plot Experiments...\n";
+  const auto num_words = 200'000;
+  const auto num_queries_per_type = 100'000;
+  const auto chance_random_query = 50;
+  const auto min_word_length = 4, max_word_length = 24;
+  const auto runs = 5;
+
+  Instance instance =
+    create_instance(num_words, min_word_length, max_word_length, num_queries_per_type, num_queries_per_type, num_queries_per_type, chance_random_query);
 
+  std::ofstream ofs(csv_path("plot_latency"));
+  LatencyRecorder::writeCsvHeader(ofs, "variant");
+  run_latency_merged<VectorTrie>(instance, runs).writeCsv(ofs, "VectorTrie");
+  run_latency_merged<ArrayTrie>(instance, runs).writeCsv(ofs, "ArrayTrie");
+  run_latency_merged<HashTrie>(instance, runs).writeCsv(ofs, "HashTrie");
+
+  std::cout << "Plot data for Latency written to plot_latency.csv\n";
+}
+
+void
+run_all_plots()
+{
   plot_fill_factor();
   plot_word_length();
   plot_operation_mix();
+  plot_latency();
+}
+
+// Reruns every sweep once per key/popularity distribution, each scenario writing its own csv files.
+void
+run_scenario_matrix()
+{
+  auto& config = workload_config();
+  const auto corpus_loaded = !config.corpus.empty();
+
+  struct Scenario
+  {
+    const char* name;
+    KeyDistribution keys;
+    double zipf_exponent;
+  };
+  const Scenario scenarios[] = {
+    { "uniform", KeyDistribution::Uniform, 0.0 }, { "zipf", KeyDistribution::Uniform, 0.99 },  { "natural", KeyDistribution::Natural, 0.0 },
+    { "natural_zipf", KeyDistribution::Natural, 0.99 }, { "url", KeyDistribution::Url, 0.0 }, { "file", KeyDistribution::File, 0.0 },
+  };
+
+  for (const auto& scenario : scenarios) {
+    if (scenario.keys == KeyDistribution::File && !corpus_loaded)
+      continue;
+    config.keys = scenario.keys;
+    config.zipf_exponent = scenario.zipf_exponent;
+    config.scenario = scenario.name;
+    std::cout << "\nScenario " << scenario.name << "\n";
+    run_all_plots();
+  }
+}
+
+// Experiments selected by --mode instead of the plot sweeps
+struct Mode
+{
+  const char* name;
+  void (*run)();
+};
+
+const Mode modes[] = {
+  { "threads", plot_thread_scaling }, { "durability", plot_durability }, { "persistence", plot_persistence },
+  { "compaction", plot_compaction },  { "filters", plot_filters },         { "set_operations", plot_set_operations },
+  { "paged", plot_paged },           { "huge_pages", plot_huge_pages }, { "dispatch", plot_dispatch },
+  { "regression", run_regression }, { "cost_model", calibrate_cost_model }, { "integer_keys", plot_integer_keys },
+  { "front_coded", plot_front_coded },
+};
+
+[[noreturn]] void
+usage()
+{
+  std::cerr << "Usage: benchmark [--seed=<n>] [--keys=<uniform|natural|url|file>] [--corpus=<word_list>] [--zipf=<exponent>] [--scenarios] [--mode=<plots";
+  for (const auto& m : modes)
+    std::cerr << '|' << m.name;
+  std::cerr << ">]\n"
+               "                 [--baseline=<json>] [--record] [--threshold=<percent>] [--runs=<n>] [--warmup=<n>]"
+            << std::endl;
+  std::exit(1);
+}
+
+int
+main(int argc, char** argv)
+{
+  auto& config = workload_config();
+  auto scenario_matrix = false;
+  auto mode = std::string{ "plots" };
+  auto keys_given = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const auto arg = std::string{ argv[i] };
+    const auto eq = arg.find('=');
+    const auto name = arg.substr(0, eq);
+    const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+    if (name == "--seed" && !value.empty()) {
+      config.seed = std::stoull(value);
+    } else if (name == "--keys") {
+      keys_given = true;
+      if (value == "uniform")
+        config.keys = KeyDistribution::Uniform;
+      else if (value == "natural")
+        config.keys = KeyDistribution::Natural;
+      else if (value == "url")
+        config.keys = KeyDistribution::Url;
+      else if (value == "file")
+        config.keys = KeyDistribution::File;
+      else
+        usage();
+    } else if (name == "--corpus" && !value.empty()) {
+      if (!load_corpus(value, config.corpus)) {
+        std::cerr << "Error reading word list " << value << std::endl;
+        std::exit(1);
+      }
+    } else if (name == "--zipf" && !value.empty()) {
+      config.zipf_exponent = std::stod(value);
+    } else if (name == "--baseline" && !value.empty()) {
+      regression_config().baseline_path = value;
+    } else if (name == "--record" && value.empty()) {
+      regression_config().record = true;
+    } else if (name == "--threshold" && !value.empty()) {
+      regression_config().threshold_percent = std::stod(value);
+    } else if (name == "--runs" && !value.empty()) {
+      regression_config().runs = std::stoull(value);
+    } else if (name == "--warmup" && !value.empty()) {
+      regression_config().warmup_runs = std::stoull(value);
+    } else if (name == "--scenarios") {
+      scenario_matrix = true;
+    } else if (name == "--mode") {
+      mode = value;
+      if (mode != "plots" && std::none_of(std::begin(modes), std::end(modes), [&mode](const Mode& m) { return mode == m.name; }))
+        usage();
+    } else {
+      usage();
+    }
+  }
+  if (!config.corpus.empty() && !keys_given)
+    config.keys = KeyDistribution::File;
+  if (config.keys == KeyDistribution::File && config.corpus.empty()) {
+    std::cerr << "--keys=file requires --corpus=<word_list>" << std::endl;
+    std::exit(1);
+  }
+
+  std::cout << "Starting Trie Variant Plot Experiments (seed " << config.seed << ", keys " << key_distribution_name(config.keys) << ")...\n";
+
+  const auto selected = std::find_if(std::begin(modes), std::end(modes), [&mode](const Mode& m) { return mode == m.name; });
+  if (selected != std::end(modes))
+    selected->run();
+  else if (scenario_matrix)
+    run_scenario_matrix();
+  else
+    run_all_plots();
 
   std::cout << "\nAll plot data files have been written to the working directory.\n";
 
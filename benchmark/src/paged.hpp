@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint64_t
+#include <filesystem>       // for std::filesystem::temp_directory_path, remove
+#include <fstream>          // for std::ofstream
+#include <initializer_list> // for std::initializer_list
+#include <iostream>         // for std::cout, std::cerr
+#include <string>           // for std::string
+
+#include <latency_histogram.hpp>
+#include <paged_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+inline void
+write_paged_row(std::ofstream& ofs,
+                std::size_t pool_pages,
+                const PagedTrie& trie,
+                const char* operation,
+                const LatencyHistogram& latency,
+                const PageCacheStats& before)
+{
+  const auto& after = trie.cache_stats();
+  const auto hits = after.hits - before.hits, misses = after.misses - before.misses;
+  const auto ns = util::cycle_clock::ns_per_tick();
+  const auto to_ns = [ns](std::uint64_t ticks) { return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns + 0.5); };
+  const auto ops = static_cast<double>(latency.count());
+  ofs << pool_pages << ',' << trie.file_size() / PagedTrie::PageSize << ',' << operation << ','
+      << (hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 1.0) << ',' << static_cast<double>(misses) / ops << ','
+      << static_cast<double>(after.writes - before.writes) / ops << ',' << to_ns(latency.percentile(0.5)) << ',' << to_ns(latency.percentile(0.99)) << '\n';
+}
+
+// Page-cache hit rate and latency of the disk-backed PagedTrie for buffer pools from about
+// 1/100 to 1/2 of the file. Reads are served by the OS page cache, so a miss costs a pread
+// system call and a copy rather than a device access.
+inline void
+plot_paged()
+{
+  const auto num_words = 500'000, min_word_length = 4, max_word_length = 24;
+  const Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, 200'000, 100'000, 50);
+  const auto path = (std::filesystem::temp_directory_path() / "trie_benchmark_paged.pages").string();
+
+  std::ofstream ofs(csv_path("plot_paged"));
+  ofs << "pool_pages,file_pages,operation,hit_rate,reads_per_op,writes_per_op,p50_ns,p99_ns\n";
+  for (const std::size_t pool_pages : std::initializer_list<std::size_t>{ 32, 80, 320, 1600 }) {
+    std::filesystem::remove(path);
+    {
+      PagedTrie trie(path, pool_pages);
+      if (!trie.open()) {
+        std::cerr << "Error: could not open " << path << "\n";
+        return;
+      }
+
+      LatencyHistogram insert_latency, contains_latency, remove_latency;
+      auto before = trie.cache_stats();
+      for (const auto& word : instance.words) {
+        const auto start = util::cycle_clock::now();
+        DoNotOptimize(trie.insert(word));
+        insert_latency.record(util::cycle_clock::now() - start);
+      }
+      trie.flush();
+      write_paged_row(ofs, pool_pages, trie, "insert", insert_latency, before);
+
+      for (const int op : { 2, 1 }) {
+        auto& latency = op == 2 ? contains_latency : remove_latency;
+        before = trie.cache_stats();
+        for (const auto& [query_op, word] : instance.queries) {
+          if (query_op != op)
+            continue;
+          const auto start = util::cycle_clock::now();
+          DoNotOptimize(op == 2 ? trie.contains(word) : trie.remove(word));
+          latency.record(util::cycle_clock::now() - start);
+        }
+        trie.flush();
+        write_paged_row(ofs, pool_pages, trie, op == 2 ? "contains" : "remove", latency, before);
+      }
+    }
+    std::filesystem::remove(path);
+  }
+
+  std::cout << "Plot data for Paged Trie written to plot_paged.csv\n";
+}
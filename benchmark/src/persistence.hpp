@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>   // for std::chrono::steady_clock
+#include <cstddef>  // for std::size_t
+#include <fstream>  // for std::ofstream
+#include <iostream> // for std::cout
+#include <memory>   // for std::unique_ptr, std::make_unique
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include <array_trie.hpp>
+#include <persistent_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+struct PersistenceResult
+{
+  std::size_t live_size;     // bytes of the latest version
+  std::size_t snapshot_size; // additional bytes held by the retained snapshots
+  double bytes_per_mutation; // bytes written per insert/remove, snapshots included
+  long long mutation_time;   // in nanoseconds, snapshots included
+};
+
+template<typename Trie>
+bool
+apply_mutation(Trie& trie, int op, const std::string& word)
+{
+  return op == 0 ? trie.insert(word) : trie.remove(word);
+}
+
+// Point-in-time views of an ArrayTrie are full copies.
+inline PersistenceResult
+run_persistence_array(const Instance& instance, std::size_t snapshot_interval)
+{
+  ArrayTrie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+
+  // the copies are dropped right away to keep the benchmark within memory,
+  // snapshot_size is what retaining them would cost
+  std::size_t snapshot_size = 0;
+  bool accum = false;
+  std::size_t n = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& [op, word] : instance.queries) {
+    accum ^= apply_mutation(trie, op, word);
+    if (++n % snapshot_interval == 0) {
+      auto copy = std::make_unique<ArrayTrie>();
+      trie.for_each([&copy](const std::string& w) { copy->insert(w); });
+      snapshot_size += copy->size();
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(accum);
+
+  return { trie.size(),
+           snapshot_size,
+           static_cast<double>(snapshot_size) / static_cast<double>(n),
+           std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() };
+}
+
+// Point-in-time views of a PersistentTrie share all unchanged nodes, only the path copies cost memory.
+inline PersistenceResult
+run_persistence_persistent(const Instance& instance, std::size_t snapshot_interval)
+{
+  PersistentTrie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+
+  std::vector<PersistentTrie::Snapshot> snapshots;
+  const auto bytes_before = trie.bytes_written();
+  bool accum = false;
+  std::size_t n = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& [op, word] : instance.queries) {
+    accum ^= apply_mutation(trie, op, word);
+    if (++n % snapshot_interval == 0)
+      snapshots.push_back(trie.snapshot());
+  }
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(accum);
+
+  const auto live_size = trie.size();
+  snapshots.push_back(trie.snapshot());
+  return { live_size,
+           PersistentTrie::retained_size(snapshots) - live_size,
+           static_cast<double>(trie.bytes_written() - bytes_before) / static_cast<double>(n),
+           std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() };
+}
+
+inline void
+plot_persistence()
+{
+  const auto min_word_length = 4, max_word_length = 24;
+  const auto chance_random_query = 50;
+  const std::size_t snapshots = 10;
+
+  std::ofstream ofs(csv_path("plot_persistence"));
+  ofs << "num_words,variant,live_size_bytes,snapshot_bytes,bytes_written_per_mutation,mutation_time_ns\n";
+  for (const auto num_words : { 25'000, 50'000, 100'000, 200'000 }) {
+    // as many mutations as words, half inserts and half removes, with a snapshot after every 10%
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, num_words / 2, 0, num_words / 2, chance_random_query);
+    const auto interval = instance.queries.size() / snapshots;
+    const auto arr = run_persistence_array(instance, interval);
+    const auto per = run_persistence_persistent(instance, interval);
+    ofs << num_words << ",ArrayTrie," << arr.live_size << ',' << arr.snapshot_size << ',' << arr.bytes_per_mutation << ',' << arr.mutation_time << "\n";
+    ofs << num_words << ",PersistentTrie," << per.live_size << ',' << per.snapshot_size << ',' << per.bytes_per_mutation << ',' << per.mutation_time << "\n";
+  }
+
+  std::cout << "Plot data for Persistence written to plot_persistence.csv\n";
+}
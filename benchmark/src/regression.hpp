@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>   // for std::sort, std::nth_element, std::max_element, std::min
+#include <chrono>      // for std::chrono::steady_clock
+#include <cmath>       // for std::sqrt, std::erfc
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <cstdint>     // for std::uint64_t
+#include <cstdlib>     // for std::exit, std::strtod
+#include <fstream>     // for std::ifstream, std::ofstream
+#include <iostream>    // for std::cout, std::cerr
+#include <iterator>    // for std::size
+#include <random>      // for std::mt19937, std::uniform_int_distribution
+#include <sstream>     // for std::stringstream
+#include <string>      // for std::string, std::to_string
+#include <string_view> // for std::string_view
+#include <utility>     // for std::pair, std::move
+#include <vector>      // for std::vector
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+// Settings of --mode=regression, set once from the command line.
+struct RegressionConfig
+{
+  std::string baseline_path = "regression_baseline.json";
+  bool record = false;           // write the baseline instead of comparing against it
+  double threshold_percent = 5.0; // smaller significant slowdowns are not reported as regressions
+  std::size_t warmup_runs = 3;
+  std::size_t runs = 20;
+};
+
+inline RegressionConfig&
+regression_config()
+{
+  static RegressionConfig config;
+  return config;
+}
+
+// Minimal JSON reader for the baseline files: objects, arrays, strings without escapes other
+// than \" and \\, numbers, true, false and null.
+struct JsonValue
+{
+  enum Type
+  {
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  Type type = Null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string; // also the text of a number, exact where the double is not
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  [[nodiscard]] const JsonValue* find(std::string_view key) const
+  {
+    for (const auto& [name, value] : object)
+      if (name == key)
+        return &value;
+    return nullptr;
+  }
+};
+
+class JsonParser
+{
+private:
+  std::string_view text;
+  std::size_t pos = 0;
+
+  void skipSpace()
+  {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t'))
+      ++pos;
+  }
+
+  bool consume(char c)
+  {
+    skipSpace();
+    if (pos < text.size() && text[pos] == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+
+  bool parseString(std::string& out)
+  {
+    if (!consume('"'))
+      return false;
+    out.clear();
+    while (pos < text.size() && text[pos] != '"') {
+      if (text[pos] == '\\' && pos + 1 < text.size())
+        ++pos;
+      out.push_back(text[pos++]);
+    }
+    return pos++ < text.size();
+  }
+
+  bool parseLiteral(std::string_view literal)
+  {
+    if (text.substr(pos, literal.size()) != literal)
+      return false;
+    pos += literal.size();
+    return true;
+  }
+
+public:
+  explicit JsonParser(std::string_view text_)
+    : text(text_)
+  {
+  }
+
+  bool parse(JsonValue& value)
+  {
+    skipSpace();
+    if (pos >= text.size())
+      return false;
+    const char c = text[pos];
+    if (c == '{') {
+      value.type = JsonValue::Object;
+      ++pos;
+      if (consume('}'))
+        return true;
+      do {
+        std::string key;
+        JsonValue member;
+        if (!parseString(key) || !consume(':') || !parse(member))
+          return false;
+        value.object.emplace_back(std::move(key), std::move(member));
+      } while (consume(','));
+      return consume('}');
+    }
+    if (c == '[') {
+      value.type = JsonValue::Array;
+      ++pos;
+      if (consume(']'))
+        return true;
+      do {
+        if (!parse(value.array.emplace_back()))
+          return false;
+      } while (consume(','));
+      return consume(']');
+    }
+    if (c == '"') {
+      value.type = JsonValue::String;
+      return parseString(value.string);
+    }
+    if (parseLiteral("true") || parseLiteral("false")) {
+      value.type = JsonValue::Bool;
+      value.boolean = c == 't';
+      return true;
+    }
+    if (parseLiteral("null"))
+      return true;
+    const std::string number(text.substr(pos, 32));
+    char* end = nullptr;
+    value.type = JsonValue::Number;
+    value.number = std::strtod(number.c_str(), &end);
+    if (end == number.c_str())
+      return false;
+    const auto length = static_cast<std::size_t>(end - number.c_str());
+    value.string = number.substr(0, length);
+    pos += length;
+    return true;
+  }
+};
+
+inline double
+median(std::vector<double> values)
+{
+  if (values.empty())
+    return 0.0;
+  const auto mid = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+  std::nth_element(values.begin(), mid, values.end());
+  if (values.size() % 2)
+    return *mid;
+  return (*mid + *std::max_element(values.begin(), mid)) / 2.0;
+}
+
+// One-sided Mann-Whitney U test: probability of samples at least as much greater than baseline
+// if both came from the same distribution (normal approximation with tie and continuity correction).
+inline double
+mann_whitney_p_greater(const std::vector<double>& samples, const std::vector<double>& baseline)
+{
+  const auto n1 = static_cast<double>(samples.size()), n2 = static_cast<double>(baseline.size());
+  std::vector<std::pair<double, bool>> all; // value, from samples
+  for (const auto v : samples)
+    all.emplace_back(v, true);
+  for (const auto v : baseline)
+    all.emplace_back(v, false);
+  std::sort(all.begin(), all.end());
+
+  double rank_sum = 0.0, ties = 0.0;
+  for (std::size_t i = 0; i < all.size();) {
+    std::size_t j = i;
+    while (j < all.size() && all[j].first == all[i].first)
+      ++j;
+    const auto rank = static_cast<double>(i + j + 1) / 2.0; // average of the ranks i + 1 .. j
+    for (std::size_t k = i; k < j; ++k)
+      rank_sum += all[k].second ? rank : 0.0;
+    const auto t = static_cast<double>(j - i);
+    ties += t * t * t - t;
+    i = j;
+  }
+
+  const auto n = n1 + n2;
+  const auto u = rank_sum - n1 * (n1 + 1) / 2;
+  const auto sigma = std::sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))));
+  if (sigma == 0.0)
+    return 1.0;
+  const auto z = (u - n1 * n2 / 2.0 - 0.5) / sigma;
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+// 95% bootstrap interval of median(samples) / median(baseline) - 1
+inline std::pair<double, double>
+bootstrap_change_interval(const std::vector<double>& samples, const std::vector<double>& baseline, std::size_t resamples = 2000)
+{
+  std::mt19937 rng(1);
+  const auto resample = [&rng](const std::vector<double>& values) {
+    std::uniform_int_distribution<std::size_t> pick(0, values.size() - 1);
+    std::vector<double> drawn(values.size());
+    for (auto& v : drawn)
+      v = values[pick(rng)];
+    return median(std::move(drawn));
+  };
+  std::vector<double> changes(resamples);
+  for (auto& change : changes)
+    change = resample(samples) / resample(baseline) - 1.0;
+  std::sort(changes.begin(), changes.end());
+  return { changes[resamples * 25 / 1000], changes[resamples * 975 / 1000] };
+}
+
+// Time of a fixed chain of dependent integer operations. Its spread over the run shows whether
+// the CPU clock stayed put (turbo, thermal throttling, power saving).
+inline double
+calibration_ns()
+{
+  std::uint64_t x = 88172645463325252ull;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 20'000'000; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+  }
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(x);
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Scaling governor of cpu0, empty where cpufreq is not exposed
+inline std::string
+scaling_governor()
+{
+  auto stream = std::ifstream{ "/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor" };
+  std::string governor;
+  stream >> governor;
+  return governor;
+}
+
+struct RegressionCase
+{
+  const char* name;
+  int variant; // 1 VectorTrie, 2 ArrayTrie, 3 HashTrie
+  int num_insert_queries;
+  int num_contains_queries;
+  int num_remove_queries;
+};
+
+// Nanoseconds per query of one run of the case
+inline double
+run_regression_case(const RegressionCase& c, const Instance& instance)
+{
+  const auto query_ns = [&] {
+    switch (c.variant) {
+      case 1:
+        return run_benchmark_instance<VectorTrie>(instance, c.name).query_time;
+      case 2:
+        return run_benchmark_instance<ArrayTrie>(instance, c.name).query_time;
+      default:
+        return run_benchmark_instance<HashTrie>(instance, c.name).query_time;
+    }
+  }();
+  return static_cast<double>(query_ns) / static_cast<double>(instance.queries.size());
+}
+
+// Runs a fixed set of seeded cases round-robin, warmup_runs times discarded and then runs times
+// measured, with a calibration loop after every round. With --record (or without a baseline file)
+// the samples are written as the JSON baseline; otherwise every case is compared against its
+// baseline samples and the process exits with 1 if any case got significantly slower:
+// Mann-Whitney p < 0.01 and a median slowdown above the threshold. If the calibration of this run
+// or of the baseline found the clock unstable, such cases are reported as unreliable instead.
+inline void
+run_regression()
+{
+  const auto& settings = regression_config();
+  if (settings.runs < 2) {
+    std::cerr << "--mode=regression needs --runs=<n> of at least 2" << std::endl;
+    std::exit(1);
+  }
+  auto& config = workload_config();
+  config.keys = KeyDistribution::Uniform;
+  config.zipf_exponent = 0.0;
+
+  const RegressionCase cases[] = {
+    { "VectorTrie/insert", 1, 100'000, 0, 0 }, { "VectorTrie/contains", 1, 0, 100'000, 0 }, { "VectorTrie/mixed", 1, 35'000, 35'000, 35'000 },
+    { "ArrayTrie/insert", 2, 100'000, 0, 0 },  { "ArrayTrie/contains", 2, 0, 100'000, 0 },  { "ArrayTrie/mixed", 2, 35'000, 35'000, 35'000 },
+    { "HashTrie/insert", 3, 100'000, 0, 0 },   { "HashTrie/contains", 3, 0, 100'000, 0 },   { "HashTrie/mixed", 3, 35'000, 35'000, 35'000 },
+  };
+  constexpr std::size_t NumCases = std::size(cases);
+  const auto num_words = 20'000, min_word_length = 4, max_word_length = 24, chance_random_query = 50;
+
+  std::vector<Instance> instances;
+  for (const auto& c : cases)
+    instances.push_back(create_instance(num_words, min_word_length, max_word_length, c.num_insert_queries, c.num_contains_queries, c.num_remove_queries,
+                                        chance_random_query));
+
+  const auto governor = scaling_governor();
+  if (!governor.empty() && governor != "performance")
+    std::cerr << "Warning: CPU governor is " << governor << ", not performance (see benchmark.sh)\n";
+
+  std::vector<std::vector<double>> samples(NumCases);
+  std::vector<double> calibration;
+  for (std::size_t round = 0; round < settings.warmup_runs + settings.runs; ++round) {
+    for (std::size_t i = 0; i < NumCases; ++i) {
+      const auto ns = run_regression_case(cases[i], instances[i]);
+      if (round >= settings.warmup_runs)
+        samples[i].push_back(ns);
+    }
+    if (round >= settings.warmup_runs)
+      calibration.push_back(calibration_ns());
+  }
+
+  // coefficient of variation of the calibration loop
+  double mean = 0.0, variance = 0.0;
+  for (const auto t : calibration)
+    mean += t / static_cast<double>(calibration.size());
+  for (const auto t : calibration)
+    variance += (t - mean) * (t - mean) / static_cast<double>(calibration.size());
+  const auto calibration_cv = mean > 0.0 ? std::sqrt(variance) / mean : 0.0;
+  const auto stable = calibration_cv < 0.03;
+  std::cout << "Calibration: median " << median(calibration) / 1e6 << " ms, variation " << calibration_cv * 100.0 << "%"
+            << (stable ? "" : " (unstable CPU frequency, results are unreliable)") << "\n";
+
+  auto baseline_stream = std::ifstream{ settings.baseline_path };
+  if (settings.record || !baseline_stream) {
+    std::ofstream ofs(settings.baseline_path);
+    ofs << "{\n  \"seed\": " << config.seed << ",\n  \"warmup_runs\": " << settings.warmup_runs << ",\n  \"runs\": " << settings.runs
+        << ",\n  \"calibration_ns\": " << median(calibration) << ",\n  \"frequency_stable\": " << (stable ? "true" : "false") << ",\n  \"cases\": [\n";
+    for (std::size_t i = 0; i < NumCases; ++i) {
+      ofs << "    { \"name\": \"" << cases[i].name << "\", \"ns_per_query\": [";
+      for (std::size_t k = 0; k < samples[i].size(); ++k)
+        ofs << (k ? ", " : "") << samples[i][k];
+      ofs << "] }" << (i + 1 < NumCases ? "," : "") << "\n";
+    }
+    ofs << "  ]\n}\n";
+    if (!ofs) {
+      std::cerr << "Error writing " << settings.baseline_path << std::endl;
+      std::exit(1);
+    }
+    std::cout << "Regression baseline written to " << settings.baseline_path << "\n";
+    return;
+  }
+
+  std::stringstream text;
+  text << baseline_stream.rdbuf();
+  const auto content = text.str();
+  JsonValue baseline;
+  const JsonValue* baseline_cases = nullptr;
+  if (!JsonParser(content).parse(baseline) || !(baseline_cases = baseline.find("cases")) || baseline_cases->type != JsonValue::Array) {
+    std::cerr << "Error reading " << settings.baseline_path << std::endl;
+    std::exit(1);
+  }
+  // compared as text, a double cannot hold every 64-bit seed
+  if (const auto* seed = baseline.find("seed"); !seed || seed->type != JsonValue::Number || seed->string != std::to_string(config.seed)) {
+    std::cerr << "Error: " << settings.baseline_path << " was recorded with another --seed" << std::endl;
+    std::exit(1);
+  }
+  auto reliable = stable;
+  if (const auto* was_stable = baseline.find("frequency_stable"); was_stable && !was_stable->boolean) {
+    std::cerr << "Warning: the baseline was recorded with an unstable CPU frequency\n";
+    reliable = false;
+  }
+
+  std::size_t regressions = 0, unreliable = 0;
+  for (std::size_t i = 0; i < NumCases; ++i) {
+    std::vector<double> reference;
+    for (const auto& entry : baseline_cases->array)
+      if (const auto* name = entry.find("name"); name && name->string == cases[i].name)
+        if (const auto* values = entry.find("ns_per_query"))
+          for (const auto& v : values->array)
+            reference.push_back(v.number);
+    if (reference.size() < 2) {
+      std::cout << "REGRESSION case=" << cases[i].name << " verdict=new\n";
+      continue;
+    }
+    const auto change = median(samples[i]) / median(reference) - 1.0;
+    const auto [low, high] = bootstrap_change_interval(samples[i], reference);
+    const auto p_slower = mann_whitney_p_greater(samples[i], reference);
+    const auto p_faster = mann_whitney_p_greater(reference, samples[i]);
+    const auto threshold = settings.threshold_percent / 100.0;
+    const char* verdict = "unchanged";
+    if (p_slower < 0.01 && change > threshold) {
+      verdict = reliable ? "regression" : "unreliable";
+      ++(reliable ? regressions : unreliable);
+    } else if (p_faster < 0.01 && change < -threshold) {
+      verdict = reliable ? "improvement" : "unreliable";
+    }
+    std::cout << "REGRESSION case=" << cases[i].name << " baseline_ns=" << median(reference) << " current_ns=" << median(samples[i])
+              << " change=" << change * 100.0 << "% ci95=[" << low * 100.0 << "%," << high * 100.0 << "%] p=" << std::min(p_slower, p_faster)
+              << " verdict=" << verdict << "\n";
+  }
+  std::cout << regressions << " regression(s) against " << settings.baseline_path;
+  if (unreliable)
+    std::cout << ", " << unreliable << " slowdown(s) not counted because the CPU frequency was unstable";
+  std::cout << std::endl;
+  if (regressions)
+    std::exit(1);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>  // for std::chrono::steady_clock
+#include <cstddef> // for std::size_t
+#include <string>  // for std::string
+
+#include <latency_histogram.hpp>
+
+#include "workload.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+template<typename T>
+inline void
+DoNotOptimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+#else
+template<typename T>
+inline void
+DoNotOptimize(T const& value)
+{
+  volatile auto dummy = value;
+  (void)dummy;
+}
+#endif
+
+struct BenchmarkResult
+{
+  std::string variant;
+  long construction_time; // in nanoseconds
+  long query_time;        // in nanoseconds
+  std::size_t final_size;
+};
+
+template<typename Trie>
+BenchmarkResult
+run_benchmark_instance(const Instance& instance, const std::string& variant_name)
+{
+  Trie trie;
+
+  // --- Construction Phase ---
+  const auto start_construction = std::chrono::steady_clock::now();
+  for (const auto& word : instance.words)
+    trie.insert(word);
+  const auto end_construction = std::chrono::steady_clock::now();
+  const auto construction_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_construction - start_construction).count();
+  const auto final_size = trie.size();
+
+  // --- Query Phase ---
+  volatile int dummy_accum = 0;
+  const auto start_query = std::chrono::steady_clock::now();
+  for (const auto& [op, word] : instance.queries) {
+    switch (op) {
+      case 0:
+        dummy_accum ^= static_cast<int>(trie.insert(word));
+        break;
+      case 1:
+        dummy_accum ^= static_cast<int>(trie.remove(word));
+        break;
+      case 2:
+        dummy_accum ^= static_cast<int>(trie.contains(word));
+        break;
+      default:
+        break;
+    }
+  }
+  DoNotOptimize(dummy_accum);
+  const auto end_query = std::chrono::steady_clock::now();
+  const auto query_time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_query - start_query).count();
+
+  return { variant_name, construction_time, query_time, final_size };
+}
+
+template<typename Trie>
+BenchmarkResult
+run_benchmark_average(const Instance& instance, const std::string& variant_name, int runs)
+{
+  long total_construction = 0;
+  long total_query = 0;
+  std::size_t total_size = 0;
+  for (int i = 0; i < runs; ++i) {
+    BenchmarkResult res = run_benchmark_instance<Trie>(instance, variant_name);
+    total_construction += res.construction_time;
+    total_query += res.query_time;
+    total_size += res.final_size;
+  }
+  return { variant_name,
+           total_construction / static_cast<decltype(total_construction)>(runs),
+           total_query / static_cast<decltype(total_query)>(runs),
+           total_size / static_cast<decltype(total_size)>(runs) };
+}
+
+template<typename Trie>
+LatencyRecorder
+run_latency_instance(const Instance& instance)
+{
+  Trie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+
+  LatencyRecorder recorder;
+  for (const auto& [op, word] : instance.queries) {
+    bool result = false;
+    // remove does not report presence, it is looked up outside the timed region
+    const bool present = op == 1 && trie.contains(word);
+    const auto start = util::cycle_clock::now();
+    switch (op) {
+      case 0:
+        result = trie.insert(word);
+        break;
+      case 1:
+        result = trie.remove(word);
+        break;
+      case 2:
+        result = trie.contains(word);
+        break;
+      default:
+        break;
+    }
+    const auto end = util::cycle_clock::now();
+    DoNotOptimize(result);
+    // benchmark op codes are (insert, remove, contains), the recorder uses (insert, contains, remove)
+    const auto operation = op == 0 ? LatencyRecorder::Insert : op == 1 ? LatencyRecorder::Remove : LatencyRecorder::Contains;
+    recorder.record(operation, op == 0 ? !result : op == 1 ? present : result, end - start);
+  }
+  return recorder;
+}
+
+template<typename Trie>
+LatencyRecorder
+run_latency_merged(const Instance& instance, int runs)
+{
+  LatencyRecorder recorder;
+  for (int i = 0; i < runs; ++i)
+    recorder.merge(run_latency_instance<Trie>(instance));
+  return recorder;
+}
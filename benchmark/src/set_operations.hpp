@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>   // for std::chrono::steady_clock
+#include <fstream>  // for std::ofstream
+#include <iostream> // for std::cout
+#include <string>   // for std::string
+#include <utility>  // for std::move
+#include <vector>   // for std::vector
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "runner.hpp"
+#include "workload.hpp"
+
+struct SetOperationTimes
+{
+  long long structural; // in nanoseconds
+  long long naive;      // in nanoseconds, re-inserting or removing word by word
+};
+
+template<typename Trie>
+void
+fill_trie(Trie& trie, const std::vector<std::string>& words)
+{
+  for (const auto& word : words)
+    trie.insert(word);
+}
+
+template<typename Trie, typename Operation>
+long long
+time_set_operation(const std::vector<std::string>& a, const std::vector<std::string>& b, Operation&& operation)
+{
+  Trie trie_a, trie_b;
+  fill_trie(trie_a, a);
+  fill_trie(trie_b, b);
+  const auto start = std::chrono::steady_clock::now();
+  operation(trie_a, trie_b);
+  const auto end = std::chrono::steady_clock::now();
+  DoNotOptimize(trie_a);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// operation 0: union, 1: intersection, 2: difference
+template<typename Trie>
+SetOperationTimes
+run_set_operation(const std::vector<std::string>& a, const std::vector<std::string>& b, int operation)
+{
+  switch (operation) {
+    case 0:
+      return { time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) { x.unite(std::move(y)); }),
+               time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) { y.for_each([&x](const std::string& w) { x.insert(w); }); }) };
+    case 1:
+      return { time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) { x.intersect(y); }),
+               time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) {
+                 Trie result;
+                 x.for_each([&](const std::string& w) {
+                   if (y.contains(w))
+                     result.insert(w);
+                 });
+                 x = std::move(result);
+               }) };
+    default:
+      return { time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) { x.subtract(y); }),
+               time_set_operation<Trie>(a, b, [](Trie& x, Trie& y) { y.for_each([&x](const std::string& w) { x.remove(w); }); }) };
+  }
+}
+
+// structural set operations versus word-by-word re-insertion, both sets half shared
+inline void
+plot_set_operations()
+{
+  const auto min_word_length = 4, max_word_length = 24;
+  const char* operations[] = { "union", "intersection", "difference" };
+
+  std::ofstream ofs(csv_path("plot_set_operations"));
+  ofs << "num_words,variant,operation,method,throughput_words_per_s\n";
+  for (const auto num_words : { 25'000, 50'000, 100'000 }) {
+    // the insert queries draw half of their words from the instance words
+    const Instance instance = create_instance(num_words, min_word_length, max_word_length, num_words, 0, 0, 50);
+    std::vector<std::string> other;
+    for (const auto& query : instance.queries)
+      other.push_back(query.second);
+    const auto words = static_cast<double>(instance.words.size() + other.size());
+
+    for (int operation = 0; operation < 3; ++operation) {
+      const auto write = [&](const char* variant, SetOperationTimes times) {
+        ofs << num_words << ',' << variant << ',' << operations[operation] << ",structural," << static_cast<long>(words * 1e9 / static_cast<double>(times.structural))
+            << '\n';
+        ofs << num_words << ',' << variant << ',' << operations[operation] << ",naive," << static_cast<long>(words * 1e9 / static_cast<double>(times.naive)) << '\n';
+      };
+      write("VectorTrie", run_set_operation<VectorTrie>(instance.words, other, operation));
+      write("ArrayTrie", run_set_operation<ArrayTrie>(instance.words, other, operation));
+      write("HashTrie", run_set_operation<HashTrie>(instance.words, other, operation));
+    }
+  }
+
+  std::cout << "Plot data for Set Operations written to plot_set_operations.csv\n";
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>       // for std::atomic
+#include <chrono>       // for std::chrono::steady_clock
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t
+#include <fstream>      // for std::ofstream
+#include <iostream>     // for std::cout
+#include <mutex>        // for std::unique_lock
+#include <shared_mutex> // for std::shared_mutex, std::shared_lock
+#include <string>       // for std::string
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
+#include <array_trie.hpp>
+#include <cpu_topology.hpp>
+#include <hash_trie.hpp>
+#include <persistent_trie.hpp>
+#include <query_protocol.hpp>
+#include <sharded_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "dispatch.hpp"
+#include "runner.hpp"
+#include "workload.hpp"
+
+// Runs body(thread_index) on `threads` threads pinned along `cpus` and returns the wall time in nanoseconds.
+// All threads start together once every thread is pinned and ready.
+template<typename Body>
+auto
+run_pinned_threads(std::size_t threads, const std::vector<int>& cpus, Body&& body)
+{
+  std::atomic<std::size_t> ready{ 0 };
+  std::atomic<bool> go{ false };
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      if (!cpus.empty())
+        pin_current_thread(cpus[t % cpus.size()]);
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {
+      }
+      body(t);
+    });
+  }
+  while (ready.load() != threads) {
+  }
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& worker : workers)
+    worker.join();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Makes any variant safe for concurrent use with a reader-writer lock.
+// Serves as the thread-safe baseline for the mixed read/write scenario.
+template<typename Trie>
+class SharedMutexTrie
+{
+private:
+  Trie trie;
+  mutable std::shared_mutex mutex;
+
+public:
+  bool insert(const std::string& word)
+  {
+    std::unique_lock lock(mutex);
+    return trie.insert(word);
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    std::shared_lock lock(mutex);
+    return trie.contains(word);
+  }
+
+  bool remove(const std::string& word)
+  {
+    std::unique_lock lock(mutex);
+    return trie.remove(word);
+  }
+
+  [[nodiscard]] std::size_t size() const
+  {
+    std::shared_lock lock(mutex);
+    return trie.size();
+  }
+};
+
+inline std::vector<std::size_t>
+thread_counts(std::size_t max_threads)
+{
+  std::vector<std::size_t> counts;
+  for (std::size_t t = 1; t < max_threads; t *= 2)
+    counts.push_back(t);
+  counts.push_back(max_threads);
+  return counts;
+}
+
+// Every thread runs ops_per_thread operations of the instance, each starting at its own offset.
+// Read-only runs only issue contains, mixed runs execute the instance operations as generated.
+template<typename Trie>
+void
+run_thread_scaling(std::ofstream& ofs, const Instance& instance, const std::string& variant_name, const CpuTopology& topology, bool read_only)
+{
+  const std::size_t ops_per_thread = 200'000;
+  const auto max_threads = topology.cpu_count();
+
+  Trie trie;
+  for (const auto& word : instance.words)
+    trie.insert(word);
+
+  for (const auto scatter : { false, true }) {
+    if (scatter && topology.nodes.size() < 2)
+      continue; // both placements are identical on a single node
+    const auto cpus = topology.cpu_order(scatter);
+    double single_thread_throughput = 0.0;
+    for (const auto threads : thread_counts(max_threads)) {
+      const auto time_ns = run_pinned_threads(threads, cpus, [&](std::size_t t) {
+        const auto& queries = instance.queries;
+        auto i = t * queries.size() / threads;
+        bool accum = false;
+        for (std::size_t n = 0; n < ops_per_thread; ++n, ++i) {
+          const auto& [op, word] = queries[i % queries.size()];
+          if (read_only || op == 2)
+            accum ^= trie.contains(word);
+          else if (op == 0)
+            accum ^= trie.insert(word);
+          else
+            accum ^= trie.remove(word);
+        }
+        DoNotOptimize(accum);
+      });
+      const auto throughput = static_cast<double>(threads * ops_per_thread) * 1e9 / static_cast<double>(time_ns);
+      if (threads == 1)
+        single_thread_throughput = throughput;
+      ofs << threads << ',' << variant_name << ',' << (scatter ? "scatter" : "compact") << ',' << topology.nodes_used(cpus, threads) << ','
+          << static_cast<long>(throughput) << ',' << throughput / single_thread_throughput << '\n';
+    }
+  }
+}
+
+// The instance queries in batches through ShardedTrie::apply_batch, with pools of growing size
+template<typename Trie>
+void
+run_batch_scaling(std::ofstream& ofs, const Instance& instance, const std::string& variant_name, std::size_t max_threads)
+{
+  const auto batches = query_batches(instance, 4096);
+  double single_thread_throughput = 0.0;
+  for (const auto threads : thread_counts(max_threads)) {
+    ShardedTrie<Trie> trie(64, threads);
+    for (const auto& word : instance.words)
+      trie.insert(word);
+
+    std::vector<std::uint8_t> results;
+    std::size_t trues = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& batch : batches) {
+      trie.apply_batch(batch, results);
+      trues += results.back();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    DoNotOptimize(trues);
+
+    const auto time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    const auto throughput = static_cast<double>(instance.queries.size()) * 1e9 / static_cast<double>(time_ns);
+    if (threads == 1)
+      single_thread_throughput = throughput;
+    ofs << threads << ',' << variant_name << ",pool,1," << static_cast<long>(throughput) << ',' << throughput / single_thread_throughput << '\n';
+  }
+}
+
+inline void
+plot_thread_scaling()
+{
+  const auto topology = CpuTopology::detect();
+  const auto num_words = 200'000;
+  const auto num_queries = 300'000;
+  const auto min_word_length = 4, max_word_length = 24;
+  const auto chance_random_query = 50;
+
+  std::cout << "Thread scaling on " << topology.cpu_count() << " cpus in " << topology.nodes.size() << " numa node(s)\n";
+
+  std::ofstream ofs;
+
+  ofs = std::ofstream(csv_path("plot_thread_scaling_contains"));
+  ofs << "threads,variant,placement,numa_nodes,throughput_ops_per_s,speedup\n";
+  {
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, 0, num_queries, 0, chance_random_query);
+    run_thread_scaling<VectorTrie>(ofs, instance, "VectorTrie", topology, true);
+    run_thread_scaling<ArrayTrie>(ofs, instance, "ArrayTrie", topology, true);
+    run_thread_scaling<HashTrie>(ofs, instance, "HashTrie", topology, true);
+  }
+
+  // 90% contains, 5% insert, 5% remove
+  ofs = std::ofstream(csv_path("plot_thread_scaling_mixed"));
+  ofs << "threads,variant,placement,numa_nodes,throughput_ops_per_s,speedup\n";
+  {
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, num_queries / 20, num_queries * 18 / 20, num_queries / 20, chance_random_query);
+    run_thread_scaling<SharedMutexTrie<VectorTrie>>(ofs, instance, "SharedMutex<VectorTrie>", topology, false);
+    run_thread_scaling<SharedMutexTrie<ArrayTrie>>(ofs, instance, "SharedMutex<ArrayTrie>", topology, false);
+    run_thread_scaling<SharedMutexTrie<HashTrie>>(ofs, instance, "SharedMutex<HashTrie>", topology, false);
+    // readers never lock, writers publish path copies
+    run_thread_scaling<PersistentTrie>(ofs, instance, "PersistentTrie", topology, false);
+    // one lock per shard of the first two symbols
+    run_thread_scaling<ShardedTrie<VectorTrie>>(ofs, instance, "Sharded<VectorTrie>", topology, false);
+    run_thread_scaling<ShardedTrie<HashTrie>>(ofs, instance, "Sharded<HashTrie>", topology, false);
+  }
+
+  // write-heavy batches: 50% contains, 25% insert, 25% remove
+  ofs = std::ofstream(csv_path("plot_thread_scaling_batch"));
+  ofs << "threads,variant,placement,numa_nodes,throughput_ops_per_s,speedup\n";
+  {
+    Instance instance = create_instance(num_words, min_word_length, max_word_length, num_queries / 4, num_queries / 2, num_queries / 4, chance_random_query);
+    run_batch_scaling<VectorTrie>(ofs, instance, "Sharded<VectorTrie>", topology.cpu_count());
+    run_batch_scaling<ArrayTrie>(ofs, instance, "Sharded<ArrayTrie>", topology.cpu_count());
+    run_batch_scaling<HashTrie>(ofs, instance, "Sharded<HashTrie>", topology.cpu_count());
+  }
+
+  std::cout << "Plot data for Thread Scaling written to plot_thread_scaling_contains.csv, plot_thread_scaling_mixed.csv and "
+               "plot_thread_scaling_batch.csv\n";
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm> // for std::shuffle, std::lower_bound, std::min
+#include <cctype>    // for std::isalnum
+#include <cmath>     // for std::pow
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t, std::uint64_t
+#include <fstream>   // for std::ifstream
+#include <random>    // for std::mt19937, std::seed_seq, distributions
+#include <string>    // for std::string
+#include <utility>   // for std::pair, std::move
+#include <vector>    // for std::vector
+
+enum class KeyDistribution
+{
+  Uniform, // uniform random alphanumeric words (the original generator)
+  Natural, // syllable based words with shared stems, prefixes and inflections
+  Url,     // url-like keys with few hosts and shared path segments
+  File     // words sampled from a local word list
+};
+
+inline const char*
+key_distribution_name(KeyDistribution keys)
+{
+  switch (keys) {
+    case KeyDistribution::Natural:
+      return "natural";
+    case KeyDistribution::Url:
+      return "url";
+    case KeyDistribution::File:
+      return "file";
+    default:
+      return "uniform";
+  }
+}
+
+// Global workload settings, set once from the command line.
+struct WorkloadConfig
+{
+  std::uint64_t seed = 42;
+  KeyDistribution keys = KeyDistribution::Uniform;
+  double zipf_exponent = 0.0; // 0 selects uniform query popularity
+  std::vector<std::string> corpus{};
+  std::string scenario{}; // appended to every csv file name if not empty
+};
+
+inline WorkloadConfig&
+workload_config()
+{
+  static WorkloadConfig config;
+  return config;
+}
+
+// csv file name for the current scenario, e.g. plot_fill_factor_insert_zipf.csv
+inline std::string
+csv_path(const std::string& stem)
+{
+  const auto& scenario = workload_config().scenario;
+  return scenario.empty() ? stem + ".csv" : stem + "_" + scenario + ".csv";
+}
+
+// Loads one word per line, stripping trailing non-alphanumeric characters like ti_programm does.
+inline bool
+load_corpus(const std::string& path, std::vector<std::string>& corpus)
+{
+  auto stream = std::ifstream{ path };
+  if (!stream)
+    return false;
+  std::string line;
+  while (std::getline(stream, line)) {
+    while (!line.empty() && !std::isalnum(static_cast<unsigned char>(line.back())))
+      line.pop_back();
+    if (!line.empty())
+      corpus.push_back(line);
+  }
+  return !corpus.empty();
+}
+
+// Samples ranks in [0, n) with probability proportional to 1 / (rank + 1)^exponent.
+class ZipfDistribution
+{
+private:
+  std::vector<double> cdf;
+
+public:
+  ZipfDistribution(std::size_t n, double exponent)
+    : cdf(n)
+  {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+      cdf[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+    for (auto& value : cdf)
+      value /= sum;
+  }
+
+  std::size_t operator()(std::mt19937& rng) const
+  {
+    const auto u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    const auto it = std::lower_bound(cdf.begin(), cdf.end(), u);
+    return std::min(static_cast<std::size_t>(it - cdf.begin()), cdf.size() - 1);
+  }
+};
+
+inline std::string
+random_word(std::mt19937& rng, int min_word_length, int max_word_length)
+{
+  static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  std::uniform_int_distribution length_dist(static_cast<std::size_t>(min_word_length), static_cast<std::size_t>(max_word_length));
+  std::uniform_int_distribution<> chars_dist(0, sizeof(chars) - 2);
+  const auto length = length_dist(rng);
+  std::string result;
+  result.reserve((length + 1));
+  for (std::size_t i = 0; i < length; ++i)
+    result.push_back(chars[chars_dist(rng)]);
+  result.push_back('$');
+  return result;
+}
+
+// Generates '$'-terminated keys of the configured distribution.
+// Natural and url keys draw their stems zipf-distributed from a shared vocabulary,
+// so they share prefixes and suffixes the way real dictionaries do.
+class KeyGenerator
+{
+private:
+  const WorkloadConfig& config;
+  std::mt19937& rng;
+  std::vector<std::string> stems;
+  ZipfDistribution stem_dist;
+  std::vector<std::vector<std::string>> corpus_by_length;
+
+  static std::string syllable(std::mt19937& vocabulary_rng)
+  {
+    static constexpr const char* onsets[] = { "", "b", "c", "d", "f", "g", "h", "l", "m", "n", "p", "r", "s", "t", "v", "w", "st", "tr", "pl", "ch", "sh", "th", "br", "gr" };
+    static constexpr const char* vowels[] = { "a", "e", "i", "o", "u", "ea", "ou", "io", "ai" };
+    static constexpr const char* codas[] = { "", "", "n", "r", "s", "t", "l", "nd", "st", "ng" };
+    std::string result = onsets[std::uniform_int_distribution<std::size_t>(0, std::size(onsets) - 1)(vocabulary_rng)];
+    result += vowels[std::uniform_int_distribution<std::size_t>(0, std::size(vowels) - 1)(vocabulary_rng)];
+    result += codas[std::uniform_int_distribution<std::size_t>(0, std::size(codas) - 1)(vocabulary_rng)];
+    return result;
+  }
+
+  const std::string& stem() { return stems[stem_dist(rng)]; }
+
+  // the first choices are the most common ones
+  template<std::size_t N>
+  const char* pick(const char* const (&choices)[N])
+  {
+    static const ZipfDistribution dist(N, 1.0);
+    return choices[dist(rng)];
+  }
+
+  std::string natural_word()
+  {
+    static constexpr const char* prefixes[] = { "", "un", "re", "in", "pre", "dis", "over", "sub", "inter" };
+    static constexpr const char* suffixes[] = { "", "s", "ed", "ing", "er", "ly", "ness", "tion", "able", "est", "ment" };
+    return std::string{ pick(prefixes) } + stem() + pick(suffixes);
+  }
+
+  std::string url_word()
+  {
+    static constexpr const char* schemes[] = { "https://", "http://" };
+    static constexpr const char* hosts[] = { "www.", "", "api.", "cdn.", "docs." };
+    static constexpr const char* tlds[] = { ".com", ".org", ".de", ".net", ".io" };
+    std::string result = std::string{ pick(schemes) } + pick(hosts) + stems[std::uniform_int_distribution<std::size_t>(0, 63)(rng)] + pick(tlds);
+    const auto segments = std::uniform_int_distribution<int>(1, 4)(rng);
+    for (int i = 0; i < segments; ++i)
+      result += "/" + stem();
+    if (std::uniform_int_distribution<int>(0, 3)(rng) == 0)
+      result += "?id=" + std::to_string(std::uniform_int_distribution<int>(0, 99999)(rng));
+    return result;
+  }
+
+  std::string corpus_word(std::size_t length)
+  {
+    // prefer words of exactly the missing length, fall back to any word and cut it
+    const auto& source = length < corpus_by_length.size() && !corpus_by_length[length].empty() ? corpus_by_length[length] : config.corpus;
+    return source[std::uniform_int_distribution<std::size_t>(0, source.size() - 1)(rng)];
+  }
+
+public:
+  KeyGenerator(const WorkloadConfig& config_, std::mt19937& rng_)
+    : config(config_)
+    , rng(rng_)
+    , stem_dist(4096, 1.0)
+  {
+    // the vocabulary only depends on the seed so all instances share it
+    auto vocabulary_rng = std::mt19937(static_cast<std::uint32_t>(config.seed));
+    stems.reserve(4096);
+    for (std::size_t i = 0; i < 4096; ++i) {
+      std::string s;
+      const auto syllables = std::uniform_int_distribution<int>(1, 3)(vocabulary_rng);
+      for (int j = 0; j < syllables; ++j)
+        s += syllable(vocabulary_rng);
+      stems.push_back(std::move(s));
+    }
+
+    if (config.keys == KeyDistribution::File) {
+      for (const auto& word : config.corpus) {
+        if (corpus_by_length.size() <= word.size())
+          corpus_by_length.resize(word.size() + 1);
+        corpus_by_length[word.size()].push_back(word);
+      }
+    }
+  }
+
+  std::string operator()(int min_word_length, int max_word_length)
+  {
+    if (config.keys == KeyDistribution::Uniform)
+      return random_word(rng, min_word_length, max_word_length);
+
+    const auto length = std::uniform_int_distribution<std::size_t>(static_cast<std::size_t>(min_word_length), static_cast<std::size_t>(max_word_length))(rng);
+    std::string result;
+    // concatenate until long enough (compounds / deeper paths), then cut to length
+    while (result.size() < length) {
+      switch (config.keys) {
+        case KeyDistribution::Natural:
+          result += natural_word();
+          break;
+        case KeyDistribution::Url:
+          result += result.empty() ? url_word() : "/" + stem();
+          break;
+        default:
+          result += corpus_word(length - result.size());
+          break;
+      }
+    }
+    result.resize(length);
+    result.push_back('$');
+    return result;
+  }
+};
+
+struct Instance
+{
+  int num_words;
+  int min_word_length;
+  int max_word_length;
+  int num_insert_queries;
+  int num_contains_queries;
+  int num_remove_queries;
+  int chance_random_query;
+  std::vector<std::string> words{};
+  std::vector<std::pair<int, std::string>> queries{};
+};
+
+// Instances are deterministic: the generator is seeded from the configured seed and the instance parameters,
+// so every instance is reproducible independent of the order in which the sweeps create them.
+inline Instance
+create_instance(int num_words,
+                int min_word_length,
+                int max_word_length,
+                int num_insert_queries,
+                int num_contains_queries,
+                int num_remove_queries,
+                int chance_random_query)
+{
+  const auto& config = workload_config();
+  const auto seed = static_cast<std::uint32_t>(config.seed ^ (config.seed >> 32));
+  std::seed_seq seq{ seed,
+                     static_cast<std::uint32_t>(config.keys),
+                     static_cast<std::uint32_t>(num_words),
+                     static_cast<std::uint32_t>(min_word_length),
+                     static_cast<std::uint32_t>(max_word_length),
+                     static_cast<std::uint32_t>(num_insert_queries),
+                     static_cast<std::uint32_t>(num_contains_queries),
+                     static_cast<std::uint32_t>(num_remove_queries),
+                     static_cast<std::uint32_t>(chance_random_query) };
+  std::mt19937 rng(seq);
+  KeyGenerator next_key(config, rng);
+
+  Instance instance{ num_words, min_word_length, max_word_length, num_insert_queries, num_contains_queries, num_remove_queries, chance_random_query };
+
+  instance.words.reserve(static_cast<std::size_t>(num_words));
+  for (int i = 0; i < num_words; ++i)
+    instance.words.push_back(next_key(min_word_length, max_word_length));
+
+  std::uniform_int_distribution percent_dist(0, 99);
+  std::uniform_int_distribution<std::size_t> index_dist(0, static_cast<std::size_t>(std::max(num_words, 1) - 1));
+  const auto popularity = config.zipf_exponent > 0.0 ? ZipfDistribution(static_cast<std::size_t>(std::max(num_words, 1)), config.zipf_exponent)
+                                                     : ZipfDistribution(0, 0.0);
+  const auto pick_word = [&]() -> std::string {
+    if (percent_dist(rng) < chance_random_query || instance.words.empty())
+      return next_key(min_word_length, max_word_length);
+    // the words are generated in random order, so rank i is just the i-th word
+    return instance.words[config.zipf_exponent > 0.0 ? popularity(rng) : index_dist(rng)];
+  };
+  instance.queries.reserve(static_cast<std::size_t>(num_insert_queries + num_remove_queries + num_contains_queries));
+
+  // Insert queries.
+  for (int i = 0; i < num_insert_queries; ++i)
+    instance.queries.emplace_back(0, pick_word());
+  // Remove queries.
+  for (int i = 0; i < num_remove_queries; ++i)
+    instance.queries.emplace_back(1, pick_word());
+  // Contains queries.
+  for (int i = 0; i < num_contains_queries; ++i)
+    instance.queries.emplace_back(2, pick_word());
+  std::shuffle(instance.queries.begin(), instance.queries.end(), rng);
+
+  return instance;
+}
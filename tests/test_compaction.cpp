@@ -0,0 +1,89 @@
+#include <random>
+#include <set>
+#include <string>
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_WORDS 5'000
+#define NUM_CHURN 50'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 12};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+template<typename Trie>
+static std::set<std::string> words_of(const Trie &trie) {
+    std::set<std::string> words;
+    trie.for_each([&words](const std::string &word) { words.insert(word); });
+    return words;
+}
+
+template<typename Trie>
+static void test_compaction() {
+    std::mt19937 rng(17);
+    Trie trie;
+    std::set<std::string> expected;
+
+    // 1) Churn, then compact in one go
+    for (int i = 0; i < NUM_WORDS; ++i) {
+        const auto w = random_word(rng);
+        trie.insert(w);
+        expected.insert(w);
+    }
+    for (int i = 0; i < NUM_CHURN; ++i) {
+        const auto w = random_word(rng);
+        if (rng() % 2) {
+            trie.insert(w);
+            expected.insert(w);
+        } else if (!expected.empty()) {
+            // remove an existing word, so nodes get freed all over the trie
+            auto victim = expected.lower_bound(w);
+            if (victim == expected.end())
+                victim = expected.begin();
+            trie.remove(*victim);
+            expected.erase(victim);
+        }
+    }
+    const auto size_before = trie.size();
+    trie.compact();
+    ASSERT(words_of(trie) == expected);
+    ASSERT_LE(trie.size(), size_before);
+
+    // 2) Incremental passes interleaved with mutations, which restart the pass
+    for (int round = 0; round < 200; ++round) {
+        trie.compact_step(64);
+        const auto w = random_word(rng);
+        if (round % 3 == 0) {
+            trie.remove(w);
+            expected.erase(w);
+        } else {
+            trie.insert(w);
+            expected.insert(w);
+        }
+        ASSERT(trie.contains(w) == (expected.count(w) == 1));
+    }
+    int steps = 0;
+    while (!trie.compact_step(64))
+        ++steps;
+    ASSERT_GT(steps, 0, "a pass over thousands of nodes takes several slices");
+    ASSERT(words_of(trie) == expected);
+}
+
+int main() {
+    test_compaction<VectorTrie>();
+    test_compaction<ArrayTrie>();
+    test_compaction<HashTrie>();
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+
+#include <array_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_QUERIES 30'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "aZ09b";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 6};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static void check_queries(const CountingArrayTrie &trie, const std::set<std::string> &expected, std::mt19937 &rng) {
+    ASSERT_EQ(trie.word_count(), expected.size());
+
+    // select(i) enumerates the words in order, rank is its inverse
+    std::size_t i = 0;
+    std::string word;
+    for (const auto &w : expected) {
+        ASSERT(trie.select(i, word), "select(%zu) failed\n", i);
+        ASSERT(word == w, "select(%zu)='%s' expected '%s'\n", i, word.c_str(), w.c_str());
+        ASSERT_EQ(trie.rank(w), i, "[RANK] word='%s'\n", w.c_str());
+        ++i;
+    }
+    ASSERT(!trie.select(i, word));
+
+    for (int q = 0; q < 200; ++q) {
+        const auto w = random_word(rng);
+        const auto lower = expected.lower_bound(w);
+        ASSERT_EQ(trie.rank(w), static_cast<std::size_t>(std::distance(expected.begin(), lower)), "[RANK] word='%s'\n", w.c_str());
+
+        const auto prefix = w.substr(0, 1 + rng() % 3);
+        std::size_t count = 0;
+        for (auto it = expected.lower_bound(prefix); it != expected.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+            ++count;
+        ASSERT_EQ(trie.count_prefix(prefix), count, "[COUNT_PREFIX] prefix='%s'\n", prefix.c_str());
+    }
+}
+
+int main() {
+    std::mt19937 rng(29);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 2};
+
+    // 1) Counters follow inserts and removes, with and without a finger
+    CountingArrayTrie trie;
+    CountingArrayTrie::Finger finger;
+    std::set<std::string> expected;
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        const auto w = random_word(rng);
+        const bool with_finger = i % 2;
+        if (operation_dist(rng)) {
+            ASSERT_EQ(with_finger ? trie.insert(w, finger) : trie.insert(w), expected.insert(w).second, "[INSERT] word='%s'\n", w.c_str());
+        } else {
+            with_finger ? trie.remove(w, finger) : trie.remove(w);
+            expected.erase(w);
+        }
+        if (i % 5'000 == 0)
+            check_queries(trie, expected, rng);
+    }
+    check_queries(trie, expected, rng);
+
+    // 2) Compaction keeps the counters
+    trie.compact();
+    check_queries(trie, expected, rng);
+
+    // 3) Empty again
+    for (const auto &w : expected)
+        trie.remove(w);
+    ASSERT_EQ(trie.word_count(), 0);
+    ASSERT_EQ(trie.count_prefix(""), 0);
+    std::string word;
+    ASSERT(!trie.select(0, word));
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dawg.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_STEMS 2'000
+
+// stems combined with a few shared endings, so many words share suffixes
+static std::string random_stem(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdefgh";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 8};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+int main() {
+    // 1) Shared suffixes are merged into a minimal automaton
+    {
+        DawgBuilder builder;
+        for (const char *w : {"cat", "cats", "dog", "dogs"})
+            ASSERT(builder.add(w));
+        const auto dawg = builder.finish();
+        ASSERT_EQ(dawg.num_states(), 7, "root, c, ca, d, do, shared final 't'/'g' state, shared 's' state");
+        ASSERT(dawg.contains("cat") && dawg.contains("cats") && dawg.contains("dog") && dawg.contains("dogs"));
+        ASSERT(!dawg.contains("ca") && !dawg.contains("dogss") && !dawg.contains("") && !dawg.contains("cog"));
+    }
+
+    // 2) Input must be strictly increasing
+    {
+        DawgBuilder builder;
+        ASSERT(builder.add(""));
+        ASSERT(builder.add("b"));
+        ASSERT(!builder.add("a"));
+        ASSERT(!builder.add("b"));
+        ASSERT(builder.add("ba"));
+        const auto dawg = builder.finish();
+        ASSERT(dawg.contains("") && dawg.contains("b") && dawg.contains("ba") && !dawg.contains("a"));
+    }
+
+    // 3) Random dictionary against a reference
+    std::mt19937 rng(5);
+    std::set<std::string> expected;
+    const char *endings[] = {"", "s", "ed", "ing", "er", "ers"};
+    for (int i = 0; i < NUM_STEMS; ++i) {
+        const auto stem = random_stem(rng);
+        for (const char *ending : endings)
+            if (rng() % 2)
+                expected.insert(stem + ending);
+    }
+    DawgBuilder builder;
+    for (const auto &w : expected)
+        ASSERT(builder.add(w));
+    const auto dawg = builder.finish();
+
+    std::vector<std::string> enumerated;
+    dawg.for_each([&enumerated](const std::string &word) { enumerated.push_back(word); });
+    ASSERT(enumerated == std::vector<std::string>(expected.begin(), expected.end()), "for_each is not in sorted order");
+    for (int i = 0; i < 100'000; ++i) {
+        const auto w = random_stem(rng) + endings[rng() % 6];
+        ASSERT_EQ(dawg.contains(w), expected.count(w) == 1, "[CONTAINS] word='%s'\n", w.c_str());
+    }
+    ASSERT_LT(dawg.num_edges(), expected.size(), "suffixes are not shared");
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <durable_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_WORDS 2'000
+#define NUM_QUERIES 20'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdef";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 6};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static std::set<std::string> words_of(const DurableTrie<VectorTrie> &trie) {
+    std::set<std::string> words;
+    trie.for_each([&words](const std::string &word) { words.insert(word); });
+    return words;
+}
+
+int main() {
+    std::mt19937 rng(7);
+    const auto directory = std::filesystem::temp_directory_path() / ("test_durable_trie_" + std::to_string(rng()));
+    std::filesystem::remove_all(directory);
+
+    std::set<std::string> expected;
+
+    // 1) Mutate with frequent checkpoints and group commits, then "restart"
+    {
+        DurableTrie<VectorTrie> trie(directory, 16, 997);
+        DurableTrie<VectorTrie>::RecoveryInfo info;
+        ASSERT(trie.open(&info));
+        ASSERT(!info.recovered);
+
+        for (int i = 0; i < NUM_WORDS; ++i) {
+            const auto w = random_word(rng);
+            trie.insert(w);
+            expected.insert(w);
+        }
+        auto operation_dist = std::uniform_int_distribution<int>{0, 1};
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            const auto w = random_word(rng);
+            if (operation_dist(rng)) {
+                trie.insert(w);
+                expected.insert(w);
+            } else {
+                trie.remove(w);
+                expected.erase(w);
+            }
+        }
+        ASSERT(trie.good());
+        ASSERT(words_of(trie) == expected);
+    }
+
+    // 2) Recovery restores snapshot plus log tail
+    {
+        DurableTrie<VectorTrie> trie(directory, 16, 997);
+        DurableTrie<VectorTrie>::RecoveryInfo info;
+        ASSERT(trie.open(&info));
+        ASSERT(info.recovered);
+        ASSERT_LT(info.wal_records, 997, "only the log tail after the last checkpoint is replayed");
+        ASSERT(words_of(trie) == expected);
+
+        // keep mutating after recovery
+        trie.insert("recovered");
+        expected.insert("recovered");
+        trie.remove("recovered");
+        expected.erase("recovered");
+        trie.insert("again");
+        expected.insert("again");
+    }
+
+    // 3) A torn record at the end of the log is dropped
+    {
+        std::FILE *wal = std::fopen((directory / "wal").string().c_str(), "ab");
+        ASSERT(wal != nullptr);
+        std::fputs("i\x05" "ab", wal);
+        std::fclose(wal);
+
+        DurableTrie<VectorTrie> trie(directory, 16, 997);
+        ASSERT(trie.open());
+        ASSERT(words_of(trie) == expected);
+        ASSERT(trie.checkpoint());
+    }
+
+    // 4) A torn length is bounded by the file and dropped without allocating it
+    {
+        std::FILE *wal = std::fopen((directory / "wal").string().c_str(), "ab");
+        ASSERT(wal != nullptr);
+        std::fputs("i\xf0\xff\xff\xff\x0f" "ab", wal);
+        std::fclose(wal);
+
+        DurableTrie<VectorTrie> trie(directory, 16, 997);
+        DurableTrie<VectorTrie>::RecoveryInfo info;
+        ASSERT(trie.open(&info));
+        ASSERT_EQ(info.wal_records, 0);
+        ASSERT(words_of(trie) == expected);
+        ASSERT(trie.checkpoint());
+    }
+
+    // 5) After an explicit checkpoint there is no tail left to replay
+    {
+        DurableTrie<VectorTrie> trie(directory, 16, 997);
+        DurableTrie<VectorTrie>::RecoveryInfo info;
+        ASSERT(trie.open(&info));
+        ASSERT_EQ(info.wal_records, 0);
+        ASSERT_EQ(info.snapshot_words, expected.size());
+        ASSERT(words_of(trie) == expected);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
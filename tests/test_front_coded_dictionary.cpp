@@ -0,0 +1,106 @@
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <front_coded_dictionary.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_WORDS 20'000
+
+// few characters and a long shared stem now and then, so words share prefixes within and across blocks
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcd";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{0, 12};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+
+    std::string result = rng() % 4 ? "" : "http://www.example.org/path/";
+    const auto length = length_dist(rng);
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static std::vector<std::string> with_prefix(const FrontCodedDictionary &dictionary, const std::string &prefix) {
+    std::vector<std::string> words;
+    dictionary.for_each_with_prefix(prefix, [&words](const std::string &word) { words.push_back(word); });
+    return words;
+}
+
+int main() {
+    // 1) Small dictionary within one block
+    {
+        FrontCodedBuilder builder;
+        for (const char *w : {"car", "card", "care", "cart", "cat", "dog"})
+            ASSERT(builder.add(w));
+        const auto dictionary = builder.finish();
+        ASSERT_EQ(dictionary.num_blocks(), 1);
+        ASSERT(dictionary.contains("car") && dictionary.contains("cart") && dictionary.contains("dog"));
+        ASSERT(!dictionary.contains("ca") && !dictionary.contains("cars") && !dictionary.contains("") && !dictionary.contains("dogs"));
+        ASSERT(with_prefix(dictionary, "car") == std::vector<std::string>({"car", "card", "care", "cart"}));
+        ASSERT(with_prefix(dictionary, "x").empty());
+    }
+
+    // 2) Input must be strictly increasing, the empty word is a valid first word
+    {
+        FrontCodedBuilder builder;
+        ASSERT(builder.add(""));
+        ASSERT(builder.add("b"));
+        ASSERT(!builder.add("a"));
+        ASSERT(!builder.add("b"));
+        ASSERT(builder.add("ba"));
+        const auto dictionary = builder.finish();
+        ASSERT_EQ(dictionary.word_count(), 3);
+        ASSERT(dictionary.contains("") && dictionary.contains("b") && dictionary.contains("ba") && !dictionary.contains("a"));
+    }
+
+    // 3) Empty dictionary
+    {
+        const auto dictionary = FrontCodedBuilder{}.finish();
+        ASSERT(!dictionary.contains("") && !dictionary.contains("a"));
+        ASSERT(with_prefix(dictionary, "").empty());
+    }
+
+    // 4) Words longer than the padded stack copy and the 16-byte comparison
+    {
+        const std::string long_word(300, 'x');
+        FrontCodedBuilder builder;
+        ASSERT(builder.add(long_word));
+        ASSERT(builder.add(long_word + "y"));
+        const auto dictionary = builder.finish();
+        ASSERT(dictionary.contains(long_word) && dictionary.contains(long_word + "y"));
+        ASSERT(!dictionary.contains(long_word.substr(1)) && !dictionary.contains(long_word + "x"));
+    }
+
+    // 5) Random dictionary against a reference
+    std::mt19937 rng(7);
+    std::set<std::string> expected;
+    for (int i = 0; i < NUM_WORDS; ++i)
+        expected.insert(random_word(rng));
+    FrontCodedBuilder builder;
+    for (const auto &w : expected)
+        ASSERT(builder.add(w));
+    const auto dictionary = builder.finish();
+    ASSERT_EQ(dictionary.num_blocks(), (expected.size() + 15) / 16);
+
+    std::vector<std::string> enumerated;
+    dictionary.for_each([&enumerated](const std::string &word) { enumerated.push_back(word); });
+    ASSERT(enumerated == std::vector<std::string>(expected.begin(), expected.end()), "for_each is not in sorted order");
+    for (const auto &w : expected)
+        ASSERT(dictionary.contains(w), "[CONTAINS] word='%s'\n", w.c_str());
+    for (int i = 0; i < 100'000; ++i) {
+        const auto w = random_word(rng);
+        ASSERT_EQ(dictionary.contains(w), expected.count(w) == 1, "[CONTAINS] word='%s'\n", w.c_str());
+    }
+    for (int i = 0; i < 1'000; ++i) {
+        auto prefix = random_word(rng);
+        prefix.resize(prefix.size() / 2);
+        std::vector<std::string> reference;
+        for (auto it = expected.lower_bound(prefix); it != expected.end() && it->starts_with(prefix); ++it)
+            reference.push_back(*it);
+        ASSERT(with_prefix(dictionary, prefix) == reference, "[PREFIX] prefix='%s'\n", prefix.c_str());
+    }
+
+    return 0;
+}
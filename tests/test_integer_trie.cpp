@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <integer_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_QUERIES 200'000
+
+template<typename Key>
+static std::vector<Key> range_of(const IntegerTrie<Key> &trie, Key low, Key high) {
+    std::vector<Key> keys;
+    trie.for_each_in_range(low, high, [&keys](Key key) { keys.push_back(key); });
+    return keys;
+}
+
+template<typename Key>
+static std::vector<Key> range_of(const std::set<Key> &set, Key low, Key high) {
+    if (low > high)
+        return {};
+    return {set.lower_bound(low), set.upper_bound(high)};
+}
+
+// keys from a few clustered runs, so the nodes get both sparse and full bitmaps and are pruned again
+template<typename Key>
+static void test_random_operations(std::mt19937_64 &rng) {
+    std::vector<Key> bases;
+    for (int i = 0; i < 8; ++i)
+        bases.push_back(static_cast<Key>(rng()));
+    bases.push_back(0);
+    bases.push_back(static_cast<Key>(std::numeric_limits<Key>::max() - 2000));
+    auto base_dist = std::uniform_int_distribution<std::size_t>{0, bases.size() - 1};
+    auto offset_dist = std::uniform_int_distribution<unsigned>{0, 2000};
+    auto operation_dist = std::uniform_int_distribution<int>{0, 4};
+    const auto random_key = [&] { return static_cast<Key>(bases[base_dist(rng)] + offset_dist(rng)); };
+
+    IntegerTrie<Key> trie;
+    std::set<Key> expected;
+    const auto empty_size = trie.size();
+
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        const auto key = random_key();
+        Key result = 0;
+        switch (operation_dist(rng)) {
+            case 0:
+                ASSERT_EQ(trie.insert(key), expected.insert(key).second);
+                break;
+            case 1:
+                ASSERT_EQ(trie.remove(key), expected.erase(key) == 1);
+                break;
+            case 2:
+                ASSERT_EQ(trie.contains(key), expected.contains(key));
+                break;
+            case 3: {
+                const auto it = expected.lower_bound(key);
+                ASSERT_EQ(trie.lower_bound(key, result), it != expected.end());
+                if (it != expected.end())
+                    ASSERT_EQ(result, *it);
+                const auto next = expected.upper_bound(key);
+                ASSERT_EQ(trie.upper_bound(key, result), next != expected.end());
+                if (next != expected.end())
+                    ASSERT_EQ(result, *next);
+                break;
+            }
+            default: {
+                const auto high = static_cast<Key>(key + offset_dist(rng));
+                ASSERT(range_of(trie, key, high) == range_of(expected, key, high));
+                break;
+            }
+        }
+        ASSERT_EQ(trie.key_count(), expected.size());
+    }
+
+    // all keys in order, then empty again with every node but the root pruned
+    std::vector<Key> all;
+    trie.for_each([&all](Key key) { all.push_back(key); });
+    ASSERT(all == std::vector<Key>(expected.begin(), expected.end()));
+    for (const auto key : all)
+        ASSERT(trie.remove(key));
+    ASSERT_EQ(trie.key_count(), 0u);
+    ASSERT_LE(trie.size(), empty_size + 256 * sizeof(void *), "only the root with its child capacity is left");
+}
+
+int main() {
+    std::mt19937_64 rng(11);
+
+    // 1) Byte order is numeric order, the extreme keys included
+    IntegerTrie<std::uint32_t> trie;
+    ASSERT(trie.insert(0x01000000u));
+    ASSERT(trie.insert(0x000000FFu));
+    ASSERT(trie.insert(0xFFFFFFFFu));
+    ASSERT(trie.insert(0u));
+    ASSERT(!trie.insert(0x000000FFu));
+    ASSERT(range_of(trie, 0u, 0xFFFFFFFFu) == std::vector<std::uint32_t>({0u, 0xFFu, 0x01000000u, 0xFFFFFFFFu}));
+    std::uint32_t result = 0;
+    ASSERT(trie.lower_bound(0x100u, result) && result == 0x01000000u);
+    ASSERT(trie.upper_bound(0x01000000u, result) && result == 0xFFFFFFFFu);
+    ASSERT(!trie.upper_bound(0xFFFFFFFFu, result));
+    ASSERT(range_of(trie, 1u, 0x00FFFFFFu) == std::vector<std::uint32_t>({0xFFu}));
+    ASSERT(range_of(trie, 5u, 4u).empty());
+
+    // 2) Sorted runs share the path of the previous key, other orders still work
+    IntegerTrie<std::uint64_t> runs;
+    std::vector<std::uint64_t> ids;
+    for (std::uint64_t id = 1'700'000'000'000; ids.size() < 10'000; id += 1 + rng() % 300)
+        ids.push_back(id);
+    ASSERT_EQ(runs.insert_sorted(ids.begin(), ids.end()), ids.size());
+    ASSERT_EQ(runs.insert_sorted(ids.begin(), ids.begin() + 100), 0u);
+    const std::vector<std::uint64_t> unsorted{42, 7, 1'700'000'000'001, 7};
+    ASSERT_EQ(runs.insert_sorted(unsorted.begin(), unsorted.end()), 3u);
+    ASSERT_EQ(runs.key_count(), ids.size() + 3);
+    for (const auto id : ids)
+        ASSERT(runs.contains(id));
+    ASSERT(runs.contains(7) && runs.contains(42) && runs.contains(1'700'000'000'001));
+
+    // 3) Random operations against std::set
+    test_random_operations<std::uint8_t>(rng);
+    test_random_operations<std::uint16_t>(rng);
+    test_random_operations<std::uint32_t>(rng);
+    test_random_operations<std::uint64_t>(rng);
+    return 0;
+}
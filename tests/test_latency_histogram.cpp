@@ -0,0 +1,60 @@
+#include <cstdint>
+
+#include <latency_histogram.hpp>
+
+#include "test_util.hpp"
+
+int main() {
+    // 1) Small values are exact
+    {
+        LatencyHistogram histogram;
+        for (std::uint64_t v = 1; v <= 100; ++v)
+            histogram.record(v);
+        ASSERT_EQ(histogram.count(), 100);
+        ASSERT_EQ(histogram.min(), 1);
+        ASSERT_EQ(histogram.max(), 100);
+        ASSERT_EQ(histogram.percentile(0.5), 50);
+        ASSERT_EQ(histogram.percentile(1.0), 100);
+    }
+
+    // 2) Values with the top bit set, e.g. a wrapped cycle counter delta, stay in range
+    {
+        LatencyHistogram histogram;
+        histogram.record(~0ull);
+        histogram.record(1ull << 63);
+        histogram.record(1);
+        ASSERT_EQ(histogram.count(), 3);
+        ASSERT_EQ(histogram.max(), ~0ull);
+        ASSERT_EQ(histogram.percentile(1.0), ~0ull);
+        ASSERT_LE(1ull << 63, histogram.percentile(0.6));
+
+        LatencyHistogram merged;
+        merged.merge(histogram);
+        ASSERT_EQ(merged.count(), 3);
+        ASSERT_EQ(merged.percentile(1.0), ~0ull);
+    }
+
+    // 3) Relative error of large values stays below 2^-7
+    {
+        LatencyHistogram histogram;
+        const std::uint64_t value = 123'456'789;
+        histogram.record(value);
+        histogram.record(value + 1);
+        const auto p50 = histogram.percentile(0.5);
+        ASSERT_LE(value, p50);
+        ASSERT_LE(p50 - value, value / 128);
+    }
+
+    // 4) Outcomes are recorded as given
+    {
+        LatencyRecorder recorder;
+        recorder.record(LatencyRecorder::Remove, true, 10);
+        recorder.record(LatencyRecorder::Remove, false, 20);
+        recorder.record(LatencyRecorder::Insert, false, 30);
+        ASSERT_EQ(recorder.histogram(LatencyRecorder::Remove, true).count(), 1);
+        ASSERT_EQ(recorder.histogram(LatencyRecorder::Remove, false).count(), 1);
+        ASSERT_EQ(recorder.histogram(LatencyRecorder::Insert, false).max(), 30);
+    }
+
+    return 0;
+}
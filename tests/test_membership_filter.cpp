@@ -0,0 +1,103 @@
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <array_trie.hpp>
+#include <dawg.hpp>
+#include <membership_filter.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_WORDS 20'000
+#define NUM_QUERIES 200'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 10};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+template<typename Trie>
+static void test_filtered_trie() {
+    std::mt19937 rng(23);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 2};
+    Trie plain;
+    FilteredTrie<Trie> filtered;
+
+    // the filter must never turn a hit into a miss, across growth and rebuilds
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        const auto w = random_word(rng) + "$";
+        switch (operation_dist(rng)) {
+            case 0:
+                ASSERT_EQ(plain.insert(w), filtered.insert(w), "[INSERT] word='%s'\n", w.c_str());
+                break;
+            case 1:
+                ASSERT_EQ(plain.remove(w), filtered.remove(w), "[REMOVE] word='%s'\n", w.c_str());
+                break;
+            default:
+                ASSERT_EQ(plain.contains(w), filtered.contains(w), "[CONTAINS] word='%s'\n", w.c_str());
+                break;
+        }
+    }
+}
+
+int main() {
+    test_filtered_trie<VectorTrie>();
+    test_filtered_trie<ArrayTrie>();
+
+    std::mt19937 rng(29);
+    std::set<std::string> words;
+    while (words.size() < NUM_WORDS)
+        words.insert(random_word(rng));
+
+    // 1) Bloom filter: no false negatives, few false positives
+    {
+        BlockedBloomFilter bloom(words.size());
+        for (const auto &w : words)
+            bloom.insert(util::wordHash(w));
+        std::size_t false_positives = 0, absent = 0;
+        for (const auto &w : words)
+            ASSERT(bloom.may_contain(util::wordHash(w)));
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            const auto w = random_word(rng) + "#";
+            ++absent;
+            false_positives += bloom.may_contain(util::wordHash(w));
+        }
+        ASSERT_LT(false_positives * 100, absent * 2, "false positive rate above 2%%");
+    }
+
+    // 2) Xor filter in front of a Dawg
+    {
+        DawgBuilder builder;
+        for (const auto &w : words)
+            builder.add(w);
+        XorFilteredDictionary<Dawg> dictionary(builder.finish());
+        XorFilter xor_filter;
+        std::vector<std::uint64_t> hashes;
+        for (const auto &w : words)
+            hashes.push_back(util::wordHash(w));
+        ASSERT(xor_filter.build(hashes));
+
+        std::size_t false_positives = 0;
+        for (const auto &w : words) {
+            ASSERT(xor_filter.may_contain(util::wordHash(w)));
+            ASSERT(dictionary.contains(w));
+        }
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            const auto w = random_word(rng) + "#";
+            false_positives += xor_filter.may_contain(util::wordHash(w));
+            ASSERT(!dictionary.contains(w));
+        }
+        ASSERT_LT(false_positives * 100, NUM_QUERIES, "false positive rate above 1%%");
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <paged_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_QUERIES 60'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdefgh01";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 40};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static std::vector<std::string> words_of(const PagedTrie &trie) {
+    std::vector<std::string> words;
+    trie.for_each([&words](const std::string &word) { words.push_back(word); });
+    return words;
+}
+
+int main() {
+    const auto path = (std::filesystem::temp_directory_path() / "test_paged_trie.pages").string();
+    std::filesystem::remove(path);
+
+    std::mt19937 rng(42);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 3};
+    std::set<std::string> reference;
+
+    // 1) Random operations with a pool far smaller than the file agree with a std::set
+    {
+        PagedTrie trie(path, 16);
+        ASSERT(trie.open());
+        for (std::size_t i = 0; i < NUM_QUERIES; ++i) {
+            const auto w = random_word(rng);
+            switch (operation_dist(rng)) {
+                case 0:
+                case 1:
+                    ASSERT_EQ(trie.insert(w), reference.insert(w).second, "[INSERT] word='%s'\n", w.c_str());
+                    break;
+                case 2: {
+                    const bool found = reference.erase(w) != 0;
+                    ASSERT_EQ(trie.remove(w), found && reference.empty(), "[REMOVE] word='%s'\n", w.c_str());
+                    break;
+                }
+                default:
+                    ASSERT_EQ(trie.contains(w), reference.count(w) != 0, "[CONTAINS] word='%s'\n", w.c_str());
+            }
+        }
+        ASSERT(trie.good());
+        ASSERT(trie.file_size() > 10 * 16 * PagedTrie::PageSize);
+        ASSERT(trie.cache_stats().misses > 0);
+        ASSERT(!trie.insert(std::string(PagedTrie::MaxWordLength + 1, 'a')));
+        ASSERT_EQ(trie.word_count(), reference.size());
+    }
+
+    // 2) Reopening the file restores every word, in order
+    {
+        PagedTrie trie(path, 32);
+        ASSERT(trie.open());
+        ASSERT_EQ(trie.word_count(), reference.size());
+        ASSERT(words_of(trie) == std::vector<std::string>(reference.begin(), reference.end()));
+
+        // 3) Removing everything empties the trie
+        std::size_t left = reference.size();
+        for (const auto &w : reference)
+            ASSERT_EQ(trie.remove(w), --left == 0, "[REMOVE ALL] word='%s'\n", w.c_str());
+        ASSERT(words_of(trie).empty());
+        ASSERT(trie.insert("again"));
+        ASSERT(trie.contains("again"));
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
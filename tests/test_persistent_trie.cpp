@@ -0,0 +1,78 @@
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <persistent_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_VERSIONS 50
+#define MUTATIONS_PER_VERSION 200
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcd";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 8};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static std::set<std::string> words_of(const PersistentTrie::Snapshot &snapshot) {
+    std::set<std::string> words;
+    snapshot.for_each([&words](const std::string &word) { words.insert(word); });
+    return words;
+}
+
+int main() {
+    std::mt19937 rng(11);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 2};
+
+    PersistentTrie trie;
+    std::set<std::string> expected;
+    std::vector<PersistentTrie::Snapshot> snapshots;
+    std::vector<std::set<std::string>> expected_snapshots;
+
+    // 1) Take a snapshot after every batch of mutations
+    for (int v = 0; v < NUM_VERSIONS; ++v) {
+        for (int i = 0; i < MUTATIONS_PER_VERSION; ++i) {
+            const auto w = random_word(rng);
+            if (operation_dist(rng)) {
+                ASSERT_EQ(trie.insert(w), expected.insert(w).second, "[INSERT] word='%s'\n", w.c_str());
+            } else {
+                trie.remove(w);
+                expected.erase(w);
+            }
+            ASSERT_EQ(trie.contains(w), expected.count(w) == 1, "[CONTAINS] word='%s'\n", w.c_str());
+        }
+        snapshots.push_back(trie.snapshot());
+        expected_snapshots.push_back(expected);
+    }
+
+    // 2) Every snapshot still shows its own version
+    for (std::size_t v = 0; v < snapshots.size(); ++v) {
+        ASSERT(words_of(snapshots[v]) == expected_snapshots[v], "snapshot %zu changed\n", v);
+        for (const auto &w : expected_snapshots[v])
+            ASSERT(snapshots[v].contains(w));
+    }
+
+    // 3) Versions share their unchanged subtrees
+    const auto retained = PersistentTrie::retained_size(snapshots);
+    std::size_t copied = 0;
+    for (const auto &s : snapshots)
+        copied += s.size();
+    ASSERT_LT(retained, copied, "snapshots do not share nodes");
+    ASSERT_GT(retained, trie.size());
+
+    // 4) Removing everything leaves older snapshots intact
+    for (const auto &w : expected)
+        trie.remove(w);
+    ASSERT(words_of(trie.snapshot()).empty());
+    ASSERT(words_of(snapshots.back()) == expected);
+
+    return 0;
+}
@@ -3,10 +3,13 @@
 #include <string>
 #include <random>
 #include <algorithm>
+#include <set>
 
 #include <array_trie.hpp>
 #include <vector_trie.hpp>
 #include <hash_trie.hpp>
+#include <persistent_trie.hpp>
+#include <tail_trie.hpp>
 
 #include "test_util.hpp"
 
@@ -16,6 +19,40 @@
 #define NUM_QUERIES 500'000
 #define CHANCE_RANDOM_QUERY 10
 
+template<typename Trie>
+static void check_set_operations(const std::set<std::string> &a, const std::set<std::string> &b) {
+    std::set<std::string> all = a;
+    all.insert(b.begin(), b.end());
+
+    // 0: union, 1: intersection, 2: difference
+    for (int operation = 0; operation < 3; ++operation) {
+        Trie trie_a, trie_b;
+        for (const auto &w: a)
+            trie_a.insert(w);
+        for (const auto &w: b)
+            trie_b.insert(w);
+        if (operation == 0)
+            trie_a.unite(std::move(trie_b));
+        else if (operation == 1)
+            trie_a.intersect(trie_b);
+        else
+            trie_a.subtract(trie_b);
+
+        std::size_t expected_size = 0;
+        for (const auto &w: all) {
+            const bool in_a = a.count(w), in_b = b.count(w);
+            const bool expected = operation == 0 ? in_a || in_b : operation == 1 ? in_a && in_b : in_a && !in_b;
+            expected_size += expected;
+            ASSERT_EQ(trie_a.contains(w), expected, "[SET OPERATION %d] Mismatch on word='%s'\n", operation, w.c_str());
+        }
+        std::size_t size = 0;
+        trie_a.for_each([&size](const std::string &) { ++size; });
+        ASSERT_EQ(size, expected_size, "[SET OPERATION %d] Wrong number of words\n", operation);
+        if constexpr (requires { trie_a.word_count(); })
+            ASSERT_EQ(trie_a.word_count(), expected_size, "[SET OPERATION %d] Wrong word counter\n", operation);
+    }
+}
+
 static std::string random_word(std::mt19937 &rng) {
     static constexpr char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
     auto length_dist = std::uniform_int_distribution<std::size_t>{MIN_WORD_LENGTH, MAX_WORD_LENGTH};
@@ -39,6 +76,8 @@ int main() {
     VectorTrie v_trie;
     ArrayTrie a_trie;
     HashTrie h_trie;
+    PersistentTrie p_trie;
+    TailTrie t_trie;
 
     // 1) Generate random input words
     std::vector<std::string> words;
@@ -50,8 +89,12 @@ int main() {
         auto vr = v_trie.insert(word);
         auto ar = a_trie.insert(word);
         auto hr = h_trie.insert(word);
+        auto pr = p_trie.insert(word);
+        auto tr = t_trie.insert(word);
         ASSERT_EQ(vr, ar, "[INSERT] Mismatch on word='%s'\n", word.c_str());
         ASSERT_EQ(ar, hr, "[INSERT] Mismatch on word='%s'\n", word.c_str());
+        ASSERT_EQ(hr, pr, "[INSERT] Mismatch on word='%s'\n", word.c_str());
+        ASSERT_EQ(pr, tr, "[INSERT] Mismatch on word='%s'\n", word.c_str());
     }
 
     // 3) Generate random queries
@@ -75,24 +118,36 @@ int main() {
                 const auto vr = v_trie.insert(w);
                 const auto ar = a_trie.insert(w);
                 const auto hr = h_trie.insert(w);
+                const auto pr = p_trie.insert(w);
+                const auto tr = t_trie.insert(w);
                 ASSERT_EQ(vr, ar, "[QUERY] Mismatch on operation 'insert' word='%s'\n", w.c_str());
                 ASSERT_EQ(ar, hr, "[QUERY] Mismatch on operation 'insert' word='%s'\n", w.c_str());
+                ASSERT_EQ(hr, pr, "[QUERY] Mismatch on operation 'insert' word='%s'\n", w.c_str());
+                ASSERT_EQ(pr, tr, "[QUERY] Mismatch on operation 'insert' word='%s'\n", w.c_str());
                 break;
             }
             case 1: {
                 const auto vr = v_trie.remove(w);
                 const auto ar = a_trie.remove(w);
                 const auto hr = h_trie.remove(w);
+                const auto pr = p_trie.remove(w);
+                const auto tr = t_trie.remove(w);
                 ASSERT_EQ(vr, ar, "[QUERY] Mismatch on operation 'remove' word='%s'\n", w.c_str());
                 ASSERT_EQ(ar, hr, "[QUERY] Mismatch on operation 'remove' word='%s'\n", w.c_str());
+                ASSERT_EQ(hr, pr, "[QUERY] Mismatch on operation 'remove' word='%s'\n", w.c_str());
+                ASSERT_EQ(pr, tr, "[QUERY] Mismatch on operation 'remove' word='%s'\n", w.c_str());
                 break;
             }
             case 2: {
                 const auto vr = v_trie.contains(w);
                 const auto ar = a_trie.contains(w);
                 const auto hr = h_trie.contains(w);
+                const auto pr = p_trie.contains(w);
+                const auto tr = t_trie.contains(w);
                 ASSERT_EQ(vr, ar, "[QUERY] Mismatch on operation 'contains' word='%s'\n", w.c_str());
                 ASSERT_EQ(ar, hr, "[QUERY] Mismatch on operation 'contains' word='%s'\n", w.c_str());
+                ASSERT_EQ(hr, pr, "[QUERY] Mismatch on operation 'contains' word='%s'\n", w.c_str());
+                ASSERT_EQ(pr, tr, "[QUERY] Mismatch on operation 'contains' word='%s'\n", w.c_str());
                 break;
             }
             default:
@@ -100,5 +155,18 @@ int main() {
         }
     }
 
+    // 4) Set operations between the final words and an overlapping random set
+    std::set<std::string> final_words, other_words;
+    v_trie.for_each([&final_words](const std::string &w) { final_words.insert(w); });
+    for (const auto &w: final_words)
+        if (percent_dist(rng) < 50)
+            other_words.insert(w);
+    for (int i = 0; i < NUM_WORDS; ++i)
+        other_words.insert(random_word(rng));
+    check_set_operations<VectorTrie>(final_words, other_words);
+    check_set_operations<ArrayTrie>(final_words, other_words);
+    check_set_operations<HashTrie>(final_words, other_words);
+    check_set_operations<CountingArrayTrie>(final_words, other_words);
+
     return 0;
 }
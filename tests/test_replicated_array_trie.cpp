@@ -0,0 +1,59 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <array_trie.hpp>
+#include <replicated_array_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_WORDS 20'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcXY01-_";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{0, 12};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+int main() {
+    std::mt19937 rng(7);
+    ArrayTrie trie;
+    for (std::size_t i = 0; i < NUM_WORDS; ++i)
+        trie.insert(random_word(rng));
+    trie.remove(random_word(rng));
+
+    // 1) Every layout answers like the ArrayTrie it was copied from, including the empty word
+    //    and the non-alphanumeric characters mapped to 0
+    const FlatArrayTrie huge(trie, true);
+    const FlatArrayTrie small(trie, false);
+    const auto copy = huge.clone();
+    const ReplicatedArrayTrie replicated(trie);
+    ASSERT(replicated.num_replicas() >= 1);
+    ASSERT_EQ(huge.node_count(), small.node_count());
+    ASSERT(huge.size() - sizeof(FlatArrayTrie) >= huge.node_count() * 256);
+
+    std::size_t words = 0;
+    trie.for_each([&words](const std::string &) { ++words; });
+    ASSERT_EQ(huge.word_count(), words);
+
+    for (std::size_t i = 0; i < 4 * NUM_WORDS; ++i) {
+        const auto w = random_word(rng);
+        const bool expected = trie.contains(w);
+        ASSERT_EQ(huge.contains(w), expected, "[HUGE] word='%s'\n", w.c_str());
+        ASSERT_EQ(small.contains(w), expected, "[SMALL] word='%s'\n", w.c_str());
+        ASSERT_EQ(copy.contains(w), expected, "[CLONE] word='%s'\n", w.c_str());
+        ASSERT_EQ(replicated.contains(w), expected, "[REPLICATED] word='%s'\n", w.c_str());
+    }
+
+    // 2) An empty trie still answers
+    const FlatArrayTrie empty(ArrayTrie{});
+    ASSERT(!empty.contains(""));
+    ASSERT(!empty.contains("a"));
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hash_trie.hpp>
+#include <sharded_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_BATCHES 50
+#define BATCH_SIZE 4096
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abcdefgh";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{0, 6};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    std::string result(length_dist(rng), ' ');
+    for (auto &c : result)
+        c = chars[chars_dist(rng)];
+    return result;
+}
+
+template<typename Trie>
+static void test_batches(std::mt19937 &rng) {
+    ShardedTrie<Trie> trie(16, 4);
+    std::set<std::string> expected;
+    auto operation_dist = std::uniform_int_distribution<int>{0, 3};
+
+    for (int b = 0; b < NUM_BATCHES; ++b) {
+        QueryBatch batch;
+        std::vector<std::uint8_t> reference;
+        for (int i = 0; i < BATCH_SIZE; ++i) {
+            const auto word = random_word(rng);
+            const char operation = "cidx"[operation_dist(rng)];
+            batch.push_back({word, operation});
+            // the reference executes the batch in order
+            if (operation == 'c')
+                reference.push_back(expected.contains(word));
+            else if (operation == 'i')
+                reference.push_back(expected.insert(word).second);
+            else if (operation == 'd')
+                reference.push_back(expected.erase(word) == 1);
+            else
+                reference.push_back(0);
+        }
+        std::vector<std::uint8_t> results;
+        trie.apply_batch(batch, results);
+        ASSERT(results == reference, "batch %d differs from sequential execution\n", b);
+    }
+
+    for (const auto &word : expected)
+        ASSERT(trie.contains(word));
+}
+
+int main() {
+    std::mt19937 rng(5);
+
+    // 1) Every task of every run is executed exactly once
+    util::WorkStealingPool pool(4);
+    for (std::size_t n : {0u, 1u, 3u, 64u, 1000u}) {
+        std::vector<std::atomic<int>> executed(n);
+        pool.run(n, [&](std::size_t i) { executed[i].fetch_add(1); });
+        for (const auto &count : executed)
+            ASSERT_EQ(count.load(), 1);
+    }
+
+    // 1b) A throwing task does not stop the others, run() rethrows once all are done
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        std::vector<std::atomic<int>> executed(256);
+        bool caught = false;
+        try {
+            pool.run(executed.size(), [&](std::size_t i) {
+                executed[i].fetch_add(1);
+                if (i % 64 == 7)
+                    throw std::runtime_error("task failed");
+            });
+        } catch (const std::runtime_error &) {
+            caught = true;
+        }
+        ASSERT(caught);
+        for (const auto &count : executed)
+            ASSERT_EQ(count.load(), 1);
+    }
+
+    // 2) Batches give the results of sequential execution, in batch order
+    test_batches<VectorTrie>(rng);
+    test_batches<HashTrie>(rng);
+
+    // 3) Single operations from concurrent threads, each on its own words
+    ShardedTrie<VectorTrie> trie(8, 1);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&trie, t] {
+            for (int i = 0; i < 20'000; ++i) {
+                const auto word = std::to_string(t) + "w" + std::to_string(i);
+                ASSERT(trie.insert(word));
+                ASSERT(trie.contains(word));
+                if (i % 2)
+                    ASSERT(trie.remove(word));
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    for (int t = 0; t < 4; ++t) {
+        for (int i = 0; i < 20'000; ++i) {
+            const bool kept = i % 2 == 0;
+            ASSERT_EQ(trie.contains(std::to_string(t) + "w" + std::to_string(i)), kept);
+        }
+    }
+    ASSERT(!trie.remove("absent"));
+    return 0;
+}
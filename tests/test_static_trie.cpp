@@ -0,0 +1,57 @@
+#include <string>
+
+#include <array_trie.hpp>
+#include <static_trie.hpp>
+
+#include "test_util.hpp"
+
+using Verbs = StaticTrie<"GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH">;
+using Reserved = StaticTrie<"if", "in", "int", "inline", "for", "float", "friend", "false">;
+using Empty = StaticTrie<>;
+
+int main() {
+    // 1) Every word is found, prefixes, extensions and other cases are not
+    static_assert(Verbs::contains("GET"));
+    static_assert(Verbs::contains("HEAD"));
+    static_assert(Verbs::contains("POST"));
+    static_assert(Verbs::contains("PUT"));
+    static_assert(Verbs::contains("DELETE"));
+    static_assert(Verbs::contains("CONNECT"));
+    static_assert(Verbs::contains("OPTIONS"));
+    static_assert(Verbs::contains("TRACE"));
+    static_assert(Verbs::contains("PATCH"));
+    static_assert(!Verbs::contains(""));
+    static_assert(!Verbs::contains("G"));
+    static_assert(!Verbs::contains("GE"));
+    static_assert(!Verbs::contains("GETS"));
+    static_assert(!Verbs::contains("get"));
+    static_assert(!Verbs::contains("PUSH"));
+    static_assert(!Verbs::contains("PATCHES"));
+
+    // 2) Words that are prefixes of each other share their states
+    static_assert(Reserved::contains("in"));
+    static_assert(Reserved::contains("int"));
+    static_assert(Reserved::contains("inline"));
+    static_assert(!Reserved::contains("i"));
+    static_assert(!Reserved::contains("inl"));
+    static_assert(!Reserved::contains("fo"));
+    static_assert(Reserved::num_states == 2 + 14 + 10);
+    static_assert(sizeof(Reserved::State) == 1);
+
+    // 3) Same symbol mapping as ArrayTrie: non-alphanumeric characters map to 0
+    static_assert(StaticTrie<"a-b">::contains("a_b"));
+    static_assert(!StaticTrie<"a-b">::contains("ab"));
+
+    // 4) Empty set
+    static_assert(!Empty::contains(""));
+    static_assert(!Empty::contains("a"));
+
+    // 5) Agrees with an ArrayTrie at runtime
+    ArrayTrie trie;
+    for (const char *w : {"if", "in", "int", "inline", "for", "float", "friend", "false"})
+        trie.insert(w);
+    for (const std::string w : {"i", "if", "ifs", "in", "int", "inte", "inline", "f", "for", "float", "friends", "false", "true", "IF"})
+        ASSERT_EQ(Reserved::contains(w), trie.contains(w), "[CONTAINS] word='%s'\n", w.c_str());
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <random>
+#include <set>
+#include <string>
+
+#include <tail_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_QUERIES 200'000
+
+// few symbols and varying lengths, so words are prefixes of each other and tails get split and merged
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abc";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{0, 12};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+static std::set<std::string> words_of(const TailTrie &trie) {
+    std::set<std::string> words;
+    trie.for_each([&words](const std::string &word) { ASSERT(words.insert(word).second, "'%s' visited twice\n", word.c_str()); });
+    return words;
+}
+
+int main() {
+    std::mt19937 rng(3);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 2};
+
+    TailTrie trie;
+    std::set<std::string> expected;
+
+    // 1) Splitting: a word inside a tail, a word extending a tail, diverging words
+    ASSERT(trie.insert("abcdef"));
+    ASSERT(trie.insert("abc"));
+    ASSERT(trie.insert("abcdefgh"));
+    ASSERT(trie.insert("abxy"));
+    ASSERT(!trie.insert("abcdef"));
+    ASSERT(trie.contains("abc") && trie.contains("abcdef") && trie.contains("abcdefgh") && trie.contains("abxy"));
+    ASSERT(!trie.contains("ab") && !trie.contains("abcd") && !trie.contains("abcdefg") && !trie.contains("abx"));
+
+    // 2) Merging: removing all but one word leaves a single tail again
+    const auto size_with_one_word = [] {
+        TailTrie single;
+        single.insert("abcdefgh");
+        return single.size();
+    }();
+    trie.remove("abxy");
+    trie.remove("abc");
+    trie.remove("abcdef");
+    ASSERT(trie.contains("abcdefgh"));
+    ASSERT_LE(trie.size() - size_with_one_word, 64, "subtree with one word was not merged into a tail");
+    ASSERT(trie.remove("abcdefgh"), "trie is empty afterwards");
+
+    // 3) Random operations against a reference
+    for (int i = 0; i < NUM_QUERIES; ++i) {
+        const auto w = random_word(rng);
+        switch (operation_dist(rng)) {
+            case 0:
+                ASSERT_EQ(trie.insert(w), expected.insert(w).second, "[INSERT] word='%s'\n", w.c_str());
+                break;
+            case 1:
+                trie.remove(w);
+                expected.erase(w);
+                break;
+            default:
+                ASSERT_EQ(trie.contains(w), expected.count(w) == 1, "[CONTAINS] word='%s'\n", w.c_str());
+                break;
+        }
+    }
+    ASSERT(words_of(trie) == expected);
+
+    // 4) Long words need far less memory than one node per character
+    TailTrie tail_trie;
+    VectorTrie vector_trie;
+    for (int i = 0; i < 1'000; ++i) {
+        const auto w = std::to_string(i) + std::string(64, 'x');
+        tail_trie.insert(w);
+        vector_trie.insert(w);
+    }
+    ASSERT_LT(tail_trie.size() * 10, vector_trie.size());
+
+    return 0;
+}
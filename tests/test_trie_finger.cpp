@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+#define NUM_QUERIES 20'000
+
+static std::string random_word(std::mt19937 &rng) {
+    static constexpr char chars[] = "abc01";
+    auto length_dist = std::uniform_int_distribution<std::size_t>{1, 10};
+    auto chars_dist = std::uniform_int_distribution<std::size_t>{0, sizeof(chars) - 2};
+    const auto length = length_dist(rng);
+
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+        result.push_back(chars[chars_dist(rng)]);
+    return result;
+}
+
+template<typename Trie>
+static std::set<std::string> words_of(const Trie &trie) {
+    std::set<std::string> words;
+    trie.for_each([&words](const std::string &word) { words.insert(word); });
+    return words;
+}
+
+template<typename Trie>
+static void test_finger(bool sorted) {
+    std::mt19937 rng(23);
+    auto operation_dist = std::uniform_int_distribution<int>{0, 2};
+
+    std::vector<std::string> words(NUM_QUERIES);
+    for (auto &w : words)
+        w = random_word(rng);
+    if (sorted)
+        std::sort(words.begin(), words.end());
+
+    // 1) Every operation through a finger agrees with the same operation on a plain trie
+    Trie trie, reference;
+    typename Trie::Finger finger, other;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        const auto &w = words[i];
+        switch (operation_dist(rng)) {
+            case 0:
+                ASSERT_EQ(trie.insert(w, finger), reference.insert(w), "[INSERT] word='%s'\n", w.c_str());
+                break;
+            case 1:
+                ASSERT_EQ(trie.remove(w, finger), reference.remove(w), "[REMOVE] word='%s'\n", w.c_str());
+                break;
+            default:
+                ASSERT_EQ(trie.contains(w, finger), reference.contains(w), "[CONTAINS] word='%s'\n", w.c_str());
+        }
+        // 2) A second finger and plain operations in between do not leave stale paths behind
+        if (i % 97 == 0)
+            ASSERT_EQ(trie.remove(words[i / 2], other), reference.remove(words[i / 2]));
+        if (i % 101 == 0)
+            ASSERT_EQ(trie.remove(words[i / 3]), reference.remove(words[i / 3]));
+        if (i % 997 == 0)
+            trie.compact();
+    }
+    ASSERT(words_of(trie) == words_of(reference));
+
+    // 3) Removing everything through the finger empties the trie
+    const auto remaining = words_of(trie);
+    std::size_t left = remaining.size();
+    for (const auto &w : remaining)
+        ASSERT_EQ(trie.remove(w, finger), --left == 0, "[REMOVE ALL] word='%s'\n", w.c_str());
+    ASSERT(words_of(trie).empty());
+    ASSERT(!trie.contains(words.front(), finger));
+}
+
+int main() {
+    for (const bool sorted : {true, false}) {
+        test_finger<VectorTrie>(sorted);
+        test_finger<ArrayTrie>(sorted);
+        test_finger<HashTrie>(sorted);
+    }
+    return 0;
+}
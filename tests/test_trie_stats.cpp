@@ -0,0 +1,89 @@
+// the instrumented build is tested here, the other tests cover the one without tracing
+#if !defined(TRIES_TRACE)
+#define TRIES_TRACE 1
+#endif
+
+#include <string>
+#include <vector>
+
+#include <array_trie.hpp>
+#include <hash_trie.hpp>
+#include <vector_trie.hpp>
+
+#include "test_util.hpp"
+
+template<typename Trie>
+static void test_stats() {
+    // root -> a -> b -> {c, d}, root -> x
+    const std::vector<std::string> words{"ab", "abc", "abd", "x"};
+    Trie trie;
+    for (const auto &w : words)
+        trie.insert(w);
+
+    // 1) Shape and memory of the trie
+    const auto stats = trie.stats();
+    ASSERT_EQ(stats.words, words.size());
+    ASSERT_EQ(stats.nodes(), 6u);
+    ASSERT_EQ(stats.height(), 3u);
+    ASSERT(stats.nodes_per_depth == std::vector<std::size_t>({1, 2, 1, 2}));
+    ASSERT(stats.fanout == std::vector<std::size_t>({3, 1, 2}));
+    ASSERT_EQ(stats.bytes(), trie.size());
+    ASSERT_EQ(stats.bytes_per_depth.size(), stats.nodes_per_depth.size());
+
+    // 2) Trace counters of the queries
+    util::reset_trace();
+    ASSERT(trie.contains("abc"));
+    ASSERT(!trie.contains("ax"));
+    auto trace = util::trace_snapshot();
+    ASSERT_EQ(trace.operations, 2u);
+    ASSERT_EQ(trace.nodes_visited, 6u); // root, a, b, c and root, a
+    ASSERT_EQ(trace.searches, 5u);
+    ASSERT(trace.probes >= trace.searches - 1);
+    ASSERT_EQ(trace.allocations, 0u);
+
+    util::reset_trace();
+    ASSERT(trie.insert("abcde"));
+    ASSERT_EQ(util::trace_snapshot().allocations, 2u);
+
+    // 3) Pruning "abcde" frees d and e, "abc" keeps its node
+    util::reset_trace();
+    ASSERT(!trie.remove("abcde"));
+    ASSERT(!trie.remove("abc"));
+    trace = util::trace_snapshot();
+    ASSERT_EQ(trace.operations, 2u);
+    ASSERT_EQ(trace.prunes, 2u);
+    ASSERT_EQ(trace.frees, 3u);
+    ASSERT_EQ(trie.stats().nodes(), 5u);
+
+    // 4) Fingers are traced as well
+    util::reset_trace();
+    typename Trie::Finger finger;
+    ASSERT(trie.insert("xyz", finger));
+    ASSERT(!trie.remove("xyz", finger));
+    trace = util::trace_snapshot();
+    ASSERT_EQ(trace.operations, 2u);
+    ASSERT_EQ(trace.allocations, 2u);
+    ASSERT_EQ(trace.frees, 2u);
+    ASSERT_EQ(trace.prunes, 1u);
+    ASSERT_EQ(trie.stats().words, 3u);
+
+    // 5) A finger remove that frees no node is no prune
+    ASSERT(trie.insert("xy", finger));
+    ASSERT(trie.insert("xyz", finger));
+    util::reset_trace();
+    ASSERT(!trie.remove("xy", finger));
+    trace = util::trace_snapshot();
+    ASSERT_EQ(trace.frees, 0u);
+    ASSERT_EQ(trace.prunes, 0u);
+    ASSERT(!trie.remove("xyz", finger));
+    ASSERT_EQ(util::trace_snapshot().prunes, 1u);
+    ASSERT_EQ(util::trace_snapshot().frees, 2u);
+}
+
+int main() {
+    test_stats<VectorTrie>();
+    test_stats<ArrayTrie>();
+    test_stats<CountingArrayTrie>();
+    test_stats<HashTrie>();
+    return 0;
+}
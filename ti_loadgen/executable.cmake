@@ -0,0 +1,2 @@
+find_package(Threads REQUIRED)
+target_link_libraries(${TARGET_NAME} PRIVATE tries Threads::Threads)
@@ -0,0 +1,271 @@
+#include <latency_histogram.hpp>
+#include <query_protocol.hpp>
+
+#include <chrono>   // for std::chrono::steady_clock, etc.
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+#include <cstdlib>  // for std::exit
+#include <fstream>  // for std::ifstream, std::ofstream
+#include <iostream> // for std::cout, std::cerr, std::endl
+#include <string>   // for std::string
+#include <utility>  // for std::pair
+#include <vector>   // for std::vector
+
+#if defined(__linux__)
+#include <cerrno>       // for errno, EAGAIN, EINTR
+#include <cstring>      // for std::memcpy
+#include <deque>        // for std::deque
+#include <fcntl.h>      // for fcntl, F_SETFL, O_NONBLOCK
+#include <sys/epoll.h>  // for epoll_create1, epoll_ctl, epoll_wait
+#include <sys/socket.h> // for socket, connect, recv, send
+#include <sys/un.h>     // for sockaddr_un
+#include <thread>       // for std::this_thread::sleep_for
+#include <unistd.h>     // for close
+#endif
+
+// Replays a query file against a ti_programm server (-serve) over pipelined connections and
+// reports throughput and latency percentiles. Connection k sends the queries k, k + n, k + 2n, ...
+// of the file with at most -pipeline requests in flight. The latency of a request runs from
+// handing it to the socket to receiving its answer.
+
+struct Options
+{
+  std::string socket_path;
+  std::string query_path;
+  std::string results_path; // empty if the answers are not written
+  std::size_t connections = 1;
+  std::size_t pipeline = 64;
+  std::size_t repeat = 1;
+};
+
+[[noreturn]] void
+usage()
+{
+  std::cerr << "Usage: ti_loadgen <socket> <query_datei> [-connections=<n>] [-pipeline=<n>] [-repeat=<n>] [-results=<datei>]" << std::endl;
+  std::exit(1);
+}
+
+Options
+parse_options(int argc, char** argv)
+{
+  auto options = Options{};
+  auto positional = std::vector<std::string>{};
+  for (int i = 1; i < argc; ++i) {
+    const auto arg = std::string{ argv[i] };
+    if (arg.size() < 2 || arg.front() != '-') {
+      positional.push_back(arg);
+      continue;
+    }
+    const auto eq = arg.find('=');
+    const auto name = arg.substr(1, eq == std::string::npos ? std::string::npos : eq - 1);
+    const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+    if (name == "connections" && !value.empty())
+      options.connections = std::stoull(value);
+    else if (name == "pipeline" && !value.empty())
+      options.pipeline = std::stoull(value);
+    else if (name == "repeat" && !value.empty())
+      options.repeat = std::stoull(value);
+    else if (name == "results" && !value.empty())
+      options.results_path = value;
+    else
+      usage();
+  }
+  if (positional.size() != 2 || !options.connections || !options.pipeline || !options.repeat)
+    usage();
+  options.socket_path = positional[0];
+  options.query_path = positional[1];
+  return options;
+}
+
+// A query the server can answer; line is its index among the query lines of the file
+struct Request
+{
+  char operation;
+  std::string word;
+  std::size_t line;
+};
+
+// Reads the requests of the query file. num_lines counts every query line, as many as a batch
+// run answers: lines with another operation are answered false there and are not sent, words
+// too long for a request are not sent either.
+std::vector<Request>
+read_queries(const std::string& query_path, std::size_t& num_lines)
+{
+  auto queries = std::vector<Request>{};
+  auto query_stream = std::ifstream{ query_path, std::ios::binary };
+
+  if (!query_stream) {
+    std::cerr << "Error opening " << query_path << std::endl;
+    std::exit(1);
+  }
+
+  std::string line;
+  char operation = 0;
+  num_lines = 0;
+  while (std::getline(query_stream, line)) {
+    if (!parse_query(line, operation))
+      continue;
+    if (util::valid_operation(operation) && line.size() <= util::MaxRequestWord)
+      queries.push_back({ operation, line, num_lines });
+    ++num_lines;
+  }
+  return queries;
+}
+
+#if defined(__linux__)
+struct Connection
+{
+  int fd = -1;
+  std::size_t next = 0; // queries sent, over all repetitions
+  std::string out;
+  std::size_t out_begin = 0;
+  std::deque<std::pair<std::size_t, std::uint64_t>> in_flight; // query index and send time
+};
+
+// Connects to the server, retrying while it is still starting up
+int
+connect_server(const std::string& socket_path)
+{
+  sockaddr_un address{};
+  if (socket_path.size() >= sizeof(address.sun_path))
+    return -1;
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+      return -1;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+      return fd;
+    ::close(fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  return -1;
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto options = parse_options(argc, argv);
+  auto num_lines = std::size_t{ 0 };
+  const auto queries = read_queries(options.query_path, num_lines);
+  const auto num_connections = options.connections;
+  auto answers = std::vector<char>(num_lines); // per query line, false if it was not sent
+  auto latency = LatencyHistogram{};
+
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  auto connections = std::vector<Connection>(num_connections);
+  for (std::size_t k = 0; k < num_connections; ++k) {
+    auto& connection = connections[k];
+    connection.fd = connect_server(options.socket_path);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT;
+    event.data.u64 = k;
+    if (connection.fd < 0 || ::fcntl(connection.fd, F_SETFL, O_NONBLOCK) < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection.fd, &event) < 0) {
+      std::cerr << "Error connecting to " << options.socket_path << std::endl;
+      std::exit(1);
+    }
+  }
+
+  // queries of connection k: k, k + n, ... repeated
+  const auto share = [&](std::size_t k) { return queries.size() > k ? (queries.size() - k + num_connections - 1) / num_connections : std::size_t{ 0 }; };
+  std::size_t open = num_connections;
+
+  auto events = std::vector<epoll_event>(num_connections);
+  auto chunk = std::vector<char>(std::size_t{ 1 } << 16);
+  const auto start = std::chrono::steady_clock::now();
+  while (open) {
+    const auto n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+    if (n < 0 && errno != EINTR)
+      break;
+    for (int e = 0; e < n; ++e) {
+      const std::size_t k = events[static_cast<std::size_t>(e)].data.u64;
+      auto& c = connections[k];
+      const auto total = share(k) * options.repeat;
+
+      // answers complete the oldest requests in flight
+      while (true) {
+        const auto received = ::recv(c.fd, chunk.data(), chunk.size(), 0);
+        if (received <= 0) {
+          if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+            std::cerr << "Error: server closed the connection" << std::endl;
+            std::exit(1);
+          }
+          break;
+        }
+        const auto now = util::cycle_clock::now();
+        for (std::size_t i = 0; i < static_cast<std::size_t>(received); ++i) {
+          answers[queries[c.in_flight.front().first].line] = chunk[i];
+          latency.record(now - c.in_flight.front().second);
+          c.in_flight.pop_front();
+        }
+      }
+
+      // refill the pipeline
+      const auto now = util::cycle_clock::now();
+      while (c.in_flight.size() < options.pipeline && c.next < total) {
+        const auto index = k + (c.next % share(k)) * num_connections;
+        util::append_request(c.out, queries[index].operation, queries[index].word);
+        c.in_flight.emplace_back(index, now);
+        ++c.next;
+      }
+      while (c.out_begin < c.out.size()) {
+        const auto sent = ::send(c.fd, c.out.data() + c.out_begin, c.out.size() - c.out_begin, MSG_NOSIGNAL);
+        if (sent < 0) {
+          if (errno != EAGAIN && errno != EINTR) {
+            std::cerr << "Error: server closed the connection" << std::endl;
+            std::exit(1);
+          }
+          break;
+        }
+        c.out_begin += static_cast<std::size_t>(sent);
+      }
+      if (c.out_begin == c.out.size()) {
+        c.out.clear();
+        c.out_begin = 0;
+      }
+
+      epoll_event event{};
+      event.events = EPOLLIN | (c.out.empty() ? 0u : std::uint32_t{ EPOLLOUT });
+      event.data.u64 = k;
+      epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &event);
+      if (c.next == total && c.in_flight.empty() && c.fd >= 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+        c.fd = -1;
+        --open;
+      }
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  ::close(epoll_fd);
+
+  const auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  const auto requests = latency.count();
+  const auto ns = util::cycle_clock::ns_per_tick();
+  const auto to_us = [ns](std::uint64_t ticks) { return static_cast<double>(ticks) * ns / 1000.0; };
+  std::cout << "LOADGEN requests=" << requests << " connections=" << num_connections << " pipeline=" << options.pipeline << " time_ms=" << time_ms
+            << " throughput=" << static_cast<std::uint64_t>(static_cast<double>(requests) * 1000.0 / static_cast<double>(time_ms > 0 ? time_ms : 1))
+            << " p50_us=" << to_us(latency.percentile(0.5)) << " p99_us=" << to_us(latency.percentile(0.99)) << " max_us=" << to_us(latency.max()) << std::endl;
+
+  // with one connection and no repetition the answers match the result file of a batch run,
+  // except for words too long to be sent
+  if (!options.results_path.empty()) {
+    auto results = std::ofstream{ options.results_path };
+    if (!results) {
+      std::cerr << "Error opening " << options.results_path << std::endl;
+      std::exit(1);
+    }
+    for (const auto answer : answers)
+      results << (answer ? "true\n" : "false\n");
+  }
+}
+#else
+int
+main(int argc, char** argv)
+{
+  parse_options(argc, argv);
+  std::cerr << "ti_loadgen needs epoll and Unix domain sockets (Linux)" << std::endl;
+  return 1;
+}
+#endif
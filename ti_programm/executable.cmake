@@ -1,4 +1,5 @@
-target_link_libraries(${TARGET_NAME} PRIVATE tries)
+find_package(Threads REQUIRED)
+target_link_libraries(${TARGET_NAME} PRIVATE tries Threads::Threads)
 
 # message("${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${TARGET_NAME} -variant=1 ${TARGET_DIR}/eingabe.txt ${TARGET_DIR}/queries.txt")
 # message("${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/${TARGET_NAME} -variant=2 ${TARGET_DIR}/eingabe.txt ${TARGET_DIR}/queries.txt")
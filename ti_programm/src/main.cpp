@@ -1,17 +1,32 @@
 #include <array_trie.hpp>
+#include <durable_trie.hpp>
 #include <hash_trie.hpp>
+#include <latency_histogram.hpp>
+#include <query_engine.hpp>
 #include <trie_adapter.hpp>
+#include <trie_stats.hpp>
 #include <vector_trie.hpp>
 
-#include <cctype>   // for std::isalnum
-#include <chrono>   // for std::chrono::high_resolution_clock, etc.
-#include <cstdlib>  // for std::exit
-#include <fstream>  // for std::ifstream, std::ofstream
-#include <iostream> // for std::cout, std::cerr, std::endl
-#include <memory>   // for std::unique_ptr, std::make_unique
-#include <string>   // for std::string
-#include <utility>  // for std::pair
-#include <vector>   // for std::vector
+#include <chrono>       // for std::chrono::high_resolution_clock, etc.
+#include <cstdlib>      // for std::exit
+#include <filesystem>   // for std::filesystem::path, std::filesystem::temp_directory_path
+#include <fstream>      // for std::ifstream, std::ofstream
+#include <functional>   // for std::function
+#include <iostream>     // for std::cout, std::cerr, std::endl
+#include <memory>       // for std::unique_ptr, std::make_unique
+#include <optional>     // for std::optional
+#include <string>       // for std::string, std::to_string
+#include <system_error> // for std::error_code
+#include <utility>      // for std::pair, std::move
+#include <variant>      // for std::variant, std::visit
+#include <vector>       // for std::vector
+
+#include "pipeline.hpp"
+#include "server.hpp"
+#include "sorted_runs.hpp"
+#include "spill_merge.hpp"
+#include "static_variants.hpp"
+#include "variant_selection.hpp"
 
 inline auto
 timestamp()
@@ -25,6 +40,118 @@ millis(auto time_difference)
   return std::chrono::duration_cast<std::chrono::milliseconds>(time_difference).count();
 }
 
+struct Options
+{
+  std::string variant_param;
+  std::string input_path;
+  std::string query_path;
+  std::string serve_path;   // Unix socket served instead of a query file, empty for batch mode
+  std::string latency_path; // empty if per-operation latencies are not recorded
+  std::string durable_path; // empty if mutations are not persisted
+  std::size_t wal_batch = 64;
+  std::size_t checkpoint_every = 1'000'000;
+  bool static_variants = false; // also build and report the read-only dictionaries
+  std::size_t sorted_runs = 0;  // queries per run executed in key order, 0 for file order
+  bool stats = false;           // report the shape of the trie and the trace counters of the queries
+  double memory_budget_mb = 0;  // upper bound for the trie after construction, 0 for none
+  std::string cost_model_path;  // calibration of -variant_value=auto, empty for the built-in one
+  double build_budget_mb = 0;   // input strings held during construction, 0 to read the whole input first
+  std::string spill_dir;        // directory for the sorted runs, empty for the system temp directory
+};
+
+[[noreturn]] void
+usage()
+{
+  std::cerr << "Usage: ti_programm -variant_value=<1|2|3|auto> <eingabe_datei> <query_datei> [-latency=<csv_datei>]\n"
+               "                   [-durable=<verzeichnis> [-wal_batch=<n>] [-checkpoint_every=<n>]] [-static_variants] [-sorted_runs=<n>]\n"
+               "                   [-stats] [-memory_budget_mb=<n>] [-cost_model=<csv_datei>] [-build_budget_mb=<n> [-spill_dir=<verzeichnis>]]\n"
+               "       ti_programm -variant_value=<1|2|3|auto> <eingabe_datei> -serve=<socket> [-durable=<verzeichnis> ... | -sorted_runs=<n>] [-stats]\n"
+               "                   [-memory_budget_mb=<n>] [-cost_model=<csv_datei>] [-build_budget_mb=<n> [-spill_dir=<verzeichnis>]]"
+            << std::endl;
+  std::exit(1);
+}
+
+Options
+parse_options(int argc, char** argv)
+{
+  auto options = Options{};
+  auto positional = std::vector<std::string>{};
+  for (int i = 1; i < argc; ++i) {
+    const auto arg = std::string{ argv[i] };
+    if (arg.size() < 2 || arg.front() != '-') {
+      positional.push_back(arg);
+      continue;
+    }
+    const auto eq = arg.find('=');
+    const auto name = arg.substr(1, eq == std::string::npos ? std::string::npos : eq - 1);
+    const auto value = eq == std::string::npos ? std::string{} : arg.substr(eq + 1);
+    if (name == "variant_value" || name == "variant")
+      options.variant_param = arg;
+    else if (name == "latency" && !value.empty())
+      options.latency_path = value;
+    else if (name == "durable" && !value.empty())
+      options.durable_path = value;
+    else if (name == "wal_batch" && !value.empty())
+      options.wal_batch = std::stoull(value);
+    else if (name == "checkpoint_every" && !value.empty())
+      options.checkpoint_every = std::stoull(value);
+    else if (name == "static_variants" && eq == std::string::npos)
+      options.static_variants = true;
+    else if (name == "sorted_runs" && !value.empty())
+      options.sorted_runs = std::stoull(value);
+    else if (name == "serve" && !value.empty())
+      options.serve_path = value;
+    else if (name == "stats" && eq == std::string::npos)
+      options.stats = true;
+    else if (name == "memory_budget_mb" && !value.empty())
+      options.memory_budget_mb = std::stod(value);
+    else if (name == "cost_model" && !value.empty())
+      options.cost_model_path = value;
+    else if (name == "build_budget_mb" && !value.empty())
+      options.build_budget_mb = std::stod(value);
+    else if (name == "spill_dir" && !value.empty())
+      options.spill_dir = value;
+    else
+      usage();
+  }
+  // the server replaces the query file
+  if (options.variant_param.empty() || positional.size() != (options.serve_path.empty() ? 2u : 1u))
+    usage();
+  if (!options.serve_path.empty() && !options.latency_path.empty())
+    usage();
+  // sorted runs need the concrete trie and execute a whole run at once
+  if (options.sorted_runs && (!options.durable_path.empty() || !options.latency_path.empty()))
+    usage();
+  // auto samples the whole input before the construction
+  if (options.build_budget_mb > 0 && options.variant_param.ends_with("=auto"))
+    usage();
+  options.input_path = positional[0];
+  if (options.serve_path.empty())
+    options.query_path = positional[1];
+  return options;
+}
+
+std::vector<std::string>
+read_input_words(const std::string& input_path)
+{
+  auto input_words = std::vector<std::string>{};
+  auto input_stream = std::ifstream{ input_path };
+
+  if (!input_stream) {
+    std::cerr << "Error opening " << input_path << std::endl;
+    std::exit(1);
+  }
+
+  std::string line;
+  while (std::getline(input_stream, line)) {
+    trim_back(line);
+    if (line.empty())
+      continue;
+    input_words.push_back(line);
+  }
+  return input_words;
+}
+
 std::pair<std::string, std::string>
 split_filename(const std::string& path)
 {
@@ -34,34 +161,136 @@ split_filename(const std::string& path)
   return { ".", path.substr(0, path.size()) };
 }
 
+// STATS lines: words, nodes and memory of the trie by depth and its fanout histogram, and in a
+// TRIES_TRACE build what the queries did to it
+void
+report_stats(const TrieStats& stats)
+{
+  const auto list = [](const std::vector<std::size_t>& values) {
+    std::string joined;
+    for (const auto value : values)
+      joined += (joined.empty() ? "" : ",") + std::to_string(value);
+    return joined;
+  };
+  std::cout << "STATS words=" << stats.words << " nodes=" << stats.nodes() << " height=" << stats.height()
+            << " memory=" << static_cast<double>(stats.bytes()) / 1048576.0 << " trace=" << util::TraceEnabled;
+  if constexpr (util::TraceEnabled) {
+    const auto& trace = stats.trace;
+    std::cout << " operations=" << trace.operations << " nodes_per_op=" << trace.per_operation(trace.nodes_visited) << " allocations=" << trace.allocations
+              << " frees=" << trace.frees << " probes_per_search=" << trace.probes_per_search() << " prunes=" << trace.prunes
+              << " prune_depth=" << trace.prune_depth();
+  }
+  std::cout << std::endl;
+  std::cout << "STATS_DEPTH nodes=" << list(stats.nodes_per_depth) << " bytes=" << list(stats.bytes_per_depth) << std::endl;
+  std::cout << "STATS_FANOUT nodes=" << list(stats.fanout) << std::endl;
+}
+
+// Type-erased access to the DurableTrie behind a TrieInterface.
+struct DurableHooks
+{
+  std::function<bool(DurableRecoveryInfo&)> open;
+  std::function<bool(const std::string&)> insert_unlogged;
+  std::function<bool()> checkpoint;
+  std::function<bool()> flush; // syncs the pending records, false if any log or snapshot write failed
+};
+
+// The trie behind the TrieInterface, for the QueryEngine instantiated per type
+using ConcreteTrie = std::variant<VectorTrie*, ArrayTrie*, HashTrie*, DurableTrie<VectorTrie>*, DurableTrie<ArrayTrie>*, DurableTrie<HashTrie>*>;
+
+template<typename T>
+std::unique_ptr<TrieInterface>
+make_durable_trie(const Options& options, DurableHooks& hooks, ConcreteTrie& concrete)
+{
+  auto trie = std::make_unique<TrieAdapter<DurableTrie<T>>>(options.durable_path, options.wal_batch, options.checkpoint_every);
+  auto& durable = trie->get();
+  concrete = &durable;
+  hooks.open = [&durable](DurableRecoveryInfo& info) { return durable.open(&info); };
+  hooks.insert_unlogged = [&durable](const std::string& word) { return durable.unlogged().insert(word); };
+  hooks.checkpoint = [&durable] { return durable.checkpoint(); };
+  hooks.flush = [&durable] { return durable.sync() && durable.good(); };
+  return trie;
+}
+
+using RunExecutor = std::function<void(const QueryBatch&, std::string&)>;
+
+template<typename T>
+RunExecutor
+make_sorted_runs(const Options& options, TrieInterface& trie, const std::size_t& initial_words)
+{
+  if (!options.sorted_runs)
+    return {};
+  return SortedRunExecutor<T>(static_cast<TrieAdapter<T>&>(trie).get(), initial_words);
+}
+
+template<typename T>
+std::unique_ptr<TrieInterface>
+make_trie(const Options& options, DurableHooks& hooks, ConcreteTrie& concrete)
+{
+  if (!options.durable_path.empty())
+    return make_durable_trie<T>(options, hooks, concrete);
+  auto trie = std::make_unique<TrieAdapter<T>>();
+  concrete = &trie->get();
+  return trie;
+}
+
+// -variant_value=auto: the variant_value with the least estimated time within the memory budget
 int
-main(int argc, char** argv)
+choose_auto_variant(const Options& options, const std::vector<std::string>& input_words)
 {
-  if (argc != 4) {
-    std::cerr << "Usage: ti_programm -variant_value=<1|2|3> <eingabe_datei> "
-                 "<query_datei>"
-              << std::endl;
+  auto model = CostModel{};
+  if (!options.cost_model_path.empty()) {
+    auto stream = std::ifstream{ options.cost_model_path };
+    if (!stream || !model.readCsv(stream)) {
+      std::cerr << "Error reading cost model " << options.cost_model_path << std::endl;
+      std::exit(1);
+    }
+  }
+  const auto variant_value = select_variant(sample_workload(input_words, options.query_path), model, options.memory_budget_mb * 1048576.0);
+  if (!variant_value) {
+    std::cerr << "No variant fits into the memory budget of " << options.memory_budget_mb << " MB" << std::endl;
     std::exit(1);
   }
+  return variant_value;
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto options = parse_options(argc, argv);
+  const auto& input_path = options.input_path;
+  const auto& query_path = options.query_path;
 
-  const auto variant_param = std::string{ argv[1] };
-  const auto variant_value = variant_param.back() - '0';
-  const auto input_path = std::string{ argv[2] };
-  const auto query_path = std::string{ argv[3] };
+  // auto reads the input before choosing, the construction reuses the words
+  auto input_words = std::vector<std::string>{};
+  auto time_selection_ms = 0L;
+  auto variant_value = options.variant_param.back() - '0';
+  if (options.variant_param.ends_with("=auto")) {
+    const auto start_selection = timestamp();
+    input_words = read_input_words(input_path);
+    variant_value = choose_auto_variant(options, input_words);
+    time_selection_ms = millis(timestamp() - start_selection);
+  }
 
   std::unique_ptr<TrieInterface> trie;
+  ConcreteTrie concrete;
   std::string variant_name;
+  DurableHooks durable;
+  RunExecutor sorted_runs;
+  std::size_t num_words = 0; // words inserted during construction
   switch (variant_value) {
     case 1:
-      trie = std::make_unique<TrieAdapter<VectorTrie>>();
+      trie = make_trie<VectorTrie>(options, durable, concrete);
+      sorted_runs = make_sorted_runs<VectorTrie>(options, *trie, num_words);
       variant_name = "vector_trie";
       break;
     case 2:
-      trie = std::make_unique<TrieAdapter<ArrayTrie>>();
+      trie = make_trie<ArrayTrie>(options, durable, concrete);
+      sorted_runs = make_sorted_runs<ArrayTrie>(options, *trie, num_words);
       variant_name = "array_trie";
       break;
     case 3:
-      trie = std::make_unique<TrieAdapter<HashTrie>>();
+      trie = make_trie<HashTrie>(options, durable, concrete);
+      sorted_runs = make_sorted_runs<HashTrie>(options, *trie, num_words);
       variant_name = "hash_trie";
       break;
     default:
@@ -69,90 +298,201 @@ main(int argc, char** argv)
       std::exit(1);
   }
 
-  auto input_words = std::vector<std::string>{};
-  auto input_stream = std::ifstream{ input_path };
-
-  if (!input_stream) {
-    std::cerr << "Error opening " << input_path << std::endl;
+  // a durable trie restarts from its snapshot and log tail instead of the input file
+  auto recovery = DurableRecoveryInfo{};
+  const auto start_recovery = timestamp();
+  if (durable.open && !durable.open(recovery)) {
+    std::cerr << "Error recovering from " << options.durable_path << std::endl;
     std::exit(1);
   }
+  const auto end_recovery = timestamp();
+  auto time_construction_ms = time_selection_ms + millis(end_recovery - start_recovery);
+  auto time_read_ms = 0L; // reading the whole input before the construction
+  auto spill = SpillStats{};
 
-  std::string line;
-  while (std::getline(input_stream, line)) {
-    while (!line.empty() && !std::isalnum(line.back()))
-      line.pop_back();
-    if (line.empty())
-      continue;
-    input_words.push_back(line);
-  }
-
-  const auto start_construction = timestamp();
-  for (auto& w : input_words) {
-    if (!trie->insert(w)) {
+  if (!recovery.recovered) {
+    const auto try_insert = [&](const std::string& w) { return durable.insert_unlogged ? durable.insert_unlogged(w) : trie->insert(w); };
+    const auto insert_failed = [](const std::string& w) {
       std::cerr << "Error inserting " << w << std::endl;
       std::exit(1);
+    };
+
+    if (input_words.empty() && options.build_budget_mb <= 0) {
+      const auto start_read = timestamp();
+      input_words = read_input_words(input_path);
+      time_read_ms = millis(timestamp() - start_read);
+    }
+
+    const auto start_construction = timestamp();
+    if (options.build_budget_mb > 0) {
+      // the reading overlaps the construction and is part of its time
+      std::error_code error;
+      auto spill_dir = options.spill_dir.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path{ options.spill_dir };
+      if (error)
+        spill_dir = ".";
+      // the builder goes out of scope and removes its runs before an error exits
+      auto failed_word = std::optional<std::string>{};
+      auto run_directory = std::filesystem::path{};
+      auto built = false;
+      {
+        auto builder = SpillMergeBuilder(spill_dir, static_cast<std::size_t>(options.build_budget_mb * 1048576.0));
+        built = builder.build(input_path, [&](const std::string& w) {
+          if (!try_insert(w))
+            failed_word = w;
+          return !failed_word;
+        });
+        run_directory = builder.spill_directory();
+        spill = builder.stats();
+      }
+      if (failed_word)
+        insert_failed(*failed_word);
+      if (!built) {
+        std::cerr << "Error building from " << input_path << " with runs in " << run_directory.string() << std::endl;
+        std::exit(1);
+      }
+      num_words = spill.words;
+    } else {
+      for (auto& w : input_words)
+        if (!try_insert(w))
+          insert_failed(w);
+      num_words = input_words.size();
     }
+    // the initial snapshot replaces logging every input word
+    if (durable.checkpoint && !durable.checkpoint()) {
+      std::cerr << "Error writing snapshot to " << options.durable_path << std::endl;
+      std::exit(1);
+    }
+    const auto end_construction = timestamp();
+    time_construction_ms += millis(end_construction - start_construction);
   }
-  const auto end_construction = timestamp();
-  const auto time_construction_ms = millis(end_construction - start_construction);
+  const auto build_peak_rss = peak_rss_mb();
+  const auto report_build = [&] {
+    std::cout << "BUILD mode=" << (options.build_budget_mb > 0 ? "spill_merge" : "in_memory") << " build_time=" << time_read_ms + time_construction_ms
+              << " peak_rss=" << build_peak_rss << " runs=" << spill.runs << " merge_passes=" << spill.merge_passes
+              << " spilled=" << static_cast<double>(spill.spilled_bytes) / 1048576.0 << std::endl;
+  };
 
   auto memory_peak = static_cast<double>(trie->size()) / 1048576.0;
-
-  auto queries = std::vector<std::pair<std::string, char>>{};
-  auto query_stream = std::ifstream{ query_path };
-
-  if (!query_stream) {
-    std::cerr << "Error opening " << query_path << std::endl;
+  if (options.memory_budget_mb > 0 && memory_peak > options.memory_budget_mb) {
+    std::cerr << "The " << variant_name << " needs " << memory_peak << " MB, over the memory budget of " << options.memory_budget_mb << " MB" << std::endl;
     std::exit(1);
   }
+  // the trace counters cover the queries only
+  util::reset_trace();
 
-  while (std::getline(query_stream, line)) {
-    while (!line.empty() && !std::isalnum(line.back()))
-      line.pop_back();
-    if (line.empty())
-      continue;
+  const auto execute = [&trie](const std::string& word, char operation) {
+    switch (operation) {
+      case 'c':
+        return trie->contains(word);
+      case 'i':
+        return trie->insert(word);
+      case 'd':
+        return trie->remove(word);
+      default:
+        return false;
+    }
+  };
 
-    char operation = line.back();
-    line.pop_back();
+  auto latency = LatencyRecorder{};
+  const auto record_latency = !options.latency_path.empty();
 
-    while (!line.empty() && !std::isalnum(line.back()))
-      line.pop_back();
-    if (line.empty())
-      continue;
+  // mutations that did not reach the log must not be reported as done
+  const auto check_durable = [&] {
+    if (durable.flush && !durable.flush()) {
+      std::cerr << "Error writing the log or a snapshot to " << options.durable_path << std::endl;
+      std::exit(1);
+    }
+  };
+
+  if (!options.serve_path.empty()) {
+    std::cout << "SERVE socket=" << options.serve_path << " trie_variant=" << variant_name << " trie_construction_time=" << time_construction_ms
+              << " trie_construction_memory=" << memory_peak << std::endl;
+    auto stats = ServerStats{};
+    const auto start_serve = timestamp();
+    const auto served = sorted_runs ? serve(options.serve_path, stats, sorted_runs)
+                                    : std::visit([&](auto* concrete_trie) { return serve(options.serve_path, stats, QueryEngine(*concrete_trie)); }, concrete);
+    if (!served) {
+      std::cerr << "Error serving on " << options.serve_path << std::endl;
+      std::exit(1);
+    }
+    check_durable();
+    std::cout << "SERVE connections=" << stats.connections << " requests=" << stats.requests << " batches=" << stats.batches
+              << " serve_time=" << millis(timestamp() - start_serve) << std::endl;
+    if (options.stats || options.build_budget_mb > 0)
+      report_build();
+    if (options.stats)
+      report_stats(trie->stats());
+  } else {
+    auto query_stream = std::ifstream{ query_path, std::ios::binary };
+
+    if (!query_stream) {
+      std::cerr << "Error opening " << query_path << std::endl;
+      std::exit(1);
+    }
 
-    queries.emplace_back(line, operation);
+    const auto [input_dir, input_filename] = split_filename(input_path);
+    const auto result_path = std::string{ "./result_" + input_filename };
+    auto result_file = OutputFile{ result_path };
+
+    if (!result_file.is_open()) {
+      std::cerr << "Error opening " << result_path << std::endl;
+      std::exit(1);
+    }
+
+    // parsing, execution and writing of the results overlap, so the query time covers all three
+    const auto start_queries = timestamp();
+    if (record_latency) {
+      run_query_pipeline(query_stream, result_file, [&](const std::string& word, char operation) {
+        // remove does not report presence, it is looked up outside the timed region
+        const bool present = operation == 'd' && trie->contains(word);
+        const auto start = util::cycle_clock::now();
+        const bool res = execute(word, operation);
+        const auto end = util::cycle_clock::now();
+        if (operation == 'i')
+          latency.record(LatencyRecorder::Insert, !res, end - start);
+        else if (operation == 'c')
+          latency.record(LatencyRecorder::Contains, res, end - start);
+        else if (operation == 'd')
+          latency.record(LatencyRecorder::Remove, present, end - start);
+        return res;
+      });
+    } else if (sorted_runs) {
+      run_query_batches(query_stream, result_file, options.sorted_runs, sorted_runs);
+    } else {
+      std::visit([&](auto* concrete_trie) { run_query_batches(query_stream, result_file, 4096, QueryEngine(*concrete_trie)); }, concrete);
+    }
+    const auto end_queries = timestamp();
+    const auto time_queries_ms = millis(end_queries - start_queries);
+    check_durable();
+    result_file.flush();
+    if (!result_file.good()) {
+      std::cerr << "Error writing " << result_path << std::endl;
+      std::exit(1);
+    }
+
+    std::cout << "RESULT name=Robert trie_variant=" << variant_name << " trie_construction_time=" << time_construction_ms
+              << " trie_construction_memory=" << memory_peak << " query_time=" << time_queries_ms << std::endl;
+    if (options.stats || options.build_budget_mb > 0)
+      report_build();
+    if (options.stats)
+      report_stats(trie->stats());
   }
 
-  const auto [input_dir, input_filename] = split_filename(input_path);
-  const auto result_path = std::string{ "./result_" + input_filename };
-  auto result_stream = std::ofstream{ result_path };
+  if (options.static_variants)
+    report_static_variants(input_words.empty() ? read_input_words(input_path) : std::move(input_words));
 
-  if (!result_stream) {
-    std::cerr << "Error opening " << result_path << std::endl;
-    std::exit(1);
+  if (durable.open) {
+    std::cout << "DURABLE recovered=" << recovery.recovered << " snapshot_words=" << recovery.snapshot_words << " wal_records=" << recovery.wal_records
+              << " recovery_time=" << millis(end_recovery - start_recovery) << std::endl;
   }
 
-  const auto start_queries = timestamp();
-  for (const auto& [word, operation] : queries) {
-    bool res = false;
-    switch (operation) {
-      case 'c':
-        res = trie->contains(word);
-        break;
-      case 'i':
-        res = trie->insert(word);
-        break;
-      case 'd':
-        res = trie->remove(word);
-        break;
-      default:
-        break;
+  if (record_latency) {
+    auto latency_stream = std::ofstream{ options.latency_path };
+    if (!latency_stream) {
+      std::cerr << "Error opening " << options.latency_path << std::endl;
+      std::exit(1);
     }
-    result_stream << (res ? "true\n" : "false\n");
+    LatencyRecorder::writeCsvHeader(latency_stream, "variant");
+    latency.writeCsv(latency_stream, variant_name);
   }
-  const auto end_queries = timestamp();
-  const auto time_queries_ms = millis(end_queries - start_queries);
-
-  std::cout << "RESULT name=Robert trie_variant=" << variant_name << " trie_construction_time=" << time_construction_ms
-            << " trie_construction_memory=" << memory_peak << " query_time=" << time_queries_ms << std::endl;
 }
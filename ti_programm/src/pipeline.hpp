@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>     // for std::size_t
+#include <fstream>     // for std::ifstream
+#include <string>      // for std::string
+#include <string_view> // for std::string_view
+#include <thread>      // for std::thread
+#include <utility>     // for std::as_const, std::move
+#include <vector>      // for std::vector
+
+#if defined(_WIN32)
+#include <fcntl.h>    // for _O_WRONLY, _O_CREAT, _O_TRUNC, _O_TEXT
+#include <io.h>       // for _open, _write, _close
+#include <sys/stat.h> // for _S_IREAD, _S_IWRITE
+#else
+#include <cerrno>   // for errno, EINTR
+#include <fcntl.h>  // for open, O_WRONLY, O_CREAT, O_TRUNC
+#include <unistd.h> // for write, close
+#endif
+
+#include <query_protocol.hpp>
+
+#include "spsc_ring.hpp"
+
+// Result file written through large unbuffered write() calls.
+class OutputFile
+{
+private:
+  static constexpr std::size_t BufferSize = std::size_t{ 1 } << 20;
+
+  int fd = -1;
+  std::string buffer;
+  bool failed = false; // a write failed or was short, results are missing from the file
+
+  bool writeAll(const char* data, std::size_t size)
+  {
+    while (size) {
+#if defined(_WIN32)
+      const auto written = _write(fd, data, static_cast<unsigned>(size));
+#else
+      const auto written = ::write(fd, data, size);
+      if (written < 0 && errno == EINTR)
+        continue;
+#endif
+      if (written <= 0)
+        return false;
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    }
+    return true;
+  }
+
+public:
+  explicit OutputFile(const std::string& path)
+  {
+#if defined(_WIN32)
+    // text mode keeps the line endings of the former std::ofstream output
+    fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_TEXT, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    buffer.reserve(BufferSize);
+  }
+
+  OutputFile(const OutputFile&) = delete;
+  OutputFile& operator=(const OutputFile&) = delete;
+
+  ~OutputFile()
+  {
+    flush();
+#if defined(_WIN32)
+    if (fd >= 0)
+      _close(fd);
+#else
+    if (fd >= 0)
+      ::close(fd);
+#endif
+  }
+
+  [[nodiscard]] bool is_open() const { return fd >= 0; }
+
+  // Every result appended and flushed so far reached the file
+  [[nodiscard]] bool good() const { return fd >= 0 && !failed; }
+
+  void append(std::string_view data)
+  {
+    if (buffer.size() + data.size() > BufferSize)
+      flush();
+    if (data.size() >= BufferSize)
+      failed = !writeAll(data.data(), data.size()) || failed;
+    else
+      buffer.append(data);
+  }
+
+  void flush()
+  {
+    if (fd >= 0 && !buffer.empty())
+      failed = !writeAll(buffer.data(), buffer.size()) || failed;
+    buffer.clear();
+  }
+};
+
+// Streams the queries through three stages connected by bounded SPSC rings:
+// a reader thread parsing the query file in batches of batch_size queries, the calling
+// thread passing each batch to execute_batch(batch, results), which appends one result
+// line per query, and a writer thread writing the formatted results.
+// Memory stays bounded by the ring capacities instead of the query file size.
+template<typename ExecuteBatch>
+void
+run_query_batches(std::ifstream& query_stream, OutputFile& output, std::size_t batch_size, ExecuteBatch&& execute_batch)
+{
+  constexpr std::size_t RingCapacity = 64;
+  constexpr std::size_t ChunkSize = std::size_t{ 1 } << 20;
+
+  SpscRing<QueryBatch> query_ring(RingCapacity);
+  SpscRing<std::string> result_ring(RingCapacity);
+
+  std::thread reader([&query_stream, &query_ring, batch_size] {
+    auto chunk = std::vector<char>(ChunkSize);
+    auto batch = QueryBatch{};
+    auto line = std::string{};
+    batch.reserve(batch_size);
+
+    const auto emit = [&] {
+      char operation = 0;
+      if (parse_query(line, operation))
+        batch.push_back({ std::move(line), operation });
+      line.clear();
+      if (batch.size() == batch_size) {
+        query_ring.push(std::move(batch));
+        batch = QueryBatch{};
+        batch.reserve(batch_size);
+      }
+    };
+
+    while (query_stream) {
+      query_stream.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      const auto count = static_cast<std::size_t>(query_stream.gcount());
+      std::size_t begin = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        if (chunk[i] == '\n') {
+          line.append(chunk.data() + begin, i - begin);
+          emit();
+          begin = i + 1;
+        }
+      }
+      line.append(chunk.data() + begin, count - begin);
+    }
+    if (!line.empty())
+      emit();
+    if (!batch.empty())
+      query_ring.push(std::move(batch));
+    query_ring.close();
+  });
+
+  std::thread writer([&output, &result_ring] {
+    auto results = std::string{};
+    while (result_ring.pop(results))
+      output.append(results);
+    output.flush();
+  });
+
+  auto batch = QueryBatch{};
+  while (query_ring.pop(batch)) {
+    auto results = std::string{};
+    results.reserve(batch.size() * 6);
+    execute_batch(std::as_const(batch), results);
+    result_ring.push(std::move(results));
+  }
+  result_ring.close();
+
+  reader.join();
+  writer.join();
+}
+
+// run_query_batches executing the queries one by one and in order
+template<typename Execute>
+void
+run_query_pipeline(std::ifstream& query_stream, OutputFile& output, Execute&& execute)
+{
+  run_query_batches(query_stream, output, 4096, [&execute](const QueryBatch& batch, std::string& results) {
+    for (const auto& [word, operation] : batch)
+      results += execute(word, operation) ? "true\n" : "false\n";
+  });
+}
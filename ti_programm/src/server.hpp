@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint32_t
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <unordered_map> // for std::unordered_map
+#include <utility>       // for std::as_const, std::pair
+#include <vector>        // for std::vector
+
+#if defined(__linux__)
+#include <cerrno>         // for errno, EAGAIN, EINTR
+#include <csignal>        // for sigset_t, sigemptyset, sigaddset, SIGINT, SIGTERM
+#include <cstring>        // for std::memcpy
+#include <signal.h>       // for sigprocmask
+#include <sys/epoll.h>    // for epoll_create1, epoll_ctl, epoll_wait
+#include <sys/signalfd.h> // for signalfd, signalfd_siginfo
+#include <sys/socket.h>   // for socket, bind, listen, accept4, recv, send
+#include <sys/un.h>       // for sockaddr_un
+#include <unistd.h>       // for close, read, unlink
+#endif
+
+#include <query_protocol.hpp>
+
+#include "pipeline.hpp"
+
+struct ServerStats
+{
+  std::size_t connections = 0;
+  std::size_t requests = 0;
+  std::size_t batches = 0;
+};
+
+#if defined(__linux__)
+// Resident query server on a Unix domain socket, framed as in query_protocol.hpp.
+//
+// One thread multiplexes all connections with level-triggered epoll. Every round of ready
+// events reads what the sockets hold, collects the complete requests of all connections into
+// one QueryBatch and executes it at once through execute_batch(batch, results), which appends
+// one result line per query like for run_query_batches. Then every connection gets its
+// answers. A connection with more than OutputLimit unsent answers is not read until they
+// drain. A client that shuts down its sending side still receives all answers.
+// Runs until SIGINT or SIGTERM and returns false if the socket cannot be set up.
+template<typename ExecuteBatch>
+bool
+serve(const std::string& socket_path, ServerStats& stats, ExecuteBatch&& execute_batch)
+{
+  constexpr std::size_t ReadChunk = std::size_t{ 1 } << 16;
+  constexpr std::size_t OutputLimit = std::size_t{ 1 } << 22;
+
+  struct Connection
+  {
+    std::string in;
+    std::string out;
+    std::size_t out_begin = 0;
+    std::uint32_t interest = EPOLLIN;
+    bool eof = false;     // the peer finished sending
+    bool invalid = false; // the peer sent an invalid request
+    bool touched = false;
+  };
+
+  sockaddr_un address{};
+  if (socket_path.size() >= sizeof(address.sun_path))
+    return false;
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listener < 0)
+    return false;
+  ::unlink(socket_path.c_str());
+  if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listener, 128) < 0) {
+    ::close(listener);
+    return false;
+  }
+
+  // SIGINT and SIGTERM arrive as readable events instead of interrupting the loop
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  sigprocmask(SIG_BLOCK, &signals, nullptr);
+  const int signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  const auto watch = [epoll_fd](int op, int fd, std::uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    return epoll_ctl(epoll_fd, op, fd, &event) == 0;
+  };
+  if (signal_fd < 0 || epoll_fd < 0 || !watch(EPOLL_CTL_ADD, listener, EPOLLIN) || !watch(EPOLL_CTL_ADD, signal_fd, EPOLLIN)) {
+    ::close(listener);
+    ::unlink(socket_path.c_str());
+    return false;
+  }
+
+  std::unordered_map<int, Connection> connections;
+  std::vector<epoll_event> events(256);
+  std::vector<int> touched;
+  std::vector<int> backlog; // connections with complete requests left over due to OutputLimit
+  std::vector<std::pair<int, std::size_t>> owners; // connection and number of queries in the batch
+  QueryBatch batch;
+  std::string results;
+  std::vector<char> chunk(ReadChunk);
+  bool running = true;
+
+  // false if the connection failed
+  const auto receive = [&chunk](int fd, Connection& connection) {
+    while (true) {
+      const auto n = ::recv(fd, chunk.data(), chunk.size(), 0);
+      if (n > 0) {
+        connection.in.append(chunk.data(), static_cast<std::size_t>(n));
+        continue;
+      }
+      if (n == 0)
+        connection.eof = true;
+      return n == 0 || errno == EAGAIN || errno == EINTR;
+    }
+  };
+  const auto transmit = [](int fd, Connection& connection) {
+    while (connection.out_begin < connection.out.size()) {
+      const auto n = ::send(fd, connection.out.data() + connection.out_begin, connection.out.size() - connection.out_begin, MSG_NOSIGNAL);
+      if (n < 0)
+        return errno == EAGAIN || errno == EINTR;
+      connection.out_begin += static_cast<std::size_t>(n);
+    }
+    connection.out.clear();
+    connection.out_begin = 0;
+    return true;
+  };
+  const auto drop = [&](int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+  };
+
+  const auto touch = [&](int fd, Connection& connection) {
+    if (!connection.touched) {
+      connection.touched = true;
+      touched.push_back(fd);
+    }
+  };
+
+  while (running) {
+    const auto n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), backlog.empty() ? -1 : 0);
+    if (n < 0 && errno != EINTR)
+      break;
+    touched.clear();
+    for (const auto fd : backlog)
+      touch(fd, connections[fd]);
+    backlog.clear();
+    for (int e = 0; e < n; ++e) {
+      const int fd = events[static_cast<std::size_t>(e)].data.fd;
+      const auto ready = events[static_cast<std::size_t>(e)].events;
+      if (fd == signal_fd) {
+        // consume the signal, it would be delivered again once unblocked
+        signalfd_siginfo info{};
+        if (::read(signal_fd, &info, sizeof(info)) == sizeof(info))
+          running = false;
+      } else if (fd == listener) {
+        for (int client; (client = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;) {
+          if (!watch(EPOLL_CTL_ADD, client, EPOLLIN)) {
+            ::close(client);
+            continue;
+          }
+          connections.emplace(client, Connection{});
+          ++stats.connections;
+        }
+      } else if (const auto it = connections.find(fd); it != connections.end()) {
+        auto& connection = it->second;
+        if ((ready & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !connection.eof && !connection.invalid && !receive(fd, connection)) {
+          drop(fd);
+          continue;
+        }
+        touch(fd, connection);
+      }
+    }
+
+    // collect the complete requests of all touched connections into one batch
+    batch.clear();
+    owners.clear();
+    for (const auto fd : touched) {
+      const auto it = connections.find(fd);
+      if (it == connections.end())
+        continue;
+      auto& connection = it->second;
+      std::size_t consumed = 0, count = 0;
+      const auto in = std::string_view{ connection.in };
+      char operation = 0;
+      std::string_view word;
+      while (connection.out.size() - connection.out_begin + count < OutputLimit) {
+        const auto size = util::parse_request(in.substr(consumed), operation, word);
+        if (!size)
+          break;
+        if (!util::valid_operation(operation)) {
+          connection.invalid = true;
+          break;
+        }
+        batch.push_back({ std::string(word), operation });
+        consumed += size;
+        ++count;
+      }
+      connection.in.erase(0, consumed);
+      if (count)
+        owners.emplace_back(fd, count);
+    }
+    if (!batch.empty()) {
+      results.clear();
+      execute_batch(std::as_const(batch), results);
+      stats.requests += batch.size();
+      ++stats.batches;
+      std::size_t line = 0;
+      for (const auto& [fd, count] : owners) {
+        auto& out = connections[fd].out;
+        for (std::size_t i = 0; i < count; ++i) {
+          out.push_back(results[line] == 't' ? '\1' : '\0');
+          line = results.find('\n', line) + 1;
+        }
+      }
+    }
+
+    // send the answers and update what each connection waits for
+    for (const auto fd : touched) {
+      const auto it = connections.find(fd);
+      if (it == connections.end())
+        continue;
+      auto& connection = it->second;
+      connection.touched = false;
+      if (!transmit(fd, connection)) {
+        drop(fd);
+        continue;
+      }
+      const auto pending = connection.out.size() - connection.out_begin;
+      char operation = 0;
+      std::string_view word;
+      const bool more = !connection.invalid && util::parse_request(connection.in, operation, word);
+      if (more && pending < OutputLimit)
+        backlog.push_back(fd);
+      if ((connection.eof || connection.invalid) && !pending && !more) {
+        drop(fd);
+        continue;
+      }
+      const bool reading = !connection.eof && !connection.invalid && pending < OutputLimit;
+      const std::uint32_t interest = (reading ? std::uint32_t{ EPOLLIN } : 0u) | (pending ? std::uint32_t{ EPOLLOUT } : 0u);
+      if (interest != connection.interest && watch(EPOLL_CTL_MOD, fd, interest))
+        connection.interest = interest;
+    }
+  }
+
+  for (const auto& [fd, connection] : connections)
+    ::close(fd);
+  ::close(epoll_fd);
+  ::close(signal_fd);
+  ::close(listener);
+  ::unlink(socket_path.c_str());
+  sigprocmask(SIG_UNBLOCK, &signals, nullptr);
+  return true;
+}
+#else
+// The server needs epoll and Unix domain sockets
+template<typename ExecuteBatch>
+bool
+serve(const std::string&, ServerStats&, ExecuteBatch&&)
+{
+  return false;
+}
+#endif
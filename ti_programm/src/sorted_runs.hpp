@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>   // for std::stable_sort, std::transform
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint32_t
+#include <string>      // for std::string
+#include <type_traits> // for std::is_same_v
+#include <vector>      // for std::vector
+
+#include <array_trie.hpp>
+
+#include "pipeline.hpp"
+
+// Executes a run of queries in key order through a finger, so consecutive queries resume on their
+// common prefix, and appends the results in the original order.
+//
+// The sort is stable and ArrayTrie keys are compared by util::index, so all queries on the same
+// stored word keep their relative order and insert/contains see the same results as in file order.
+// A remove returns true only if the trie is empty afterwards, which depends on every query before
+// it. Its result is therefore derived after the run: whether the word was present (known in key
+// order) and the number of words after it in file order.
+template<typename Trie>
+class SortedRunExecutor
+{
+private:
+  Trie& trie;
+  const std::size_t& initial_words; // words in the trie before the first run
+  std::size_t words = 0;
+  bool started = false;
+  typename Trie::Finger finger;
+  std::vector<std::uint32_t> order;
+  std::vector<char> outcome;        // result, for removes whether the word was present
+  std::vector<int> delta;           // change of the word count
+  std::vector<std::string> symbols; // ArrayTrie keys mapped by util::index
+
+  void sortRun(const QueryBatch& batch)
+  {
+    order.resize(batch.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+      order[i] = static_cast<std::uint32_t>(i);
+    if constexpr (std::is_same_v<Trie, ArrayTrie>) {
+      symbols.resize(batch.size());
+      for (std::size_t i = 0; i < batch.size(); ++i) {
+        symbols[i].resize(batch[i].word.size());
+        std::transform(batch[i].word.begin(), batch[i].word.end(), symbols[i].begin(), [](char c) { return static_cast<char>(util::index(c)); });
+      }
+      std::stable_sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) { return symbols[a] < symbols[b]; });
+    } else {
+      std::stable_sort(order.begin(), order.end(), [&batch](std::uint32_t a, std::uint32_t b) { return batch[a].word < batch[b].word; });
+    }
+  }
+
+public:
+  SortedRunExecutor(Trie& trie_, const std::size_t& initial_words_)
+    : trie(trie_)
+    , initial_words(initial_words_)
+  {
+  }
+
+  void operator()(const QueryBatch& batch, std::string& results)
+  {
+    if (!started) {
+      words = initial_words;
+      started = true;
+    }
+    sortRun(batch);
+    outcome.assign(batch.size(), 0);
+    delta.assign(batch.size(), 0);
+    for (const auto i : order) {
+      const auto& [word, operation] = batch[i];
+      switch (operation) {
+        case 'c':
+          outcome[i] = trie.contains(word, finger);
+          break;
+        case 'i':
+          outcome[i] = trie.insert(word, finger);
+          delta[i] = outcome[i];
+          break;
+        case 'd':
+          outcome[i] = trie.contains(word, finger);
+          trie.remove(word, finger);
+          delta[i] = -outcome[i];
+          break;
+        default:
+          break;
+      }
+    }
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      if (delta[i] > 0)
+        ++words;
+      else if (delta[i] < 0)
+        --words;
+      const bool res = batch[i].operation == 'd' ? outcome[i] && words == 0 : outcome[i];
+      results += res ? "true\n" : "false\n";
+    }
+  }
+};
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>    // for std::sort, std::make_heap, std::push_heap, std::pop_heap, std::none_of
+#include <chrono>       // for std::chrono::steady_clock
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <cstdio>       // for std::FILE, std::fopen, std::fwrite, std::fread, std::fclose, std::ferror
+#include <filesystem>   // for std::filesystem::path, create_directories, remove_all
+#include <fstream>      // for std::ifstream
+#include <functional>   // for std::greater
+#include <memory>       // for std::unique_ptr
+#include <string>       // for std::string, std::getline, std::to_string
+#include <system_error> // for std::error_code
+#include <utility>      // for std::pair, std::move
+#include <vector>       // for std::vector
+
+#if defined(_WIN32)
+// keep the min and max macros of windows.h away from std::min and std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h> // for GetCurrentProcess
+#include <psapi.h>   // for GetProcessMemoryInfo
+#else
+#include <sys/resource.h> // for getrusage
+#endif
+
+#include <query_protocol.hpp>
+#include <varint.hpp>
+
+// Peak resident set size of the process so far in MB, 0 if unknown
+inline double
+peak_rss_mb()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0.0;
+  return static_cast<double>(counters.PeakWorkingSetSize) / 1048576.0;
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+#if defined(__APPLE__)
+  return static_cast<double>(usage.ru_maxrss) / 1048576.0; // bytes
+#else
+  return static_cast<double>(usage.ru_maxrss) / 1024.0; // KiB
+#endif
+#endif
+}
+
+struct SpillStats
+{
+  std::size_t words = 0;         // words handed to insert, duplicates included
+  std::size_t runs = 0;          // sorted runs written to the spill directory
+  std::size_t merge_passes = 0;  // passes over the spilled words, 0 if nothing was spilled
+  std::uint64_t spilled_bytes = 0; // written to runs, merge passes included
+};
+
+// A sorted run: a file of { varint length, bytes }* or the last chunk, which stays in memory
+class RunSource
+{
+private:
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> file{ nullptr, std::fclose };
+  std::vector<std::string>* words = nullptr;
+  std::size_t next_word = 0;
+  bool truncated = false;
+
+public:
+  explicit RunSource(std::vector<std::string>& words_) noexcept
+    : words(&words_)
+  {
+  }
+
+  explicit RunSource(const std::filesystem::path& path)
+    : file(std::fopen(path.string().c_str(), "rb"), std::fclose)
+  {
+  }
+
+  [[nodiscard]] bool is_open() const { return words || file; }
+
+  // The run ended in the middle of a word or could not be read
+  [[nodiscard]] bool failed() const { return truncated || (file && std::ferror(file.get())); }
+
+  // Sets word to the next word of the run, returns false at its end
+  bool next(std::string& word)
+  {
+    if (words) {
+      if (next_word == words->size())
+        return false;
+      word = std::move((*words)[next_word++]);
+      return true;
+    }
+    std::uint64_t length;
+    if (!util::readVarint(file.get(), length))
+      return false;
+    word.resize(length);
+    truncated = std::fread(word.data(), 1, length, file.get()) != length;
+    return !truncated;
+  }
+};
+
+// Streaming construction for input files larger than memory.
+//
+// The input is read in chunks of at most budget_bytes of strings. A full chunk is sorted and
+// spilled to spill_dir as a run; the last chunk stays in memory. The runs are merged with a heap
+// of one word per run (MaxFanIn at a time, further passes if there are more) and the words are
+// passed to insert in ascending order, so only the trie and one chunk are in memory at a time.
+// Duplicate input words are passed as often as they occur, so insert sees them like the in-memory
+// construction does (only in sorted order). Returns false if a run cannot be written or read or
+// insert returns false, which stops the construction.
+class SpillMergeBuilder
+{
+private:
+  static constexpr std::size_t MaxFanIn = 64;
+  static constexpr std::size_t WriteBuffer = 1 << 20;
+
+  std::filesystem::path directory;
+  std::size_t budget_bytes;
+  std::vector<std::filesystem::path> runs;
+  std::size_t next_run = 0;
+  SpillStats stats_;
+
+  std::filesystem::path newRun() { return directory / ("run_" + std::to_string(next_run++)); }
+
+  // Calls emit(word) for the words of sources in ascending order
+  template<typename Emit>
+  static bool merge(std::vector<RunSource>& sources, Emit&& emit)
+  {
+    using Head = std::pair<std::string, std::size_t>;
+    std::vector<Head> heap;
+    for (std::size_t s = 0; s < sources.size(); ++s) {
+      if (!sources[s].is_open())
+        return false;
+      Head head{ std::string{}, s };
+      if (sources[s].next(head.first))
+        heap.push_back(std::move(head));
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<>{});
+
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+      auto& [word, s] = heap.back();
+      if (!emit(word))
+        return false;
+      if (sources[s].next(word))
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+      else
+        heap.pop_back();
+    }
+    return std::none_of(sources.begin(), sources.end(), [](const RunSource& source) { return source.failed(); });
+  }
+
+  bool writeRun(const std::filesystem::path& path, auto&& fill)
+  {
+    auto file = std::unique_ptr<std::FILE, int (*)(std::FILE*)>(std::fopen(path.string().c_str(), "wb"), std::fclose);
+    if (!file)
+      return false;
+    std::string buffer;
+    bool ok = true;
+    const auto flush = [&] {
+      ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file.get()) == buffer.size();
+      stats_.spilled_bytes += buffer.size();
+      buffer.clear();
+    };
+    fill([&](const std::string& word) {
+      util::appendVarint(buffer, word.size());
+      buffer += word;
+      if (buffer.size() >= WriteBuffer)
+        flush();
+      return ok;
+    });
+    flush();
+    ok = std::fflush(file.get()) == 0 && ok;
+    return ok;
+  }
+
+  bool spill(std::vector<std::string>& chunk)
+  {
+    const auto path = newRun();
+    const auto written = writeRun(path, [&chunk](auto&& write) {
+      for (const auto& word : chunk)
+        if (!write(word))
+          return;
+    });
+    runs.push_back(path);
+    ++stats_.runs;
+    return written;
+  }
+
+  // Merges the first runs MaxFanIn at a time into new runs until the rest fits into one pass
+  bool reduceRuns()
+  {
+    while (runs.size() + 1 > MaxFanIn) {
+      ++stats_.merge_passes;
+      std::vector<std::filesystem::path> merged;
+      for (std::size_t begin = 0; begin < runs.size(); begin += MaxFanIn) {
+        const auto end = std::min(runs.size(), begin + MaxFanIn);
+        std::vector<RunSource> sources;
+        for (auto r = begin; r < end; ++r)
+          sources.emplace_back(runs[r]);
+        const auto path = newRun();
+        auto ok = true;
+        const auto written = writeRun(path, [&](auto&& write) { ok = merge(sources, write); });
+        if (!written || !ok)
+          return false;
+        sources.clear();
+        std::error_code error;
+        for (auto r = begin; r < end; ++r)
+          std::filesystem::remove(runs[r], error);
+        merged.push_back(path);
+      }
+      runs = std::move(merged);
+    }
+    return true;
+  }
+
+public:
+  // The runs go into a fresh subdirectory of spill_dir, removed by the destructor
+  SpillMergeBuilder(const std::filesystem::path& spill_dir, std::size_t budget_bytes_)
+    : directory(spill_dir / ("ti_programm_spill_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())))
+    , budget_bytes(budget_bytes_)
+  {
+  }
+
+  SpillMergeBuilder(const SpillMergeBuilder&) = delete;
+  SpillMergeBuilder& operator=(const SpillMergeBuilder&) = delete;
+
+  ~SpillMergeBuilder()
+  {
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+  }
+
+  [[nodiscard]] const std::filesystem::path& spill_directory() const { return directory; }
+
+  [[nodiscard]] const SpillStats& stats() const { return stats_; }
+
+  // Reads the input file like read_input_words and calls insert(word) for its words in ascending
+  // order until it returns false
+  template<typename Insert>
+  bool build(const std::string& input_path, Insert&& insert)
+  {
+    auto input_stream = std::ifstream{ input_path };
+    if (!input_stream)
+      return false;
+
+    std::vector<std::string> chunk;
+    std::size_t chunk_bytes = 0;
+    const auto sortChunk = [&chunk] { std::sort(chunk.begin(), chunk.end()); };
+    std::string line;
+    while (std::getline(input_stream, line)) {
+      trim_back(line);
+      if (line.empty())
+        continue;
+      chunk_bytes += sizeof(std::string) + line.size();
+      chunk.push_back(line);
+      if (chunk_bytes < budget_bytes)
+        continue;
+      if (runs.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+          return false;
+      }
+      sortChunk();
+      if (!spill(chunk))
+        return false;
+      chunk = {};
+      chunk_bytes = 0;
+    }
+    if (input_stream.bad())
+      return false;
+    sortChunk();
+    if (!reduceRuns())
+      return false;
+
+    if (!runs.empty())
+      ++stats_.merge_passes;
+    std::vector<RunSource> sources;
+    for (const auto& run : runs)
+      sources.emplace_back(run);
+    sources.emplace_back(chunk);
+    return merge(sources, [&](const std::string& word) {
+      ++stats_.words;
+      return insert(word);
+    });
+  }
+};
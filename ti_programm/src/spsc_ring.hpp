@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>  // for std::atomic
+#include <bit>     // for std::bit_ceil
+#include <cstddef> // for std::size_t
+#include <thread>  // for std::this_thread::yield
+#include <utility> // for std::move
+#include <vector>  // for std::vector
+
+// Bounded single-producer single-consumer ring buffer.
+// The producer blocks while the ring is full, the consumer while it is empty,
+// until the producer closes the ring after its last push.
+template<typename T>
+class SpscRing
+{
+private:
+  std::vector<T> slots;
+  std::size_t mask;
+
+  // head and tail live on separate cache lines so producer and consumer do not false share
+  alignas(64) std::atomic<std::size_t> head{ 0 }; // next slot to pop
+  alignas(64) std::atomic<std::size_t> tail{ 0 }; // next slot to push
+  alignas(64) std::atomic<bool> closed{ false };
+
+public:
+  explicit SpscRing(std::size_t capacity)
+    : slots(std::bit_ceil(capacity))
+    , mask(slots.size() - 1)
+  {
+  }
+
+  bool try_push(T& value)
+  {
+    const auto t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == slots.size())
+      return false;
+    slots[t & mask] = std::move(value);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  void push(T value)
+  {
+    while (!try_push(value))
+      std::this_thread::yield();
+  }
+
+  bool try_pop(T& value)
+  {
+    const auto h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;
+    value = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // returns false once the ring is closed and drained
+  bool pop(T& value)
+  {
+    while (!try_pop(value)) {
+      if (closed.load(std::memory_order_acquire))
+        return try_pop(value);
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  void close() { closed.store(true, std::memory_order_release); }
+};
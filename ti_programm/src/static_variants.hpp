@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm> // for std::sort, std::unique
+#include <chrono>    // for std::chrono::steady_clock
+#include <iostream>  // for std::cout, std::endl
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#include <dawg.hpp>
+#include <front_coded_dictionary.hpp>
+
+// Builds the read-only dictionary variants from the input words and prints one STATIC line each,
+// next to the RESULT line of the dynamic variant.
+inline void
+report_static_variants(std::vector<std::string> words)
+{
+  const auto start_sort = std::chrono::steady_clock::now();
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  const auto end_sort = std::chrono::steady_clock::now();
+  const auto sort_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_sort - start_sort).count();
+
+  {
+    const auto start = std::chrono::steady_clock::now();
+    auto builder = DawgBuilder{};
+    for (const auto& w : words)
+      builder.add(w);
+    const auto dawg = builder.finish();
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "STATIC name=Robert static_variant=dawg static_construction_time="
+              << sort_ms + std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " static_construction_memory=" << static_cast<double>(dawg.size()) / 1048576.0 << " states=" << dawg.num_states()
+              << " edges=" << dawg.num_edges() << std::endl;
+  }
+
+  {
+    const auto start = std::chrono::steady_clock::now();
+    auto builder = FrontCodedBuilder{};
+    for (const auto& w : words)
+      builder.add(w);
+    const auto dictionary = builder.finish();
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "STATIC name=Robert static_variant=front_coded static_construction_time="
+              << sort_ms + std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " static_construction_memory=" << static_cast<double>(dictionary.size()) / 1048576.0 << " words=" << dictionary.word_count()
+              << " blocks=" << dictionary.num_blocks() << std::endl;
+  }
+}
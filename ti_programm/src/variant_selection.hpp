@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>   // for std::min
+#include <cctype>      // for std::isalnum
+#include <cstddef>     // for std::size_t
+#include <filesystem>  // for std::filesystem::file_size
+#include <fstream>     // for std::ifstream
+#include <iostream>    // for std::cout, std::endl
+#include <string>      // for std::string, std::getline
+#include <string_view> // for std::string_view
+#include <vector>      // for std::vector
+
+#include <cost_model.hpp>
+#include <query_protocol.hpp>
+#include <vector_trie.hpp>
+
+// What -variant_value=auto knows about the input and the queries before building a trie
+struct WorkloadSample
+{
+  std::size_t words = 0;
+  double word_length = 0.0;    // mean length of the input words
+  std::size_t alphabet = 0;    // distinct characters of the input words and the sampled queries
+  bool alphanumeric = true;    // ArrayTrie has distinct children for [0-9A-Za-z] only
+  double nodes = 0.0;          // estimated nodes after the construction
+  double nodes_per_word = 0.0; // new nodes per word at the end of the sample, an upper bound for later words
+  double queries = 0.0;        // estimated number of queries in the query file
+  double query_length = 0.0;   // mean length of the sampled query words
+  bool queries_known = false;  // false in server mode, the mix is then assumed
+  // share of contains, insert and remove
+  double mix[3] = { 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0 };
+};
+
+// Samples up to max_sample words of the input into a VectorTrie for the node estimate and reads
+// up to max_sample queries from the head of the query file (if any) for the read/write mix.
+inline WorkloadSample
+sample_workload(const std::vector<std::string>& words, const std::string& query_path, std::size_t max_sample = 1 << 16)
+{
+  WorkloadSample sample;
+  bool seen[256] = {};
+  const auto see = [&](const std::string& word) {
+    for (const auto c : word) {
+      const auto uc = static_cast<unsigned char>(c);
+      if (!seen[uc]) {
+        seen[uc] = true;
+        ++sample.alphabet;
+        sample.alphanumeric = sample.alphanumeric && std::isalnum(uc);
+      }
+    }
+  };
+
+  // a scan of all words, a single non-alphanumeric character rules out ArrayTrie
+  std::size_t characters = 0;
+  for (const auto& word : words) {
+    see(word);
+    characters += word.size();
+  }
+  sample.words = words.size();
+  sample.word_length = words.empty() ? 0.0 : static_cast<double>(characters) / static_cast<double>(words.size());
+
+  // evenly spaced words, the growth over the second half of the sample is extrapolated
+  const auto count = std::min(words.size(), max_sample);
+  VectorTrie trie;
+  std::size_t half_nodes = 1;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == count / 2)
+      half_nodes = trie.stats().nodes();
+    trie.insert(words[i * words.size() / count]);
+  }
+  const auto sample_nodes = static_cast<double>(trie.stats().nodes());
+  sample.nodes_per_word = count > 1 ? (sample_nodes - static_cast<double>(half_nodes)) / static_cast<double>(count - count / 2) : 0.0;
+  sample.nodes = sample_nodes + static_cast<double>(words.size() - count) * sample.nodes_per_word;
+
+  if (query_path.empty())
+    return sample;
+  auto stream = std::ifstream{ query_path };
+  std::string line;
+  std::size_t lines = 0, bytes = 0, operations[3] = {}, query_characters = 0;
+  while (lines < max_sample && std::getline(stream, line)) {
+    ++lines;
+    bytes += line.size() + 1;
+    char operation;
+    if (!parse_query(line, operation))
+      continue;
+    see(line);
+    query_characters += line.size();
+    if (operation == 'c')
+      ++operations[0];
+    else if (operation == 'i')
+      ++operations[1];
+    else if (operation == 'd')
+      ++operations[2];
+  }
+  const auto sampled = operations[0] + operations[1] + operations[2];
+  if (!sampled)
+    return sample;
+  // the rest of the file is assumed to hold the same mix at the same line length
+  auto total_lines = static_cast<double>(lines);
+  if (stream)
+    total_lines = static_cast<double>(std::filesystem::file_size(query_path)) * static_cast<double>(lines) / static_cast<double>(bytes);
+  sample.queries = total_lines * static_cast<double>(sampled) / static_cast<double>(lines);
+  sample.query_length = static_cast<double>(query_characters) / static_cast<double>(sampled);
+  for (std::size_t op = 0; op < 3; ++op)
+    sample.mix[op] = static_cast<double>(operations[op]) / static_cast<double>(sampled);
+  sample.queries_known = true;
+  return sample;
+}
+
+// Time and memory of one variant for the sampled workload according to the cost model
+struct VariantEstimate
+{
+  double construction_ns = 0.0;
+  double query_ns = 0.0;
+  double memory_bytes = 0.0; // after the queries, every insert query is assumed to add a new word
+};
+
+inline VariantEstimate
+estimate_variant(const WorkloadSample& sample, const VariantCost& cost)
+{
+  // without a query file, the server is assumed to answer as many queries as there are input words
+  const auto queries = sample.queries_known ? sample.queries : static_cast<double>(sample.words);
+  const auto query_path = (sample.queries_known ? sample.query_length : sample.word_length) + 1.0;
+  const auto added_nodes = queries * sample.mix[1] * sample.nodes_per_word;
+
+  VariantEstimate estimate;
+  estimate.construction_ns = static_cast<double>(sample.words) * (sample.word_length + 1.0) * cost.visit_ns + sample.nodes * cost.alloc_ns;
+  estimate.query_ns = queries * query_path * ((sample.mix[0] + sample.mix[1]) * cost.visit_ns + sample.mix[2] * cost.remove_ns) + added_nodes * cost.alloc_ns;
+  estimate.memory_bytes = (sample.nodes + added_nodes) * cost.node_bytes;
+  return estimate;
+}
+
+// Picks the variant with the least estimated construction and query time among those that fit
+// into memory_budget_bytes (0 for no budget) and prints the AUTO lines with the reasoning.
+// Returns the variant_value, 0 if none is eligible.
+inline int
+select_variant(const WorkloadSample& sample, const CostModel& model, double memory_budget_bytes)
+{
+  std::cout << "AUTO words=" << sample.words << " word_length=" << sample.word_length << " alphabet=" << sample.alphabet
+            << " alphanumeric=" << sample.alphanumeric << " estimated_nodes=" << static_cast<std::size_t>(sample.nodes) << " queries=";
+  if (sample.queries_known)
+    std::cout << static_cast<std::size_t>(sample.queries) << " contains=" << sample.mix[0] << " insert=" << sample.mix[1] << " remove=" << sample.mix[2];
+  else
+    std::cout << "unknown";
+  std::cout << std::endl;
+
+  int best = 0;
+  double best_ns = 0.0;
+  std::size_t fitting = 0;
+  for (std::size_t i = 0; i < CostModel::NumVariants; ++i) {
+    const auto estimate = estimate_variant(sample, model.variants[i]);
+    const auto total_ns = estimate.construction_ns + estimate.query_ns;
+    const char* status = "ok";
+    if (i == 1 && !sample.alphanumeric)
+      status = "alphabet";
+    else if (memory_budget_bytes > 0.0 && estimate.memory_bytes > memory_budget_bytes)
+      status = "memory_budget";
+    std::cout << "AUTO candidate=" << CostModel::names[i] << " estimated_construction_time=" << estimate.construction_ns / 1e6
+              << " estimated_query_time=" << estimate.query_ns / 1e6 << " estimated_memory=" << estimate.memory_bytes / 1048576.0 << " status=" << status
+              << std::endl;
+    if (std::string_view{ status } != "ok")
+      continue;
+    ++fitting;
+    if (!best || total_ns < best_ns) {
+      best = static_cast<int>(i) + 1;
+      best_ns = total_ns;
+    }
+  }
+
+  if (best) {
+    std::cout << "AUTO chosen=" << CostModel::names[best - 1] << " reason=" << (fitting > 1 ? "least_estimated_time" : "only_eligible_variant")
+              << " eligible=" << fitting << std::endl;
+  }
+  return best;
+}
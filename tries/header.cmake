@@ -0,0 +1,8 @@
+find_package(Threads REQUIRED)
+target_link_libraries(${TARGET_NAME} INTERFACE Threads::Threads)
+
+# instrumented build: the tries count their operations for stats() (see trie_stats.hpp)
+option(TRIES_TRACE "Count trie operations, nodes visited, allocations and probes" OFF)
+if (TRIES_TRACE)
+    target_compile_definitions(${TARGET_NAME} INTERFACE TRIES_TRACE=1)
+endif ()
@@ -1,9 +1,18 @@
 #pragma once
 
-#include <cassert> // (optional) for static_assert
-#include <cstddef> // for std::size_t
-#include <memory>  // for std::unique_ptr, std::make_unique
-#include <string>  // for std::string
+#include <cassert>     // (optional) for static_assert
+#include <cstddef>     // for std::size_t
+#include <limits>      // for std::numeric_limits
+#include <memory>      // for std::unique_ptr, std::make_unique
+#include <string>      // for std::string
+#include <type_traits> // for std::conditional_t
+#include <utility>     // for std::as_const, std::move, std::pair
+#include <vector>      // for std::vector
+
+#include "node_compactor.hpp"
+#include "parallel_branches.hpp"
+#include "trie_finger.hpp"
+#include "trie_stats.hpp"
 
 namespace util {
 constexpr unsigned char
@@ -33,10 +42,23 @@ symbol(unsigned char uc)
 }
 }
 
-class ArrayTrie
+// ArrayTrie, optionally with subtree word counters (CountWords).
+//
+// The counters cost one word per node and are maintained by insert and remove. They answer
+// count_prefix, rank and select in O(63 * key length) instead of a traversal.
+template<bool CountWords>
+class BasicArrayTrie
 {
 private:
-  struct Node
+  struct NoCount
+  {};
+
+  struct SubtreeCount
+  {
+    std::size_t words = 0; // words in the subtree, including the node itself
+  };
+
+  struct Node : std::conditional_t<CountWords, SubtreeCount, NoCount>
   {
     std::size_t is_end = false;
     std::unique_ptr<Node> children[63];
@@ -45,20 +67,28 @@ private:
     {
       // we make is_end a size type
       // to ensure even size of Node
-      static_assert(sizeof(Node) == 64 * 8);
+      static_assert(sizeof(Node) == (CountWords ? 65 : 64) * 8);
     }
   };
 
   std::unique_ptr<Node> root;
+  NodeCompactor<Node> compactor;
+  std::size_t epoch = 0; // bumped whenever nodes are freed or relocated, see TrieFinger
 
 public:
-  ArrayTrie()
+  using Finger = TrieFinger<Node>;
+
+  BasicArrayTrie()
     : root(std::make_unique<Node>())
   {
   }
 
   bool insert(const std::string& word)
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() + 1);
+    TRIES_TRACE_ADD(searches, word.size());
+    TRIES_TRACE_ADD(probes, word.size());
     Node* curr = root.get();
     bool insertedNewNode = false;
 
@@ -67,51 +97,408 @@ public:
 
       if (!curr->children[uc]) {
         curr->children[uc] = std::make_unique<Node>();
+        TRIES_TRACE_ADD(allocations, 1);
         insertedNewNode = true;
       }
       curr = curr->children[uc].get();
     }
     bool wasEnd = curr->is_end;
     curr->is_end = true;
+    if constexpr (CountWords)
+      if (!wasEnd)
+        countPath(word, true);
     return (!wasEnd) || insertedNewNode;
   }
 
   [[nodiscard]] bool contains(const std::string& word) const
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
     const Node* curr = root.get();
     for (char c : word) {
       const auto uc = util::index(c);
+      TRIES_TRACE_ADD(searches, 1);
+      TRIES_TRACE_ADD(probes, 1);
       if (!curr->children[uc]) {
         return false;
       }
       curr = curr->children[uc].get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
     }
     return curr->is_end;
   }
 
-  bool remove(const std::string& word) { return removeHelper(root.get(), word, 0); }
+  bool remove(const std::string& word)
+  {
+    TRIES_TRACE_ADD(operations, 1);
+    if constexpr (CountWords) {
+      if (!holds(word))
+        return false;
+      countPath(word, false);
+    }
+    compactor.restart();
+    ++epoch;
+    return removeHelper(root.get(), word, 0);
+  }
+
+  // insert, resuming from the path of the finger's previous operation
+  bool insert(const std::string& word, Finger& finger)
+  {
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() - depth + 1);
+    TRIES_TRACE_ADD(searches, word.size() - depth);
+    TRIES_TRACE_ADD(probes, word.size() - depth);
+    bool insertedNewNode = false;
+    for (; depth < word.size(); ++depth) {
+      const auto uc = util::index(word[depth]);
+      if (!curr->children[uc]) {
+        curr->children[uc] = std::make_unique<Node>();
+        TRIES_TRACE_ADD(allocations, 1);
+        insertedNewNode = true;
+      }
+      curr = curr->children[uc].get();
+      finger.descend(curr, word[depth]);
+    }
+    bool wasEnd = curr->is_end;
+    curr->is_end = true;
+    if constexpr (CountWords)
+      if (!wasEnd)
+        for (std::size_t d = 0; d <= word.size(); ++d)
+          ++finger.node(d)->words;
+    return (!wasEnd) || insertedNewNode;
+  }
+
+  // contains, resuming from the path of the finger's previous operation
+  [[nodiscard]] bool contains(const std::string& word, Finger& finger) const
+  {
+    std::size_t depth = 0;
+    const Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      Node* child = curr->children[util::index(word[depth])].get();
+      TRIES_TRACE_ADD(searches, 1);
+      TRIES_TRACE_ADD(probes, 1);
+      if (!child)
+        return false;
+      curr = child;
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(child, word[depth]);
+    }
+    return curr->is_end;
+  }
+
+  // remove, resuming from the path of the finger's previous operation and pruning along it
+  bool remove(const std::string& word, Finger& finger)
+  {
+    compactor.restart();
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      Node* child = curr->children[util::index(word[depth])].get();
+      TRIES_TRACE_ADD(searches, 1);
+      TRIES_TRACE_ADD(probes, 1);
+      if (!child)
+        return false;
+      curr = child;
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(curr, word[depth]);
+    }
+    if (!curr->is_end)
+      return false;
+    curr->is_end = false;
+    if constexpr (CountWords)
+      for (std::size_t d = 0; d <= depth; ++d)
+        --finger.node(d)->words;
+    if (depth == 0 || !allChildrenNull(curr))
+      return depth == 0 && allChildrenNull(curr);
+
+    // the other fingers may hold pruned nodes
+    finger.sync(++epoch);
+    [[maybe_unused]] const auto leaf_depth = depth;
+    while (depth > 0 && !curr->is_end && allChildrenNull(curr)) {
+      finger.truncate(--depth);
+      curr = finger.node(depth);
+      curr->children[util::index(word[depth])].reset();
+      TRIES_TRACE_ADD(frees, 1);
+    }
+    // like removeHelper, count a prune only if a node was freed
+    TRIES_TRACE_ADD(prunes, depth < leaf_depth ? 1 : 0);
+    return depth == 0 && !curr->is_end && allChildrenNull(curr);
+  }
 
   [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()); }
 
+  // Nodes, words and size() by depth and the fanout histogram, with the current trace counters
+  [[nodiscard]] TrieStats stats() const
+  {
+    TrieStats result;
+    statsHelper(root.get(), 0, result);
+    result.trace = util::trace_snapshot();
+    return result;
+  }
+
+  // Adds every word of other (a different trie), taking over its subtrees where this trie has
+  // none instead of copying them. other is empty afterwards. Top-level branches present in both
+  // tries are merged in parallel.
+  void unite(BasicArrayTrie&& other)
+  {
+    compactor.restart();
+    other.compactor.restart();
+    ++epoch;
+    ++other.epoch;
+    std::vector<std::pair<Node*, Node*>> shared;
+    uniteHelper(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) { uniteHelper(*shared[i].first, *shared[i].second, nullptr); });
+    recount(*root);
+    other.root = std::make_unique<Node>();
+  }
+
+  // Keeps only the words also contained in other (a different trie)
+  void intersect(const BasicArrayTrie& other) { filter<true>(other); }
+
+  // Removes every word contained in other (a different trie)
+  void subtract(const BasicArrayTrie& other) { filter<false>(other); }
+
+  // Number of stored words
+  [[nodiscard]] std::size_t word_count() const
+    requires CountWords
+  {
+    return root->words;
+  }
+
+  // Number of stored words starting with prefix
+  [[nodiscard]] std::size_t count_prefix(const std::string& prefix) const
+    requires CountWords
+  {
+    const Node* curr = root.get();
+    for (char c : prefix) {
+      curr = curr->children[util::index(c)].get();
+      if (!curr)
+        return 0;
+    }
+    return curr->words;
+  }
+
+  // Number of stored words less than word in lexicographic order of util::index
+  [[nodiscard]] std::size_t rank(const std::string& word) const
+    requires CountWords
+  {
+    std::size_t result = 0;
+    const Node* curr = root.get();
+    for (char c : word) {
+      // the word ending here is a proper prefix, its smaller siblings come before as well
+      result += curr->is_end ? 1 : 0;
+      const auto uc = util::index(c);
+      for (std::size_t i = 0; i < uc; ++i)
+        if (curr->children[i])
+          result += curr->children[i]->words;
+      curr = curr->children[uc].get();
+      if (!curr)
+        break;
+    }
+    return result;
+  }
+
+  // Sets word to the i-th (0-based) stored word in lexicographic order of util::index.
+  // Characters are restored via util::symbol as in for_each. Returns false if i >= word_count().
+  bool select(std::size_t i, std::string& word) const
+    requires CountWords
+  {
+    word.clear();
+    if (i >= root->words)
+      return false;
+    const Node* curr = root.get();
+    while (true) {
+      if (curr->is_end) {
+        if (i == 0)
+          return true;
+        --i;
+      }
+      for (std::size_t c = 0; c < 63; ++c) {
+        const Node* child = curr->children[c].get();
+        if (!child)
+          continue;
+        if (i < child->words) {
+          word.push_back(util::symbol(static_cast<unsigned char>(c)));
+          curr = child;
+          break;
+        }
+        i -= child->words;
+      }
+    }
+  }
+
+  // Relocates all nodes into fresh memory in depth-first order
+  void compact()
+  {
+    compactor.restart();
+    compact_step(std::numeric_limits<std::size_t>::max());
+  }
+
+  // Incremental compact() in slices of at most budget nodes; returns true once a pass is complete.
+  // Removing restarts the pass.
+  bool compact_step(std::size_t budget)
+  {
+    ++epoch;
+    return compactor.step(
+      root, budget, [](Node& old) { return std::make_unique<Node>(std::move(old)); },
+      [](Node& node, auto&& visit) {
+        for (auto& child : node.children)
+          if (child)
+            visit(child);
+      });
+  }
+
+  // Calls visit(word) for every stored word in lexicographic order of util::index.
+  // Characters are restored via util::symbol, so non-alphanumeric characters come back as '\0'.
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    std::string word;
+    forEachHelper(root.get(), word, visit);
+  }
+
 private:
+  using Slot = std::unique_ptr<Node>*;
+
+  // Updates the word counter of node from its children
+  static void recount([[maybe_unused]] Node& node)
+  {
+    if constexpr (CountWords) {
+      node.words = node.is_end ? 1 : 0;
+      for (auto& child : node.children)
+        if (child)
+          node.words += child->words;
+    }
+  }
+
+  // Merges b into a. With shared set, subtrees present in both are collected instead of merged.
+  static void uniteHelper(Node& a, Node& b, std::vector<std::pair<Node*, Node*>>* shared)
+  {
+    a.is_end = a.is_end || b.is_end;
+    for (std::size_t i = 0; i < 63; ++i) {
+      if (!b.children[i])
+        continue;
+      if (!a.children[i])
+        a.children[i] = std::move(b.children[i]);
+      else if (shared)
+        shared->emplace_back(a.children[i].get(), b.children[i].get());
+      else
+        uniteHelper(*a.children[i], *b.children[i], nullptr);
+    }
+    if (!shared)
+      recount(a);
+  }
+
+  template<bool Intersect>
+  void filter(const BasicArrayTrie& other)
+  {
+    compactor.restart();
+    ++epoch;
+    std::vector<std::pair<Slot, const Node*>> shared;
+    filterHelper<Intersect>(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) {
+      if (filterHelper<Intersect>(**shared[i].first, *shared[i].second, nullptr))
+        shared[i].first->reset();
+    });
+    recount(*root);
+  }
+
+  // Intersects a with b or subtracts b from a; returns true if a holds no word afterwards.
+  // With shared set, subtrees present in both are collected instead of filtered.
+  template<bool Intersect>
+  static bool filterHelper(Node& a, const Node& b, std::vector<std::pair<Slot, const Node*>>* shared)
+  {
+    a.is_end = Intersect ? a.is_end && b.is_end : a.is_end && !b.is_end;
+    for (std::size_t i = 0; i < 63; ++i) {
+      if (!a.children[i])
+        continue;
+      if (!b.children[i]) {
+        if (Intersect)
+          a.children[i].reset();
+      } else if (shared) {
+        shared->emplace_back(&a.children[i], b.children[i].get());
+      } else if (filterHelper<Intersect>(*a.children[i], *b.children[i], nullptr)) {
+        a.children[i].reset();
+      }
+    }
+    if (shared)
+      return false;
+    recount(a);
+    return !a.is_end && allChildrenNull(&a);
+  }
+
+  // contains without the trace counters, so the presence check of remove is not a second operation
+  [[nodiscard]] bool holds(const std::string& word) const
+  {
+    const Node* curr = root.get();
+    for (char c : word) {
+      curr = curr->children[util::index(c)].get();
+      if (!curr)
+        return false;
+    }
+    return curr->is_end;
+  }
+
+  // Adds or removes word from the counters of the nodes on its path
+  void countPath(const std::string& word, bool add)
+  {
+    Node* curr = root.get();
+    for (std::size_t d = 0;; ++d) {
+      if (add)
+        ++curr->words;
+      else
+        --curr->words;
+      if (d == word.size())
+        break;
+      curr = curr->children[util::index(word[d])].get();
+    }
+  }
+
+  template<typename Visitor>
+  static void forEachHelper(const Node* node, std::string& word, Visitor& visit)
+  {
+    if (node->is_end)
+      visit(std::as_const(word));
+    for (std::size_t i = 0; i < 63; ++i) {
+      if (!node->children[i])
+        continue;
+      word.push_back(util::symbol(static_cast<unsigned char>(i)));
+      forEachHelper(node->children[i].get(), word, visit);
+      word.pop_back();
+    }
+  }
+
   [[nodiscard]] bool removeHelper(Node* node, const std::string& word, std::size_t index)
   {
     if (!node)
       return false;
+    TRIES_TRACE_ADD(nodes_visited, 1);
     if (index == word.size()) {
       if (!node->is_end)
         return false;
       node->is_end = false;
       // Check if all children are null
-      return allChildrenNull(node);
+      const bool prunable = allChildrenNull(node);
+      if (index > 0 && prunable)
+        TRIES_TRACE_ADD(prunes, 1);
+      return prunable;
     }
     const auto uc = util::index(word[index]);
+    TRIES_TRACE_ADD(searches, 1);
+    TRIES_TRACE_ADD(probes, 1);
     if (!node->children[uc]) {
       return false;
     }
     bool shouldPrune = removeHelper(node->children[uc].get(), word, index + 1);
     if (shouldPrune) {
       node->children[uc].reset(nullptr);
+      TRIES_TRACE_ADD(frees, 1);
       // If node is not an endpoint, check if we can prune further
       return (!node->is_end && allChildrenNull(node));
     }
@@ -136,4 +523,19 @@ private:
       total += sizeHelper(child.get());
     return total;
   }
+
+  static void statsHelper(const Node* node, std::size_t depth, TrieStats& stats)
+  {
+    std::size_t children = 0;
+    for (auto& child : node->children)
+      if (child)
+        ++children;
+    stats.add_node(depth, children, sizeof(*node), node->is_end);
+    for (auto& child : node->children)
+      if (child)
+        statsHelper(child.get(), depth + 1, stats);
+  }
 };
+
+using ArrayTrie = BasicArrayTrie<false>;
+using CountingArrayTrie = BasicArrayTrie<true>;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdlib> // for std::strtod
+#include <istream> // for std::istream, std::getline
+#include <ostream> // for std::ostream
+#include <sstream> // for std::stringstream
+#include <string>  // for std::string
+
+// Costs of one trie variant, per node of the paths the operations take
+struct VariantCost
+{
+  double visit_ns = 0.0;   // per node reached by contains and insert
+  double alloc_ns = 0.0;   // per node allocated by insert, on top of reaching it
+  double remove_ns = 0.0;  // per node reached by remove, pruning included
+  double node_bytes = 0.0; // size() per node
+};
+
+// Cost model of the dynamic variants for ti_programm -variant_value=auto.
+// The defaults were measured with benchmark --mode=cost_model on uniform keys, which writes the
+// same csv format for other machines and key distributions (see readCsv).
+struct CostModel
+{
+  static constexpr std::size_t NumVariants = 3;
+  static constexpr const char* names[NumVariants] = { "vector_trie", "array_trie", "hash_trie" }; // variant_value - 1
+
+  VariantCost variants[NumVariants] = {
+    { 55.0, 140.0, 88.0, 49.0 },
+    { 72.0, 335.0, 400.0, 512.0 },
+    { 123.0, 215.0, 225.0, 183.0 },
+  };
+
+  static void writeCsvHeader(std::ostream& os) { os << "variant,visit_ns,alloc_ns,remove_ns,node_bytes\n"; }
+
+  void writeCsv(std::ostream& os) const
+  {
+    for (std::size_t i = 0; i < NumVariants; ++i)
+      os << names[i] << ',' << variants[i].visit_ns << ',' << variants[i].alloc_ns << ',' << variants[i].remove_ns << ',' << variants[i].node_bytes << '\n';
+  }
+
+  // Reads a file written by writeCsvHeader and writeCsv. Variants missing in the file keep their
+  // costs, returns false for malformed rows or unknown variants.
+  bool readCsv(std::istream& is)
+  {
+    std::string line;
+    if (!std::getline(is, line))
+      return false;
+    while (std::getline(is, line)) {
+      if (line.empty())
+        continue;
+      std::stringstream row(line);
+      std::string name, field;
+      std::getline(row, name, ',');
+      std::size_t variant = 0;
+      while (variant < NumVariants && name != names[variant])
+        ++variant;
+      if (variant == NumVariants)
+        return false;
+      double values[4];
+      for (auto& value : values) {
+        if (!std::getline(row, field, ','))
+          return false;
+        char* end = nullptr;
+        value = std::strtod(field.c_str(), &end);
+        if (field.empty() || *end != '\0')
+          return false;
+      }
+      variants[variant] = { values[0], values[1], values[2], values[3] };
+    }
+    return true;
+  }
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm> // for std::find, std::sort, std::unique, std::max
+#include <cstddef>   // for std::size_t
+#include <fstream>   // for std::ifstream
+#include <sstream>   // for std::istringstream
+#include <string>    // for std::string, std::stoi, std::to_string
+#include <thread>    // for std::thread::hardware_concurrency
+#include <utility>   // for std::move
+#include <vector>    // for std::vector
+
+#if defined(__linux__)
+#include <pthread.h> // for pthread_setaffinity_np
+#include <sched.h>   // for sched_getaffinity, sched_getcpu, CPU_SET
+#endif
+
+// CPUs this process may run on, grouped by NUMA node.
+// Falls back to a single node without pinning where the topology is not exposed.
+struct CpuTopology
+{
+  std::vector<std::vector<int>> nodes{};
+
+  static std::vector<int> parse_cpu_list(const std::string& list)
+  {
+    std::vector<int> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+      if (range.empty() || range == "\n")
+        continue;
+      const auto dash = range.find('-');
+      const auto first = std::stoi(range.substr(0, dash));
+      const auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+
+  static CpuTopology detect()
+  {
+    CpuTopology topology;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    for (int node = 0;; ++node) {
+      auto stream = std::ifstream{ "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist" };
+      if (!stream)
+        break;
+      std::string list;
+      std::getline(stream, list);
+      std::vector<int> cpus;
+      for (const auto cpu : parse_cpu_list(list))
+        if (CPU_ISSET(static_cast<std::size_t>(cpu), &allowed))
+          cpus.push_back(cpu);
+      if (!cpus.empty())
+        topology.nodes.push_back(std::move(cpus));
+    }
+    if (topology.nodes.empty()) {
+      topology.nodes.emplace_back();
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(static_cast<std::size_t>(cpu), &allowed))
+          topology.nodes.back().push_back(cpu);
+    }
+#else
+    topology.nodes.emplace_back(); // unknown cpu ids, threads stay unpinned
+#endif
+    return topology;
+  }
+
+  [[nodiscard]] std::size_t cpu_count() const
+  {
+    std::size_t count = 0;
+    for (const auto& node : nodes)
+      count += node.size();
+    return count ? count : std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // "compact" fills one node before the next, "scatter" alternates between nodes
+  [[nodiscard]] std::vector<int> cpu_order(bool scatter) const
+  {
+    std::vector<int> order;
+    if (!scatter) {
+      for (const auto& node : nodes)
+        order.insert(order.end(), node.begin(), node.end());
+      return order;
+    }
+    for (std::size_t i = 0; order.size() < cpu_count() && !nodes.front().empty(); ++i)
+      for (const auto& node : nodes)
+        if (i < node.size())
+          order.push_back(node[i]);
+    return order;
+  }
+
+  // number of distinct nodes touched by the first `threads` cpus of the given order
+  [[nodiscard]] std::size_t nodes_used(const std::vector<int>& order, std::size_t threads) const
+  {
+    std::vector<std::size_t> used;
+    for (std::size_t t = 0; t < threads && t < order.size(); ++t)
+      for (std::size_t n = 0; n < nodes.size(); ++n)
+        if (std::find(nodes[n].begin(), nodes[n].end(), order[t]) != nodes[n].end())
+          used.push_back(n);
+    std::sort(used.begin(), used.end());
+    return std::max<std::size_t>(1, static_cast<std::size_t>(std::unique(used.begin(), used.end()) - used.begin()));
+  }
+
+  // Detected once for the whole process
+  static const CpuTopology& system()
+  {
+    static const CpuTopology topology = detect();
+    return topology;
+  }
+
+  // Node of a cpu, 0 if it is unknown
+  [[nodiscard]] std::size_t node_of(int cpu) const
+  {
+    for (std::size_t n = 0; n < nodes.size(); ++n)
+      if (std::find(nodes[n].begin(), nodes[n].end(), cpu) != nodes[n].end())
+        return n;
+    return 0;
+  }
+
+  // Node the calling thread currently runs on
+  [[nodiscard]] std::size_t current_node() const
+  {
+#if defined(__linux__)
+    if (nodes.size() > 1)
+      return node_of(sched_getcpu());
+#endif
+    return 0;
+  }
+};
+
+inline void
+pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<std::size_t>(cpu), &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+// Restricts the calling thread to a set of cpus, e.g. one node of a CpuTopology
+inline void
+pin_current_thread(const std::vector<int>& cpus)
+{
+#if defined(__linux__)
+  if (cpus.empty())
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const auto cpu : cpus)
+    CPU_SET(static_cast<std::size_t>(cpu), &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpus;
+#endif
+}
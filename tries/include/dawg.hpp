@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>     // std::lower_bound, std::mismatch
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::pair, std::as_const, std::move
+#include <vector>        // std::vector
+
+// Read-only minimal acyclic DFA (DAWG) over a static set of words.
+//
+// Unlike a trie it shares suffixes as well as prefixes. States are stored flattened: the outgoing
+// edges of state s are symbols/targets[edge_begin[s], edge_begin[s + 1]), sorted by symbol, so
+// for_each enumerates the words in lexicographic order. Built by DawgBuilder.
+class Dawg
+{
+private:
+  friend class DawgBuilder;
+
+  std::vector<std::uint32_t> edge_begin{ 0, 0 }; // one state without edges
+  std::vector<unsigned char> symbols;
+  std::vector<std::uint32_t> targets;
+  std::vector<bool> is_final{ false };
+
+public:
+  // Check if word is contained
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    std::uint32_t state = 0;
+    for (char c : word) {
+      const auto begin = symbols.begin() + edge_begin[state];
+      const auto end = symbols.begin() + edge_begin[state + 1];
+      const auto it = std::lower_bound(begin, end, static_cast<unsigned char>(c));
+      if (it == end || *it != static_cast<unsigned char>(c))
+        return false;
+      state = targets[static_cast<std::size_t>(it - symbols.begin())];
+    }
+    return is_final[state];
+  }
+
+  [[nodiscard]] std::size_t size() const
+  {
+    return sizeof(*this) + edge_begin.capacity() * sizeof(std::uint32_t) + symbols.capacity() + targets.capacity() * sizeof(std::uint32_t) +
+           (is_final.capacity() + 7) / 8;
+  }
+
+  [[nodiscard]] std::size_t num_states() const { return is_final.size(); }
+  [[nodiscard]] std::size_t num_edges() const { return symbols.size(); }
+
+  // Call visit(word) for every word in lexicographic order
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    std::string word;
+    forEachHelper(0, word, visit);
+  }
+
+private:
+  template<typename Visitor>
+  void forEachHelper(std::uint32_t state, std::string& word, Visitor& visit) const
+  {
+    if (is_final[state])
+      visit(std::as_const(word));
+    for (auto e = edge_begin[state]; e < edge_begin[state + 1]; ++e) {
+      word.push_back(static_cast<char>(symbols[e]));
+      forEachHelper(targets[e], word, visit);
+      word.pop_back();
+    }
+  }
+};
+
+// Incremental construction of a minimal DAWG from sorted input (Daciuk et al.).
+//
+// Words must be added in strictly increasing order. Only the path of the last word is still
+// mutable; once the next word leaves it, its states are minimized bottom-up: a state equal to one
+// in the register (same finality, same edges) is replaced by it, otherwise it is registered.
+class DawgBuilder
+{
+private:
+  struct Node
+  {
+    bool is_end = false;
+    std::vector<std::pair<unsigned char, std::uint32_t>> edges; // sorted, as the input is
+  };
+
+  struct UncheckedEdge
+  {
+    std::uint32_t parent;
+    unsigned char symbol;
+    std::uint32_t child;
+  };
+
+  std::vector<Node> nodes{ Node{} }; // node 0 is the root
+  std::vector<std::uint32_t> free_nodes;
+  std::vector<UncheckedEdge> unchecked; // path of the previous word that is not minimized yet
+  std::unordered_map<std::string, std::uint32_t> register_;
+  std::string previous;
+  bool empty = true;
+
+  static std::string signature(const Node& node)
+  {
+    std::string key(1, node.is_end ? '\1' : '\0');
+    for (const auto& [symbol, target] : node.edges) {
+      key.push_back(static_cast<char>(symbol));
+      key.append(reinterpret_cast<const char*>(&target), sizeof(target));
+    }
+    return key;
+  }
+
+  std::uint32_t newNode()
+  {
+    if (free_nodes.empty()) {
+      nodes.emplace_back();
+      return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+    const auto id = free_nodes.back();
+    free_nodes.pop_back();
+    return id;
+  }
+
+  // Minimizes the unchecked path below depth down_to
+  void minimize(std::size_t down_to)
+  {
+    while (unchecked.size() > down_to) {
+      const auto [parent, symbol, child] = unchecked.back();
+      unchecked.pop_back();
+      const auto [it, inserted] = register_.try_emplace(signature(nodes[child]), child);
+      if (inserted)
+        continue;
+      nodes[parent].edges.back().second = it->second;
+      nodes[child] = Node{};
+      free_nodes.push_back(child);
+    }
+  }
+
+public:
+  // Adds the next word. Returns false (and ignores the word) if it is not greater than the previous one.
+  bool add(const std::string& word)
+  {
+    if (!empty && word <= previous)
+      return false;
+    const auto prefix = static_cast<std::size_t>(std::mismatch(word.begin(), word.end(), previous.begin(), previous.end()).first - word.begin());
+    minimize(prefix);
+
+    auto node = unchecked.empty() ? std::uint32_t{ 0 } : unchecked.back().child;
+    for (std::size_t i = prefix; i < word.size(); ++i) {
+      const auto child = newNode();
+      const auto symbol = static_cast<unsigned char>(word[i]);
+      nodes[node].edges.emplace_back(symbol, child);
+      unchecked.push_back({ node, symbol, child });
+      node = child;
+    }
+    nodes[node].is_end = true;
+    previous = word;
+    empty = false;
+    return true;
+  }
+
+  // Minimizes the remaining path and flattens the reachable states in depth-first order.
+  // The builder is empty afterwards.
+  Dawg finish()
+  {
+    minimize(0);
+
+    Dawg dawg;
+    dawg.edge_begin.clear();
+    dawg.is_final.clear();
+    constexpr auto Unvisited = ~std::uint32_t{ 0 };
+    std::vector<std::uint32_t> index(nodes.size(), Unvisited);
+
+    // number the states in preorder, then emit their edges in that order
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> stack{ 0 };
+    while (!stack.empty()) {
+      const auto id = stack.back();
+      stack.pop_back();
+      if (index[id] != Unvisited)
+        continue;
+      index[id] = static_cast<std::uint32_t>(order.size());
+      order.push_back(id);
+      const auto& edges = nodes[id].edges;
+      for (auto e = edges.rbegin(); e != edges.rend(); ++e)
+        if (index[e->second] == Unvisited)
+          stack.push_back(e->second);
+    }
+    for (const auto id : order) {
+      dawg.edge_begin.push_back(static_cast<std::uint32_t>(dawg.symbols.size()));
+      dawg.is_final.push_back(nodes[id].is_end);
+      for (const auto& [symbol, target] : nodes[id].edges) {
+        dawg.symbols.push_back(symbol);
+        dawg.targets.push_back(index[target]);
+      }
+    }
+    dawg.edge_begin.push_back(static_cast<std::uint32_t>(dawg.symbols.size()));
+    dawg.edge_begin.shrink_to_fit();
+    dawg.symbols.shrink_to_fit();
+    dawg.targets.shrink_to_fit();
+    dawg.is_final.shrink_to_fit();
+
+    *this = DawgBuilder{};
+    return dawg;
+  }
+};
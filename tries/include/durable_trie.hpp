@@ -0,0 +1,379 @@
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <cstdio>       // for std::FILE, std::fopen, std::fwrite, std::fread
+#include <filesystem>   // for std::filesystem::path, rename, resize_file, file_size
+#include <string>       // for std::string
+#include <system_error> // for std::error_code
+#include <utility>      // for std::forward
+
+#if defined(_WIN32)
+#include <io.h> // for _commit, _fileno
+#else
+#include <fcntl.h>  // for open, O_RDONLY
+#include <unistd.h> // for fsync, close
+#endif
+
+#include "trie_stats.hpp"
+#include "varint.hpp"
+
+namespace util {
+// FNV-1a, used to detect torn or corrupted log records
+constexpr std::uint32_t
+fnv1a(const char* data, std::size_t size, std::uint32_t hash = 2166136261u)
+{
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// flushes the stdio buffer and forces the file contents to stable storage
+inline bool
+syncFile(std::FILE* file)
+{
+  if (std::fflush(file) != 0)
+    return false;
+#if defined(_WIN32)
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+// forces the entries of a directory (e.g. a rename into it) to stable storage
+inline bool
+syncDirectory(const std::filesystem::path& directory)
+{
+#if defined(_WIN32)
+  // directories cannot be opened for flushing, the rename itself is journaled by NTFS
+  (void)directory;
+  return true;
+#else
+  const int fd = ::open(directory.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  const bool ok = fsync(fd) == 0;
+  ::close(fd);
+  return ok;
+#endif
+}
+}
+
+struct DurableRecoveryInfo
+{
+  bool recovered = false; // false if the directory held no previous state
+  std::size_t snapshot_words = 0;
+  std::size_t wal_records = 0;
+};
+
+// Makes the mutations of any variant durable.
+//
+// Inserts and removes are appended to a write-ahead log (<directory>/wal) and forced to disk in
+// groups of `group_commit` records, so a crash loses at most the last group_commit - 1 mutations.
+// Every `checkpoint_interval` mutations the whole trie is written to <directory>/snapshot and the
+// log restarts empty. Snapshot and log carry a generation number: a log is only replayed on top of
+// the snapshot of the same generation, so a crash between writing the snapshot and resetting the
+// log never replays stale records.
+//
+// File formats (little endian):
+//   snapshot: "TRIESNAP" u64 generation u64 word_count { varint length, bytes }* u32 fnv1a
+//   wal:      "TRIEWAL1" u64 generation { u8 op ('i'/'d'), varint length, bytes, u32 fnv1a }*
+template<typename Trie>
+class DurableTrie
+{
+public:
+  using RecoveryInfo = DurableRecoveryInfo;
+
+private:
+  static constexpr char SnapshotMagic[9] = "TRIESNAP";
+  static constexpr char WalMagic[9] = "TRIEWAL1";
+
+  Trie trie;
+  std::filesystem::path directory;
+  std::size_t group_commit;
+  std::size_t checkpoint_interval;
+
+  std::FILE* wal = nullptr;
+  std::string pending;               // encoded records not yet written
+  std::size_t pending_records = 0;   // records in pending
+  std::size_t mutations_logged = 0;  // records in the current log
+  std::uint64_t generation = 0;
+  bool io_error = false;
+
+  static void writeU64(std::string& out, std::uint64_t value)
+  {
+    for (int i = 0; i < 8; ++i)
+      out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+
+  static void writeU32(std::string& out, std::uint32_t value)
+  {
+    for (int i = 0; i < 4; ++i)
+      out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+
+  template<typename T>
+  static bool readLittleEndian(std::FILE* file, T& value)
+  {
+    unsigned char bytes[sizeof(T)];
+    if (std::fread(bytes, 1, sizeof(T), file) != sizeof(T))
+      return false;
+    value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+      value |= static_cast<T>(bytes[i]) << (8 * i);
+    return true;
+  }
+
+  static bool readHeader(std::FILE* file, const char (&magic)[9], std::uint64_t& header_generation)
+  {
+    char buffer[8];
+    return std::fread(buffer, 1, 8, file) == 8 && std::string(buffer, 8) == magic && readLittleEndian(file, header_generation);
+  }
+
+  // A word is never longer than the rest of the file, so a torn length fails before it is allocated
+  static bool readWord(std::FILE* file, std::uint64_t file_size, std::string& word)
+  {
+    std::uint64_t length = 0;
+    if (!util::readVarint(file, length))
+      return false;
+    const auto position = std::ftell(file);
+    if (position < 0 || static_cast<std::uint64_t>(position) > file_size || length > file_size - static_cast<std::uint64_t>(position))
+      return false;
+    word.resize(length);
+    return std::fread(word.data(), 1, word.size(), file) == word.size();
+  }
+
+  bool loadSnapshot(RecoveryInfo& info)
+  {
+    const auto path = directory / "snapshot";
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    if (!file)
+      return true; // no snapshot yet
+    std::error_code ec;
+    const std::uint64_t file_size = std::filesystem::file_size(path, ec);
+    std::uint64_t count = 0;
+    bool ok = !ec && readHeader(file, SnapshotMagic, generation) && readLittleEndian(file, count);
+    std::uint32_t hash = 2166136261u;
+    std::string word;
+    for (std::uint64_t i = 0; ok && i < count; ++i) {
+      ok = readWord(file, file_size, word);
+      if (ok) {
+        hash = util::fnv1a(word.data(), word.size(), hash);
+        trie.insert(word);
+        ++info.snapshot_words;
+      }
+    }
+    std::uint32_t checksum = 0;
+    ok = ok && readLittleEndian(file, checksum) && checksum == hash;
+    std::fclose(file);
+    info.recovered = true;
+    return ok;
+  }
+
+  // Replays the log of the snapshot generation and truncates a torn tail.
+  // wal_current tells whether the existing log belongs to the snapshot and can be appended to.
+  bool replayWal(RecoveryInfo& info, bool& wal_current)
+  {
+    const auto path = directory / "wal";
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    wal_current = false;
+    if (!file)
+      return true;
+    std::uint64_t wal_generation = 0;
+    if (!readHeader(file, WalMagic, wal_generation) || wal_generation != generation) {
+      std::fclose(file);
+      return true; // stale log from before the last checkpoint, reset by openWal
+    }
+    wal_current = true;
+    info.recovered = true;
+    std::error_code ec;
+    const std::uint64_t file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+      std::fclose(file);
+      return false;
+    }
+    auto valid_end = std::ftell(file);
+    std::string word;
+    for (;;) {
+      const int op = std::fgetc(file);
+      std::uint32_t checksum = 0;
+      if (op == EOF || !readWord(file, file_size, word) || !readLittleEndian(file, checksum))
+        break;
+      const char op_char = static_cast<char>(op);
+      if (checksum != util::fnv1a(word.data(), word.size(), util::fnv1a(&op_char, 1)))
+        break;
+      if (op == 'i')
+        trie.insert(word);
+      else if (op == 'd')
+        trie.remove(word);
+      else
+        break;
+      ++info.wal_records;
+      valid_end = std::ftell(file);
+    }
+    std::fclose(file);
+    mutations_logged = info.wal_records;
+
+    std::filesystem::resize_file(path, static_cast<std::uintmax_t>(valid_end), ec);
+    return !ec;
+  }
+
+  bool openWal(bool reset)
+  {
+    const auto path = (directory / "wal").string();
+    if (!reset) {
+      wal = std::fopen(path.c_str(), "ab");
+      return wal != nullptr;
+    }
+    wal = std::fopen(path.c_str(), "wb");
+    if (!wal)
+      return false;
+    std::string header(WalMagic, 8);
+    writeU64(header, generation);
+    return std::fwrite(header.data(), 1, header.size(), wal) == header.size() && util::syncFile(wal);
+  }
+
+  void log(char op, const std::string& word)
+  {
+    pending.push_back(op);
+    util::appendVarint(pending, word.size());
+    pending.append(word);
+    writeU32(pending, util::fnv1a(word.data(), word.size(), util::fnv1a(&op, 1)));
+    ++pending_records;
+    ++mutations_logged;
+    if (pending_records >= group_commit && !sync())
+      io_error = true;
+    if (mutations_logged >= checkpoint_interval && !checkpoint())
+      io_error = true;
+  }
+
+public:
+  template<typename... Args>
+  explicit DurableTrie(std::filesystem::path directory_, std::size_t group_commit_ = 64, std::size_t checkpoint_interval_ = 1'000'000, Args&&... args)
+    : trie(std::forward<Args>(args)...)
+    , directory(std::move(directory_))
+    , group_commit(group_commit_ ? group_commit_ : 1)
+    , checkpoint_interval(checkpoint_interval_ ? checkpoint_interval_ : 1)
+  {
+  }
+
+  DurableTrie(const DurableTrie&) = delete;
+  DurableTrie& operator=(const DurableTrie&) = delete;
+
+  ~DurableTrie()
+  {
+    if (wal) {
+      sync();
+      std::fclose(wal);
+    }
+  }
+
+  // Restores the latest snapshot plus the log tail from the directory (creating it if needed)
+  // and opens the log for appending. Returns false on I/O errors or a corrupted snapshot.
+  bool open(RecoveryInfo* info = nullptr)
+  {
+    RecoveryInfo local;
+    auto& recovery = info ? *info : local;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    bool wal_current = false;
+    if (ec || !loadSnapshot(recovery) || !replayWal(recovery, wal_current))
+      return false;
+    return openWal(!wal_current);
+  }
+
+  // false once writing the log or a snapshot failed
+  [[nodiscard]] bool good() const { return !io_error; }
+
+  // Mutations through the underlying trie are not logged, call checkpoint() afterwards to persist them.
+  Trie& unlogged() { return trie; }
+
+  bool insert(const std::string& word)
+  {
+    const bool inserted = trie.insert(word);
+    // duplicates do not change the trie and need no record
+    if (inserted)
+      log('i', word);
+    return inserted;
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const { return trie.contains(word); }
+
+  // the return value of remove does not tell whether the word existed, so every remove is logged
+  bool remove(const std::string& word)
+  {
+    const bool result = trie.remove(word);
+    log('d', word);
+    return result;
+  }
+
+  [[nodiscard]] std::size_t size() const { return trie.size(); }
+
+  [[nodiscard]] TrieStats stats() const { return trie.stats(); }
+
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    trie.for_each(std::forward<Visitor>(visit));
+  }
+
+  // Group commit: writes the pending records and forces them to disk.
+  bool sync()
+  {
+    if (!wal)
+      return false;
+    const bool ok = std::fwrite(pending.data(), 1, pending.size(), wal) == pending.size() && util::syncFile(wal);
+    pending.clear();
+    pending_records = 0;
+    return ok;
+  }
+
+  // Writes a snapshot of the next generation and starts an empty log for it.
+  bool checkpoint()
+  {
+    const auto tmp_path = directory / "snapshot.tmp";
+    std::FILE* file = std::fopen(tmp_path.string().c_str(), "wb");
+    if (!file)
+      return false;
+
+    std::string buffer(SnapshotMagic, 8);
+    writeU64(buffer, generation + 1);
+    std::uint64_t count = 0;
+    trie.for_each([&count](const std::string&) { ++count; });
+    writeU64(buffer, count);
+    std::uint32_t hash = 2166136261u;
+    bool ok = true;
+    trie.for_each([&](const std::string& word) {
+      util::appendVarint(buffer, word.size());
+      buffer.append(word);
+      hash = util::fnv1a(word.data(), word.size(), hash);
+      if (buffer.size() >= (std::size_t{ 1 } << 20)) {
+        ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        buffer.clear();
+      }
+    });
+    writeU32(buffer, hash);
+    ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() && util::syncFile(file);
+    std::fclose(file);
+
+    std::error_code ec;
+    if (ok)
+      std::filesystem::rename(tmp_path, directory / "snapshot", ec);
+    // the rename must be durable before the log of the old generation is truncated
+    if (!ok || ec || !util::syncDirectory(directory))
+      return false;
+
+    // the snapshot covers all records, pending ones included
+    ++generation;
+    pending.clear();
+    pending_records = 0;
+    mutations_logged = 0;
+    if (wal)
+      std::fclose(wal);
+    wal = nullptr;
+    return openWal(true);
+  }
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>   // for std::min, std::mismatch
+#include <bit>         // for std::countr_zero
+#include <cstddef>     // for std::size_t
+#include <cstring>     // for std::memset
+#include <string>      // for std::string
+#include <string_view> // for std::string_view
+#include <utility>     // for std::as_const, std::move
+#include <vector>      // for std::vector
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // for _mm_loadu_si128, _mm_cmpeq_epi8, _mm_movemask_epi8
+#define TRIES_HAS_SSE2 1
+#else
+#define TRIES_HAS_SSE2 0
+#endif
+
+#include "varint.hpp"
+
+namespace util {
+// Length of the common prefix of a[0, n) and b[0, n), 16 bytes per step with SSE2. Both must be
+// readable up to n rounded up to a multiple of 16.
+inline std::size_t
+common_prefix_padded(const char* a, const char* b, std::size_t n)
+{
+#if TRIES_HAS_SSE2
+  for (std::size_t i = 0; i < n; i += 16) {
+    const auto lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const auto rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const auto equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)));
+    if (equal != 0xFFFF)
+      return std::min(n, i + static_cast<std::size_t>(std::countr_zero(~equal)));
+  }
+  return n;
+#else
+  std::size_t i = 0;
+  while (i < n && a[i] == b[i])
+    ++i;
+  return i;
+#endif
+}
+}
+
+// Read-only sorted dictionary, front coded in blocks of 16 words.
+//
+// The first word of a block (its header) is stored whole, every other word as the length of the
+// prefix it shares with its predecessor and the remaining suffix, both lengths as varints. A
+// lookup binary searches the headers and decodes a single block, comparing suffixes 16 bytes at a
+// time (SSE2). The byte string is padded, so these loads never leave it. Built by
+// FrontCodedBuilder.
+class FrontCodedDictionary
+{
+private:
+  friend class FrontCodedBuilder;
+
+  static constexpr std::size_t BlockSize = 16;
+  static constexpr std::size_t Padding = 16;
+
+  std::string data;                   // the blocks one after the other, then Padding zero bytes
+  std::vector<std::size_t> headers;   // offset of every block in data
+  std::size_t num_words = 0;
+
+  // A copy of word readable Padding bytes past its end, on the stack for the usual lengths
+  class PaddedQuery
+  {
+  private:
+    char buffer[256];
+    std::string heap;
+    const char* chars;
+
+  public:
+    explicit PaddedQuery(std::string_view word)
+    {
+      if (word.size() + Padding <= sizeof(buffer)) {
+        word.copy(buffer, word.size());
+        std::memset(buffer + word.size(), 0, Padding);
+        chars = buffer;
+      } else {
+        heap.assign(word);
+        heap.resize(word.size() + Padding);
+        chars = heap.data();
+      }
+    }
+
+    [[nodiscard]] const char* data() const { return chars; }
+  };
+
+  // <0, 0 or >0 as the header of block b is less than, equal to or greater than query
+  [[nodiscard]] int compareHeader(std::size_t b, const char* query, std::size_t length) const
+  {
+    const char* p = data.data() + headers[b];
+    const auto header_length = util::decodeVarint(p);
+    const auto shared = util::common_prefix_padded(p, query, std::min<std::size_t>(header_length, length));
+    if (shared == std::min<std::size_t>(header_length, length))
+      return header_length < length ? -1 : header_length > length ? 1 : 0;
+    return static_cast<unsigned char>(p[shared]) < static_cast<unsigned char>(query[shared]) ? -1 : 1;
+  }
+
+  // Number of blocks whose header is less than query (strict) or not greater than query
+  [[nodiscard]] std::size_t headersBelow(const char* query, std::size_t length, bool strict) const
+  {
+    std::size_t low = 0, high = headers.size();
+    while (low < high) {
+      const auto mid = low + (high - low) / 2;
+      const auto order = compareHeader(mid, query, length);
+      if (order < 0 || (!strict && order == 0))
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    return low;
+  }
+
+public:
+  // Check if word is contained
+  [[nodiscard]] bool contains(std::string_view word) const
+  {
+    const auto query = PaddedQuery(word);
+    const auto length = word.size();
+    const auto block = headersBelow(query.data(), length, false);
+    if (block == 0)
+      return false;
+
+    const char* p = data.data() + headers[block - 1];
+    const auto header_length = util::decodeVarint(p);
+    auto matched = util::common_prefix_padded(p, query.data(), std::min<std::size_t>(header_length, length));
+    if (matched == length && header_length == length)
+      return true;
+    p += header_length;
+
+    // invariant: the previous word is less than word and shares matched characters with it
+    const auto end = std::min(num_words, block * BlockSize);
+    for (auto k = (block - 1) * BlockSize + 1; k < end; ++k) {
+      const auto shared = util::decodeVarint(p);
+      const auto suffix_length = util::decodeVarint(p);
+      const char* suffix = p;
+      p += suffix_length;
+      if (shared > matched)
+        continue; // equal to the previous word at matched, still less
+      if (shared < matched)
+        return false; // greater than the previous word at shared, where it equals word
+      const auto rest = length - matched;
+      const auto common = util::common_prefix_padded(suffix, query.data() + matched, std::min<std::size_t>(suffix_length, rest));
+      if (common == rest)
+        return common == suffix_length;
+      if (common < suffix_length && static_cast<unsigned char>(suffix[common]) > static_cast<unsigned char>(query.data()[matched + common]))
+        return false;
+      matched += common;
+    }
+    return false;
+  }
+
+  // Call visit(word) for every word starting with prefix in lexicographic order
+  template<typename Visitor>
+  void for_each_with_prefix(std::string_view prefix, Visitor&& visit) const
+  {
+    if (!num_words)
+      return;
+    // the words of the block before the first header >= prefix may start with it as well
+    const auto query = PaddedQuery(prefix);
+    const auto block = headersBelow(query.data(), prefix.size(), true);
+    const char* p = data.data() + headers[block ? block - 1 : 0];
+
+    std::string word;
+    for (auto k = (block ? block - 1 : 0) * BlockSize; k < num_words; ++k) {
+      if (k % BlockSize == 0) {
+        const auto length = util::decodeVarint(p);
+        word.assign(p, length);
+        p += length;
+      } else {
+        const auto shared = util::decodeVarint(p);
+        const auto suffix_length = util::decodeVarint(p);
+        word.resize(shared);
+        word.append(p, suffix_length);
+        p += suffix_length;
+      }
+      if (word.starts_with(prefix))
+        visit(std::as_const(word));
+      else if (word > prefix)
+        return;
+    }
+  }
+
+  // Call visit(word) for every word in lexicographic order
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    for_each_with_prefix({}, visit);
+  }
+
+  [[nodiscard]] std::size_t size() const { return sizeof(*this) + data.capacity() + headers.capacity() * sizeof(std::size_t); }
+
+  [[nodiscard]] std::size_t num_blocks() const { return headers.size(); }
+  [[nodiscard]] std::size_t word_count() const { return num_words; }
+};
+
+// Appends words in strictly increasing order to a FrontCodedDictionary.
+class FrontCodedBuilder
+{
+private:
+  FrontCodedDictionary dictionary;
+  std::string previous;
+
+public:
+  // Adds the next word. Returns false (and ignores the word) if it is not greater than the previous one.
+  bool add(std::string_view word)
+  {
+    auto& data = dictionary.data;
+    if (dictionary.num_words && word <= previous)
+      return false;
+    if (dictionary.num_words % FrontCodedDictionary::BlockSize == 0) {
+      dictionary.headers.push_back(data.size());
+      util::appendVarint(data, word.size());
+      data.append(word);
+    } else {
+      const auto limit = std::min(word.size(), previous.size());
+      const auto shared = static_cast<std::size_t>(std::mismatch(word.begin(), word.begin() + static_cast<std::ptrdiff_t>(limit), previous.begin()).first -
+                                                   word.begin());
+      util::appendVarint(data, shared);
+      util::appendVarint(data, word.size() - shared);
+      data.append(word.substr(shared));
+    }
+    previous.assign(word);
+    ++dictionary.num_words;
+    return true;
+  }
+
+  // Pads and shrinks the byte string. The builder is empty afterwards.
+  FrontCodedDictionary finish()
+  {
+    dictionary.data.append(FrontCodedDictionary::Padding, '\0');
+    dictionary.data.shrink_to_fit();
+    dictionary.headers.shrink_to_fit();
+    auto result = std::move(dictionary);
+    *this = FrontCodedBuilder{};
+    return result;
+  }
+};
@@ -1,9 +1,17 @@
 #pragma once
 
 #include <cstddef>       // std::size_t
+#include <limits>        // std::numeric_limits
 #include <memory>        // std::unique_ptr, std::make_unique
 #include <string>        // std::string
 #include <unordered_map> // std::unordered_map
+#include <utility>       // std::as_const, std::move, std::pair
+#include <vector>        // std::vector
+
+#include "node_compactor.hpp"
+#include "parallel_branches.hpp"
+#include "trie_finger.hpp"
+#include "trie_stats.hpp"
 
 class HashTrie
 {
@@ -15,8 +23,12 @@ private:
   };
 
   std::unique_ptr<Node> root;
+  NodeCompactor<Node> compactor;
+  std::size_t epoch = 0; // bumped whenever nodes are freed or relocated, see TrieFinger
 
 public:
+  using Finger = TrieFinger<Node>;
+
   HashTrie()
     : root(std::make_unique<Node>())
   {
@@ -24,15 +36,18 @@ public:
 
   bool insert(const std::string& word)
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() + 1);
     Node* curr = root.get();
     bool insertedNewNode = false;
 
     for (char c : word) {
       auto uc = static_cast<unsigned char>(c);
 
-      auto it = curr->children.find(uc);
+      auto it = findChild(*curr, uc);
       if (it == curr->children.end()) {
         curr->children[uc] = std::make_unique<Node>();
+        TRIES_TRACE_ADD(allocations, 1);
         insertedNewNode = true;
         curr = curr->children[uc].get();
       } else {
@@ -46,40 +61,272 @@ public:
 
   bool contains(const std::string& word) const
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
     const Node* curr = root.get();
     for (char c : word) {
       auto uc = static_cast<unsigned char>(c);
-      auto it = curr->children.find(uc);
+      auto it = findChild(*curr, uc);
       if (it == curr->children.end())
         return false;
       curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
     }
     return curr->is_end;
   }
 
-  bool remove(const std::string& word) { return removeHelper(root.get(), word, 0); }
+  bool remove(const std::string& word)
+  {
+    TRIES_TRACE_ADD(operations, 1);
+    compactor.restart();
+    ++epoch;
+    return removeHelper(root.get(), word, 0);
+  }
+
+  // insert, resuming from the path of the finger's previous operation
+  bool insert(const std::string& word, Finger& finger)
+  {
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() - depth + 1);
+    bool insertedNewNode = false;
+    for (; depth < word.size(); ++depth) {
+      TRIES_TRACE_ADD(searches, 1);
+      TRIES_TRACE_ADD(probes, curr->children.empty() ? 0 : curr->children.bucket_size(curr->children.bucket(static_cast<unsigned char>(word[depth]))));
+      auto& child = curr->children[static_cast<unsigned char>(word[depth])];
+      if (!child) {
+        child = std::make_unique<Node>();
+        TRIES_TRACE_ADD(allocations, 1);
+        insertedNewNode = true;
+      }
+      curr = child.get();
+      finger.descend(curr, word[depth]);
+    }
+    bool wasEnd = curr->is_end;
+    curr->is_end = true;
+    return (!wasEnd) || insertedNewNode;
+  }
+
+  // contains, resuming from the path of the finger's previous operation
+  bool contains(const std::string& word, Finger& finger) const
+  {
+    std::size_t depth = 0;
+    const Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      auto it = findChild(*curr, static_cast<unsigned char>(word[depth]));
+      if (it == curr->children.end())
+        return false;
+      curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(it->second.get(), word[depth]);
+    }
+    return curr->is_end;
+  }
+
+  // remove, resuming from the path of the finger's previous operation and pruning along it
+  bool remove(const std::string& word, Finger& finger)
+  {
+    compactor.restart();
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      auto it = findChild(*curr, static_cast<unsigned char>(word[depth]));
+      if (it == curr->children.end())
+        return false;
+      curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(curr, word[depth]);
+    }
+    if (!curr->is_end)
+      return false;
+    curr->is_end = false;
+    if (depth == 0 || !curr->children.empty())
+      return depth == 0 && curr->children.empty();
+
+    // the other fingers may hold pruned nodes
+    finger.sync(++epoch);
+    [[maybe_unused]] const auto leaf_depth = depth;
+    while (depth > 0 && !curr->is_end && curr->children.empty()) {
+      finger.truncate(--depth);
+      curr = finger.node(depth);
+      curr->children.erase(static_cast<unsigned char>(word[depth]));
+      TRIES_TRACE_ADD(frees, 1);
+    }
+    // like removeHelper, count a prune only if a node was freed
+    TRIES_TRACE_ADD(prunes, depth < leaf_depth ? 1 : 0);
+    return depth == 0 && !curr->is_end && curr->children.empty();
+  }
 
   [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()); }
 
+  // Nodes, words and size() by depth and the fanout histogram, with the current trace counters
+  [[nodiscard]] TrieStats stats() const
+  {
+    TrieStats result;
+    statsHelper(root.get(), 0, result);
+    result.trace = util::trace_snapshot();
+    return result;
+  }
+
+  // Adds every word of other (a different trie), taking over its subtrees where this trie has
+  // none instead of copying them. other is empty afterwards. Top-level branches present in both
+  // tries are merged in parallel.
+  void unite(HashTrie&& other)
+  {
+    compactor.restart();
+    other.compactor.restart();
+    ++epoch;
+    ++other.epoch;
+    std::vector<std::pair<Node*, Node*>> shared;
+    uniteHelper(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) { uniteHelper(*shared[i].first, *shared[i].second, nullptr); });
+    other.root = std::make_unique<Node>();
+  }
+
+  // Keeps only the words also contained in other (a different trie)
+  void intersect(const HashTrie& other) { filter<true>(other); }
+
+  // Removes every word contained in other (a different trie)
+  void subtract(const HashTrie& other) { filter<false>(other); }
+
+  // Relocates all nodes and their maps into fresh memory in depth-first order,
+  // each map rebuilt with as few buckets as the load factor allows
+  void compact()
+  {
+    compactor.restart();
+    compact_step(std::numeric_limits<std::size_t>::max());
+  }
+
+  // Incremental compact() in slices of at most budget nodes; returns true once a pass is complete.
+  // Removing restarts the pass.
+  bool compact_step(std::size_t budget)
+  {
+    ++epoch;
+    const auto relocate = [](Node& old) {
+      auto fresh = std::make_unique<Node>();
+      fresh->is_end = old.is_end;
+      fresh->children.reserve(old.children.size());
+      for (auto& pair : old.children)
+        fresh->children.emplace(pair.first, std::move(pair.second));
+      return fresh;
+    };
+    return compactor.step(root, budget, relocate, [](Node& node, auto&& visit) {
+      for (auto& pair : node.children)
+        visit(pair.second);
+    });
+  }
+
+  // Calls visit(word) for every stored word in unspecified order.
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    std::string word;
+    forEachHelper(root.get(), word, visit);
+  }
+
 private:
+  using Slot = std::unique_ptr<Node>*;
+
+  // The probes of a lookup are the entries in the bucket of uc
+  static decltype(Node::children)::const_iterator findChild(const Node& node, unsigned char uc)
+  {
+    TRIES_TRACE_ADD(searches, 1);
+    TRIES_TRACE_ADD(probes, node.children.empty() ? 0 : node.children.bucket_size(node.children.bucket(uc)));
+    return node.children.find(uc);
+  }
+
+  // Merges b into a. With shared set, subtrees present in both are collected instead of merged.
+  static void uniteHelper(Node& a, Node& b, std::vector<std::pair<Node*, Node*>>* shared)
+  {
+    a.is_end = a.is_end || b.is_end;
+    for (auto& [symbol, child] : b.children) {
+      const auto [it, inserted] = a.children.try_emplace(symbol);
+      if (inserted)
+        it->second = std::move(child);
+      else if (shared)
+        shared->emplace_back(it->second.get(), child.get());
+      else
+        uniteHelper(*it->second, *child, nullptr);
+    }
+  }
+
+  template<bool Intersect>
+  void filter(const HashTrie& other)
+  {
+    compactor.restart();
+    ++epoch;
+    std::vector<std::pair<Slot, const Node*>> shared;
+    filterHelper<Intersect>(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) {
+      if (filterHelper<Intersect>(**shared[i].first, *shared[i].second, nullptr))
+        shared[i].first->reset();
+    });
+    std::erase_if(root->children, [](const auto& p) noexcept { return !p.second; });
+  }
+
+  // Intersects a with b or subtracts b from a; returns true if a holds no word afterwards.
+  // With shared set, subtrees present in both are collected instead of filtered and a is not
+  // compacted, so the collected slots stay valid.
+  template<bool Intersect>
+  static bool filterHelper(Node& a, const Node& b, std::vector<std::pair<Slot, const Node*>>* shared)
+  {
+    a.is_end = Intersect ? a.is_end && b.is_end : a.is_end && !b.is_end;
+    for (auto& [symbol, child] : a.children) {
+      const auto it = findChild(b, symbol);
+      if (it == b.children.end()) {
+        if (Intersect)
+          child.reset();
+      } else if (shared) {
+        shared->emplace_back(&child, it->second.get());
+      } else if (filterHelper<Intersect>(*child, *it->second, nullptr)) {
+        child.reset();
+      }
+    }
+    if (shared)
+      return false;
+    std::erase_if(a.children, [](const auto& p) noexcept { return !p.second; });
+    return !a.is_end && a.children.empty();
+  }
+
+  template<typename Visitor>
+  static void forEachHelper(const Node* node, std::string& word, Visitor& visit)
+  {
+    if (node->is_end)
+      visit(std::as_const(word));
+    for (auto& pair : node->children) {
+      word.push_back(static_cast<char>(pair.first));
+      forEachHelper(pair.second.get(), word, visit);
+      word.pop_back();
+    }
+  }
+
   bool removeHelper(Node* node, const std::string& word, size_t index)
   {
     if (!node)
       return false;
+    TRIES_TRACE_ADD(nodes_visited, 1);
     if (index == word.size()) {
       if (!node->is_end)
         return false;
       node->is_end = false;
+      if (index > 0 && node->children.empty())
+        TRIES_TRACE_ADD(prunes, 1);
       return node->children.empty();
     }
     auto uc = static_cast<unsigned char>(word[index]);
-    auto it = node->children.find(uc);
+    auto it = findChild(*node, uc);
     if (it == node->children.end()) {
       return false;
     }
     bool shouldPrune = removeHelper(it->second.get(), word, index + 1);
     if (shouldPrune) {
       node->children.erase(uc);
+      TRIES_TRACE_ADD(frees, 1);
       return (!node->is_end && node->children.empty());
     }
     return false;
@@ -97,4 +344,13 @@ private:
       total += sizeHelper(pair.second.get());
     return total;
   }
+
+  static void statsHelper(const Node* node, std::size_t depth, TrieStats& stats)
+  {
+    const auto bytes = sizeof(*node) + node->children.bucket_count() * sizeof(void*) +
+                       node->children.size() * (sizeof(unsigned char) + sizeof(std::unique_ptr<Node>) + 2 * sizeof(void*));
+    stats.add_node(depth, node->children.size(), bytes, node->is_end);
+    for (auto& pair : node->children)
+      statsHelper(pair.second.get(), depth + 1, stats);
+  }
 };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uintptr_t
+#include <cstring> // for std::memset
+#include <new>     // for operator new, std::align_val_t
+#include <utility> // for std::exchange
+
+#if defined(__linux__)
+#include <sys/mman.h> // for mmap, munmap, madvise, MADV_HUGEPAGE
+#endif
+
+namespace util {
+constexpr std::size_t HugePageSize = std::size_t{ 1 } << 21;
+
+// Zeroed memory in whole 2 MiB pages, aligned to 2 MiB.
+//
+// On Linux the region is an anonymous mapping advised with MADV_HUGEPAGE, so transparent huge
+// pages back it and one dTLB entry covers 2 MiB instead of 4 KiB. With huge = false it is advised
+// MADV_NOHUGEPAGE instead, for comparison. Elsewhere, or if the mapping fails, it is aligned heap
+// memory (std::bad_alloc if that fails too).
+// Pages are placed on first touch, so the NUMA node of the writing thread holds them.
+class HugePageRegion
+{
+private:
+  void* base = nullptr;
+  std::size_t bytes = 0;
+  bool mapped = false; // base is an mmap region rather than heap memory
+
+  void allocate()
+  {
+    base = ::operator new(bytes, std::align_val_t{ HugePageSize });
+    std::memset(base, 0, bytes);
+  }
+
+  void release()
+  {
+    if (!base)
+      return;
+#if defined(__linux__)
+    if (mapped)
+      munmap(base, bytes);
+    else
+#endif
+      ::operator delete(base, std::align_val_t{ HugePageSize });
+    base = nullptr;
+  }
+
+public:
+  HugePageRegion() = default;
+
+  HugePageRegion(std::size_t size, bool huge)
+    : bytes((size + HugePageSize - 1) / HugePageSize * HugePageSize)
+  {
+    if (!bytes)
+      return;
+#if defined(__linux__)
+    // map one extra huge page and cut the unaligned ends off
+    void* raw = mmap(nullptr, bytes + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      allocate();
+      return;
+    }
+    const auto begin = reinterpret_cast<std::uintptr_t>(raw);
+    const auto aligned = (begin + HugePageSize - 1) & ~(HugePageSize - 1);
+    if (aligned > begin)
+      munmap(raw, aligned - begin);
+    if (begin + HugePageSize > aligned)
+      munmap(reinterpret_cast<void*>(aligned + bytes), begin + HugePageSize - aligned);
+    base = reinterpret_cast<void*>(aligned);
+    mapped = true;
+    madvise(base, bytes, huge ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#else
+    (void)huge;
+    allocate();
+#endif
+  }
+
+  HugePageRegion(const HugePageRegion&) = delete;
+  HugePageRegion& operator=(const HugePageRegion&) = delete;
+
+  HugePageRegion(HugePageRegion&& other) noexcept
+    : base(std::exchange(other.base, nullptr))
+    , bytes(std::exchange(other.bytes, 0))
+    , mapped(std::exchange(other.mapped, false))
+  {
+  }
+
+  HugePageRegion& operator=(HugePageRegion&& other) noexcept
+  {
+    if (this != &other) {
+      release();
+      base = std::exchange(other.base, nullptr);
+      bytes = std::exchange(other.bytes, 0);
+      mapped = std::exchange(other.mapped, false);
+    }
+    return *this;
+  }
+
+  ~HugePageRegion() { release(); }
+
+  [[nodiscard]] void* data() { return base; }
+  [[nodiscard]] const void* data() const { return base; }
+  [[nodiscard]] std::size_t size() const { return bytes; }
+  explicit operator bool() const { return base != nullptr; }
+};
+}
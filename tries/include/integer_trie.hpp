@@ -0,0 +1,244 @@
+#pragma once
+
+#include <bit>      // for std::popcount, std::countr_zero, std::countl_zero
+#include <concepts> // for std::unsigned_integral
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+#include <limits>   // for std::numeric_limits
+#include <memory>   // for std::unique_ptr, std::make_unique
+#include <vector>   // for std::vector
+
+// Ordered index over fixed-width unsigned integer keys such as ids and timestamps.
+//
+// A key is split into its bytes from the most significant one (big-endian), so the order of the
+// paths is the numeric order and every key ends at depth sizeof(Key): there is no terminator and
+// no end-of-word flag. A node marks its present bytes in a 256-bit bitmap and stores only the
+// present children, at the rank (popcount) of their byte. Nodes of the last level have no
+// children, their bitmap holds the keys.
+template<std::unsigned_integral Key>
+class IntegerTrie
+{
+private:
+  static constexpr std::size_t Depth = sizeof(Key);
+
+  struct Node
+  {
+    std::uint64_t bits[4] = {};
+    std::vector<std::unique_ptr<Node>> children; // by byte, empty on the last level
+
+    [[nodiscard]] bool has(unsigned byte) const { return (bits[byte >> 6] >> (byte & 63)) & 1; }
+
+    // Number of present bytes less than byte, the index of its child
+    [[nodiscard]] std::size_t rank(unsigned byte) const
+    {
+      std::size_t result = 0;
+      for (unsigned w = 0; w < byte >> 6; ++w)
+        result += static_cast<std::size_t>(std::popcount(bits[w]));
+      return result + static_cast<std::size_t>(std::popcount(bits[byte >> 6] & ((std::uint64_t{ 1 } << (byte & 63)) - 1)));
+    }
+
+    // Smallest present byte >= byte, 256 if there is none
+    [[nodiscard]] unsigned next(unsigned byte) const
+    {
+      for (unsigned w = byte >> 6; w < 4; ++w) {
+        const auto word = w == byte >> 6 ? bits[w] & (~std::uint64_t{ 0 } << (byte & 63)) : bits[w];
+        if (word)
+          return w * 64 + static_cast<unsigned>(std::countr_zero(word));
+      }
+      return 256;
+    }
+
+    [[nodiscard]] bool empty() const { return !(bits[0] | bits[1] | bits[2] | bits[3]); }
+
+    void set(unsigned byte) { bits[byte >> 6] |= std::uint64_t{ 1 } << (byte & 63); }
+    void reset(unsigned byte) { bits[byte >> 6] &= ~(std::uint64_t{ 1 } << (byte & 63)); }
+  };
+
+  std::unique_ptr<Node> root;
+  std::size_t num_keys = 0;
+
+  static unsigned byteAt(Key key, std::size_t depth) { return static_cast<unsigned>(key >> (8 * (Depth - 1 - depth))) & 0xFF; }
+
+  static Key append(Key prefix, unsigned byte) { return static_cast<Key>(prefix << 8 | byte); }
+
+public:
+  IntegerTrie()
+    : root(std::make_unique<Node>())
+  {
+  }
+
+  // Insert a key (return true if it was not present)
+  bool insert(Key key)
+  {
+    Node* curr = root.get();
+    for (std::size_t depth = 0; depth + 1 < Depth; ++depth)
+      curr = childOrInsert(*curr, byteAt(key, depth));
+    return insertLast(*curr, byteAt(key, Depth - 1));
+  }
+
+  // Inserts the keys of [first, last), descending from the path of the previous key at the first
+  // byte in which they differ. Correct for any order, but only ascending runs (ids, timestamps)
+  // share the upper levels. Returns the number of keys that were not present.
+  template<typename Iterator>
+  std::size_t insert_sorted(Iterator first, Iterator last)
+  {
+    Node* path[Depth];
+    path[0] = root.get();
+    std::size_t valid = 1; // path[d] is the node of the current key for d < valid
+    Key previous = 0;
+    std::size_t inserted = 0;
+    for (; first != last; ++first) {
+      const Key key = *first;
+      const auto diff = static_cast<Key>(key ^ previous);
+      const auto shared = diff ? static_cast<std::size_t>(std::countl_zero(diff)) / 8 : Depth;
+      if (valid > shared + 1)
+        valid = shared + 1;
+      for (; valid < Depth; ++valid)
+        path[valid] = childOrInsert(*path[valid - 1], byteAt(key, valid - 1));
+      if (insertLast(*path[Depth - 1], byteAt(key, Depth - 1)))
+        ++inserted;
+      previous = key;
+    }
+    return inserted;
+  }
+
+  // Check if a key exists
+  [[nodiscard]] bool contains(Key key) const
+  {
+    const Node* curr = root.get();
+    for (std::size_t depth = 0; depth + 1 < Depth; ++depth) {
+      const auto byte = byteAt(key, depth);
+      if (!curr->has(byte))
+        return false;
+      curr = curr->children[curr->rank(byte)].get();
+    }
+    return curr->has(byteAt(key, Depth - 1));
+  }
+
+  // Remove a key and the nodes left empty (return true if it was present).
+  // Unlike the string tries, the result does not depend on the remaining keys.
+  bool remove(Key key)
+  {
+    Node* path[Depth];
+    path[0] = root.get();
+    for (std::size_t depth = 0; depth + 1 < Depth; ++depth) {
+      const auto byte = byteAt(key, depth);
+      if (!path[depth]->has(byte))
+        return false;
+      path[depth + 1] = path[depth]->children[path[depth]->rank(byte)].get();
+    }
+    auto byte = byteAt(key, Depth - 1);
+    if (!path[Depth - 1]->has(byte))
+      return false;
+    path[Depth - 1]->reset(byte);
+    --num_keys;
+    for (auto depth = Depth - 1; depth > 0 && path[depth]->empty(); --depth) {
+      byte = byteAt(key, depth - 1);
+      auto& parent = *path[depth - 1];
+      parent.children.erase(parent.children.begin() + static_cast<std::ptrdiff_t>(parent.rank(byte)));
+      parent.reset(byte);
+    }
+    return true;
+  }
+
+  // Sets result to the smallest stored key >= key, returns false if there is none
+  bool lower_bound(Key key, Key& result) const { return seek(*root, 0, key, 0, result); }
+
+  // Sets result to the smallest stored key > key, returns false if there is none
+  bool upper_bound(Key key, Key& result) const { return key != std::numeric_limits<Key>::max() && lower_bound(static_cast<Key>(key + 1), result); }
+
+  // Calls visit(key) for every stored key in [low, high] in ascending order
+  template<typename Visitor>
+  void for_each_in_range(Key low, Key high, Visitor&& visit) const
+  {
+    if (low <= high)
+      rangeHelper(*root, 0, 0, low, high, true, true, visit);
+  }
+
+  // Calls visit(key) for every stored key in ascending order
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    for_each_in_range(0, std::numeric_limits<Key>::max(), visit);
+  }
+
+  [[nodiscard]] std::size_t key_count() const { return num_keys; }
+
+  // Approximate memory usage of nodes and child vectors
+  [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()); }
+
+private:
+  static Node* childOrInsert(Node& node, unsigned byte)
+  {
+    const auto index = node.rank(byte);
+    if (!node.has(byte)) {
+      node.set(byte);
+      node.children.insert(node.children.begin() + static_cast<std::ptrdiff_t>(index), std::make_unique<Node>());
+    }
+    return node.children[index].get();
+  }
+
+  bool insertLast(Node& node, unsigned byte)
+  {
+    if (node.has(byte))
+      return false;
+    node.set(byte);
+    ++num_keys;
+    return true;
+  }
+
+  // Smallest key in the subtree of node, whose path so far spells prefix
+  static Key minimum(const Node& node, std::size_t depth, Key prefix)
+  {
+    const Node* curr = &node;
+    for (; depth + 1 < Depth; ++depth) {
+      prefix = append(prefix, curr->next(0));
+      curr = curr->children.front().get();
+    }
+    return append(prefix, curr->next(0));
+  }
+
+  static bool seek(const Node& node, std::size_t depth, Key key, Key prefix, Key& result)
+  {
+    const auto byte = byteAt(key, depth);
+    if (depth + 1 == Depth) {
+      const auto next = node.next(byte);
+      if (next == 256)
+        return false;
+      result = append(prefix, next);
+      return true;
+    }
+    if (node.has(byte) && seek(*node.children[node.rank(byte)], depth + 1, key, append(prefix, byte), result))
+      return true;
+    // every key below a greater byte is greater than key
+    const auto next = node.next(byte + 1);
+    if (next == 256)
+      return false;
+    result = minimum(*node.children[node.rank(next)], depth + 1, append(prefix, next));
+    return true;
+  }
+
+  // tight_low (tight_high): the path so far equals the prefix of low (high), so the bytes below
+  // (above) its byte at depth are out of range
+  template<typename Visitor>
+  static void rangeHelper(const Node& node, std::size_t depth, Key prefix, Key low, Key high, bool tight_low, bool tight_high, Visitor& visit)
+  {
+    const auto first = tight_low ? byteAt(low, depth) : 0u;
+    const auto last = tight_high ? byteAt(high, depth) : 255u;
+    auto index = depth + 1 < Depth ? node.rank(first) : 0;
+    for (auto byte = node.next(first); byte <= last; byte = node.next(byte + 1)) {
+      if (depth + 1 == Depth)
+        visit(append(prefix, byte));
+      else
+        rangeHelper(*node.children[index++], depth + 1, append(prefix, byte), low, high, tight_low && byte == first, tight_high && byte == last, visit);
+    }
+  }
+
+  std::size_t sizeHelper(const Node* node) const
+  {
+    std::size_t total = sizeof(*node) + node->children.capacity() * sizeof(std::unique_ptr<Node>);
+    for (const auto& child : node->children)
+      total += sizeHelper(child.get());
+    return total;
+  }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm> // for std::max, std::min
+#include <array>     // for std::array
+#include <bit>       // for std::bit_width
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+#include <ostream>   // for std::ostream
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h> // for __rdtsc
+#define TRIES_HAS_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // for __rdtsc
+#define TRIES_HAS_RDTSC 1
+#else
+#define TRIES_HAS_RDTSC 0
+#endif
+
+namespace util {
+// Cheap timestamp source for per-operation sampling.
+// Uses the time stamp counter on x86 and falls back to the steady clock elsewhere.
+struct cycle_clock
+{
+  static std::uint64_t now()
+  {
+#if TRIES_HAS_RDTSC
+    return static_cast<std::uint64_t>(__rdtsc());
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+
+  // nanoseconds per tick, calibrated once against the steady clock
+  static double ns_per_tick()
+  {
+#if TRIES_HAS_RDTSC
+    static const double value = [] {
+      const auto start_time = std::chrono::steady_clock::now();
+      const auto start_ticks = now();
+      while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(20)) {
+      }
+      const auto end_ticks = now();
+      const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+      return static_cast<double>(elapsed) / static_cast<double>(std::max<std::uint64_t>(1, end_ticks - start_ticks));
+    }();
+    return value;
+#else
+    return 1.0;
+#endif
+  }
+};
+}
+
+// HDR-style log-linear histogram.
+// Values below 2^(SubBucketBits + 1) are counted exactly, larger values are grouped
+// into 2^SubBucketBits linear sub-buckets per power of two (relative error < 2^-SubBucketBits).
+class LatencyHistogram
+{
+private:
+  static constexpr unsigned SubBucketBits = 7;
+  static constexpr std::uint64_t SubBucketCount = std::uint64_t{ 1 } << SubBucketBits;
+  // exact buckets, then one group of sub-buckets per bit width from SubBucketBits + 2 to 64
+  static constexpr std::size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+  std::vector<std::uint64_t> counts = std::vector<std::uint64_t>(BucketCount);
+  std::uint64_t total = 0;
+  std::uint64_t min_value = UINT64_MAX;
+  std::uint64_t max_value = 0;
+
+  static std::size_t bucketIndex(std::uint64_t value)
+  {
+    if (value < 2 * SubBucketCount)
+      return value;
+    const auto shift = static_cast<unsigned>(std::bit_width(value)) - SubBucketBits - 1;
+    return (shift + 1) * SubBucketCount + (value >> shift) - SubBucketCount;
+  }
+
+  // highest value that maps into the given bucket
+  static std::uint64_t bucketValue(std::size_t index)
+  {
+    if (index < 2 * SubBucketCount)
+      return index;
+    const auto shift = index / SubBucketCount - 1;
+    const auto mantissa = index % SubBucketCount + SubBucketCount;
+    return ((mantissa + 1) << shift) - 1;
+  }
+
+public:
+  void record(std::uint64_t value)
+  {
+    ++counts[bucketIndex(value)];
+    ++total;
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+  }
+
+  void merge(const LatencyHistogram& other)
+  {
+    for (std::size_t i = 0; i < BucketCount; ++i)
+      counts[i] += other.counts[i];
+    total += other.total;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+  }
+
+  [[nodiscard]] std::uint64_t count() const { return total; }
+
+  [[nodiscard]] std::uint64_t max() const { return max_value; }
+
+  [[nodiscard]] std::uint64_t min() const { return total ? min_value : 0; }
+
+  // value at the given quantile in [0, 1], e.g. 0.99 for p99
+  [[nodiscard]] std::uint64_t percentile(double quantile) const
+  {
+    if (!total)
+      return 0;
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(quantile * static_cast<double>(total) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+      seen += counts[i];
+      if (seen >= rank)
+        return std::min(bucketValue(i), max_value);
+    }
+    return max_value;
+  }
+};
+
+// Latency histograms split by operation (insert, contains, remove)
+// and outcome (hit = the word was present before the operation).
+// Samples are recorded in util::cycle_clock ticks and reported in nanoseconds.
+class LatencyRecorder
+{
+public:
+  enum Operation : std::size_t
+  {
+    Insert = 0,
+    Contains = 1,
+    Remove = 2
+  };
+
+private:
+  std::array<std::array<LatencyHistogram, 2>, 3> histograms{};
+
+public:
+  static constexpr const char* operationName(std::size_t operation)
+  {
+    constexpr const char* names[] = { "insert", "contains", "remove" };
+    return names[operation];
+  }
+
+  // hit: the word was present before the operation. The return values of insert and contains
+  // tell this, that of remove does not (true only if the trie is empty afterwards).
+  void record(std::size_t operation, bool hit, std::uint64_t ticks) { histograms[operation][hit ? 0 : 1].record(ticks); }
+
+  void merge(const LatencyRecorder& other)
+  {
+    for (std::size_t op = 0; op < 3; ++op)
+      for (std::size_t outcome = 0; outcome < 2; ++outcome)
+        histograms[op][outcome].merge(other.histograms[op][outcome]);
+  }
+
+  [[nodiscard]] const LatencyHistogram& histogram(std::size_t operation, bool hit) const { return histograms[operation][hit ? 0 : 1]; }
+
+  static void writeCsvHeader(std::ostream& os, const std::string& key_columns)
+  {
+    os << key_columns << (key_columns.empty() ? "" : ",") << "operation,outcome,count,p50_ns,p99_ns,p999_ns,max_ns\n";
+  }
+
+  // one csv row per non-empty (operation, outcome) pair, prefixed by key_values
+  void writeCsv(std::ostream& os, const std::string& key_values) const
+  {
+    const auto ns = util::cycle_clock::ns_per_tick();
+    const auto to_ns = [ns](std::uint64_t ticks) { return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns + 0.5); };
+    for (std::size_t op = 0; op < 3; ++op) {
+      for (std::size_t outcome = 0; outcome < 2; ++outcome) {
+        const auto& h = histograms[op][outcome];
+        if (!h.count())
+          continue;
+        os << key_values << (key_values.empty() ? "" : ",") << operationName(op) << ',' << (outcome == 0 ? "hit" : "miss") << ',' << h.count() << ','
+           << to_ns(h.percentile(0.5)) << ',' << to_ns(h.percentile(0.99)) << ',' << to_ns(h.percentile(0.999)) << ',' << to_ns(h.max()) << '\n';
+      }
+    }
+  }
+};
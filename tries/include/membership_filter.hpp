@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm> // for std::max, std::sort, std::unique
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <string>    // for std::string
+#include <utility>   // for std::forward, std::move
+#include <vector>    // for std::vector
+
+#include "array_trie.hpp" // for util::index
+
+namespace util {
+constexpr std::uint64_t
+mix64(std::uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Hashes the util::index symbols of a word, so words that ArrayTrie treats as equal hash equally.
+// Filters in front of the other variants only see a few more false positives from it.
+inline std::uint64_t
+wordHash(const std::string& word)
+{
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  for (char c : word)
+    h = (h ^ util::index(c)) * 0x100000001b3ULL;
+  return mix64(h ^ word.size());
+}
+
+// maps x uniformly to [0, n)
+constexpr std::size_t
+reduce(std::uint32_t x, std::size_t n)
+{
+  return (static_cast<std::uint64_t>(x) * n) >> 32;
+}
+}
+
+// Blocked Bloom filter: all bits of a key lie in one 512-bit block (one cache line).
+// Supports inserts but no removes, so it is rebuilt when removed keys pile up.
+class BlockedBloomFilter
+{
+private:
+  static constexpr std::size_t WordsPerBlock = 8;
+  static constexpr unsigned BitsPerKey = 8;
+
+  std::vector<std::uint64_t> blocks;
+
+public:
+  // bits_per_key = 12 keeps the false positive rate below 1%
+  explicit BlockedBloomFilter(std::size_t expected_keys = 0, std::size_t bits_per_key = 12) { reset(expected_keys, bits_per_key); }
+
+  void reset(std::size_t expected_keys, std::size_t bits_per_key = 12)
+  {
+    const auto num_blocks = std::max<std::size_t>(1, (expected_keys * bits_per_key + 511) / 512);
+    blocks.assign(num_blocks * WordsPerBlock, 0);
+  }
+
+  void insert(std::uint64_t hash)
+  {
+    auto* block = &blocks[util::reduce(static_cast<std::uint32_t>(hash >> 32), blocks.size() / WordsPerBlock) * WordsPerBlock];
+    const auto a = static_cast<std::uint32_t>(hash);
+    const auto b = static_cast<std::uint32_t>(util::mix64(hash)) | 1u;
+    for (unsigned i = 0; i < BitsPerKey; ++i) {
+      const auto bit = (a + i * b) & 511u;
+      block[bit >> 6] |= std::uint64_t{ 1 } << (bit & 63u);
+    }
+  }
+
+  [[nodiscard]] bool may_contain(std::uint64_t hash) const
+  {
+    const auto* block = &blocks[util::reduce(static_cast<std::uint32_t>(hash >> 32), blocks.size() / WordsPerBlock) * WordsPerBlock];
+    const auto a = static_cast<std::uint32_t>(hash);
+    const auto b = static_cast<std::uint32_t>(util::mix64(hash)) | 1u;
+    for (unsigned i = 0; i < BitsPerKey; ++i) {
+      const auto bit = (a + i * b) & 511u;
+      if (!(block[bit >> 6] & (std::uint64_t{ 1 } << (bit & 63u))))
+        return false;
+    }
+    return true;
+  }
+
+  [[nodiscard]] std::size_t size() const { return sizeof(*this) + blocks.capacity() * sizeof(std::uint64_t); }
+};
+
+// Xor filter with 8-bit fingerprints (about 9.8 bits per key, 0.4% false positives) for static key sets.
+class XorFilter
+{
+private:
+  std::uint64_t seed = 0;
+  std::size_t segment_length = 1;
+  std::vector<std::uint8_t> fingerprints = std::vector<std::uint8_t>(3, 0);
+
+  [[nodiscard]] std::size_t position(std::uint64_t h, unsigned i) const
+  {
+    const auto rotated = (h << (21 * i)) | (h >> ((64 - 21 * i) & 63u));
+    return i * segment_length + util::reduce(static_cast<std::uint32_t>(rotated), segment_length);
+  }
+
+  static std::uint8_t fingerprint(std::uint64_t h) { return static_cast<std::uint8_t>(h ^ (h >> 32)); }
+
+public:
+  // Builds the filter for the given hashes (duplicates allowed). Returns false if peeling failed for all seeds.
+  bool build(std::vector<std::uint64_t> keys)
+  {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    const auto capacity = 32 + keys.size() * 123 / 100;
+    segment_length = capacity / 3;
+    fingerprints.assign(3 * segment_length, 0);
+
+    std::vector<std::uint8_t> count(fingerprints.size());
+    std::vector<std::uint64_t> xor_mask(fingerprints.size());
+    std::vector<std::size_t> queue;
+    std::vector<std::pair<std::uint64_t, std::size_t>> stack; // hash and the position it was peeled from
+    for (std::uint64_t attempt = 1; attempt <= 64; ++attempt) {
+      seed = util::mix64(attempt);
+      std::fill(count.begin(), count.end(), 0);
+      std::fill(xor_mask.begin(), xor_mask.end(), 0);
+      for (const auto key : keys) {
+        const auto h = util::mix64(key + seed);
+        for (unsigned i = 0; i < 3; ++i) {
+          const auto p = position(h, i);
+          xor_mask[p] ^= h;
+          ++count[p];
+        }
+      }
+
+      queue.clear();
+      stack.clear();
+      for (std::size_t p = 0; p < count.size(); ++p)
+        if (count[p] == 1)
+          queue.push_back(p);
+      while (!queue.empty()) {
+        const auto p = queue.back();
+        queue.pop_back();
+        if (count[p] != 1)
+          continue;
+        const auto h = xor_mask[p];
+        stack.emplace_back(h, p);
+        for (unsigned i = 0; i < 3; ++i) {
+          const auto q = position(h, i);
+          xor_mask[q] ^= h;
+          if (--count[q] == 1)
+            queue.push_back(q);
+        }
+      }
+      if (stack.size() != keys.size())
+        continue; // a cycle remained, retry with another seed
+
+      for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        const auto [h, p] = *it;
+        auto f = fingerprint(h);
+        for (unsigned i = 0; i < 3; ++i)
+          if (const auto q = position(h, i); q != p)
+            f ^= fingerprints[q];
+        fingerprints[p] = f;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] bool may_contain(std::uint64_t key) const
+  {
+    const auto h = util::mix64(key + seed);
+    return fingerprint(h) == (fingerprints[position(h, 0)] ^ fingerprints[position(h, 1)] ^ fingerprints[position(h, 2)]);
+  }
+
+  [[nodiscard]] std::size_t size() const { return sizeof(*this) + fingerprints.capacity(); }
+};
+
+// Puts a blocked Bloom filter in front of any mutable variant, so most lookups of absent words
+// are answered without walking the trie.
+//
+// Inserts are added to the filter. Removed words keep their bits set, so the filter is rebuilt from
+// the trie contents once the removes since the last rebuild reach a quarter of the words, and
+// resized once the words outgrow it.
+template<typename Trie>
+class FilteredTrie
+{
+private:
+  static constexpr std::size_t MinCapacity = 1024;
+
+  Trie trie;
+  BlockedBloomFilter filter;
+  std::size_t capacity = MinCapacity; // words the filter is sized for
+  std::size_t words = 0;              // words at the last rebuild plus new inserts (removes are not known to succeed)
+  std::size_t removes = 0;            // removes since the last rebuild
+
+public:
+  template<typename... Args>
+  explicit FilteredTrie(Args&&... args)
+    : trie(std::forward<Args>(args)...)
+    , filter(MinCapacity)
+  {
+  }
+
+  bool insert(const std::string& word)
+  {
+    if (!trie.insert(word))
+      return false;
+    filter.insert(util::wordHash(word));
+    if (++words > capacity)
+      rebuild();
+    return true;
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const { return filter.may_contain(util::wordHash(word)) && trie.contains(word); }
+
+  bool remove(const std::string& word)
+  {
+    const bool result = trie.remove(word);
+    if (++removes * 4 > std::max(words, MinCapacity))
+      rebuild();
+    return result;
+  }
+
+  [[nodiscard]] std::size_t size() const { return trie.size() + filter.size(); }
+
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    trie.for_each(std::forward<Visitor>(visit));
+  }
+
+  // Recounts the words and refills a filter with room to grow to twice that many
+  void rebuild()
+  {
+    words = 0;
+    trie.for_each([this](const std::string&) { ++words; });
+    capacity = std::max(2 * words, MinCapacity);
+    filter.reset(capacity);
+    trie.for_each([this](const std::string& word) { filter.insert(util::wordHash(word)); });
+    removes = 0;
+  }
+};
+
+// Puts a xor filter in front of a read-only dictionary (e.g. Dawg).
+template<typename Dictionary>
+class XorFilteredDictionary
+{
+private:
+  Dictionary dictionary;
+  XorFilter filter;
+  bool filtered = false; // false if the filter could not be built, every lookup goes to the dictionary then
+
+public:
+  explicit XorFilteredDictionary(Dictionary dictionary_)
+    : dictionary(std::move(dictionary_))
+  {
+    std::vector<std::uint64_t> hashes;
+    dictionary.for_each([&hashes](const std::string& word) { hashes.push_back(util::wordHash(word)); });
+    filtered = filter.build(std::move(hashes));
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const { return (!filtered || filter.may_contain(util::wordHash(word))) && dictionary.contains(word); }
+
+  [[nodiscard]] std::size_t size() const { return dictionary.size() + filter.size(); }
+
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    dictionary.for_each(std::forward<Visitor>(visit));
+  }
+};
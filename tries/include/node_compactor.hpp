@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef> // for std::size_t
+#include <memory>  // for std::unique_ptr
+#include <utility> // for std::move
+#include <vector>  // for std::vector
+
+// Incremental compaction of a trie whose nodes are owned by std::unique_ptr.
+//
+// A pass relocates the nodes into fresh allocations in depth-first preorder, a bounded number per
+// step. Every subtree, in particular the single-child chain at the end of a word, then lies in
+// consecutive memory like in a van Emde Boas layout; a breadth-first order measured slower for
+// root-to-leaf lookups because it spreads each path over all levels.
+// The old nodes are only freed after all nodes have been relocated, so the allocator cannot hand
+// their scattered memory straight back to the next relocation; freeing is budgeted as well.
+// The stack holds pointers to the owning unique_ptrs, so the trie must call restart() whenever it
+// frees nodes or moves child slots (e.g. growing a child vector).
+template<typename Node>
+class NodeCompactor
+{
+private:
+  std::vector<std::unique_ptr<Node>*> pending; // owners of the nodes still to relocate
+  std::vector<std::unique_ptr<Node>> retired;
+  bool in_pass = false;
+
+public:
+  // Drops the pending relocations, the next step starts a new pass
+  void restart()
+  {
+    pending.clear();
+    in_pass = false;
+  }
+
+  // Relocates and frees at most budget nodes. relocate(old) returns the fresh copy of a node,
+  // for_each_child(node, f) calls f with the owner of every child. Returns true once the pass is complete.
+  template<typename Relocate, typename ForEachChild>
+  bool step(std::unique_ptr<Node>& root, std::size_t budget, Relocate&& relocate, ForEachChild&& for_each_child)
+  {
+    if (!in_pass) {
+      pending.push_back(&root);
+      in_pass = true;
+    }
+    for (; budget && !pending.empty(); --budget) {
+      auto& owner = *pending.back();
+      pending.pop_back();
+      retired.push_back(std::move(owner));
+      owner = relocate(*retired.back());
+      for_each_child(*owner, [this](std::unique_ptr<Node>& child) { pending.push_back(&child); });
+    }
+    if (!pending.empty())
+      return false;
+    for (; budget && !retired.empty(); --budget)
+      retired.pop_back();
+    if (!retired.empty())
+      return false;
+    pending.shrink_to_fit();
+    retired.shrink_to_fit();
+    in_pass = false;
+    return true;
+  }
+};
@@ -0,0 +1,686 @@
+#pragma once
+
+#include <algorithm>     // for std::sort, std::min
+#include <cstddef>       // for std::size_t
+#include <cstdint>       // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstring>       // for std::memcpy, std::memmove, std::memset
+#include <string>        // for std::string
+#include <string_view>   // for std::string_view
+#include <tuple>         // for std::tie
+#include <unordered_map> // for std::unordered_map
+#include <utility>       // for std::move, std::pair, std::as_const
+#include <vector>        // for std::vector
+
+#if defined(_WIN32)
+#include <fcntl.h>    // for _O_RDWR, _O_CREAT, _O_BINARY
+#include <io.h>       // for _open, _read, _write, _lseeki64, _commit, _close
+#include <sys/stat.h> // for _S_IREAD, _S_IWRITE
+#else
+#include <fcntl.h>  // for open, O_RDWR, O_CREAT
+#include <unistd.h> // for pread, pwrite, fsync, close
+#endif
+
+namespace util {
+// File accessed in whole pages at explicit offsets (pread/pwrite)
+class PageFile
+{
+private:
+  int fd = -1;
+
+public:
+  PageFile() = default;
+  PageFile(const PageFile&) = delete;
+  PageFile& operator=(const PageFile&) = delete;
+
+  ~PageFile()
+  {
+#if defined(_WIN32)
+    if (fd >= 0)
+      _close(fd);
+#else
+    if (fd >= 0)
+      ::close(fd);
+#endif
+  }
+
+  bool open(const std::string& path)
+  {
+#if defined(_WIN32)
+    fd = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+#endif
+    return fd >= 0;
+  }
+
+  // Returns the number of bytes read, less than size only at the end of the file
+  std::size_t read(std::uint64_t offset, char* data, std::size_t size) const
+  {
+    std::size_t done = 0;
+    while (done < size) {
+#if defined(_WIN32)
+      if (_lseeki64(fd, static_cast<long long>(offset + done), SEEK_SET) < 0)
+        break;
+      const auto n = _read(fd, data + done, static_cast<unsigned>(size - done));
+#else
+      const auto n = ::pread(fd, data + done, size - done, static_cast<off_t>(offset + done));
+#endif
+      if (n <= 0)
+        break;
+      done += static_cast<std::size_t>(n);
+    }
+    return done;
+  }
+
+  bool write(std::uint64_t offset, const char* data, std::size_t size)
+  {
+    std::size_t done = 0;
+    while (done < size) {
+#if defined(_WIN32)
+      if (_lseeki64(fd, static_cast<long long>(offset + done), SEEK_SET) < 0)
+        return false;
+      const auto n = _write(fd, data + done, static_cast<unsigned>(size - done));
+#else
+      const auto n = ::pwrite(fd, data + done, size - done, static_cast<off_t>(offset + done));
+#endif
+      if (n <= 0)
+        return false;
+      done += static_cast<std::size_t>(n);
+    }
+    return true;
+  }
+
+  bool sync()
+  {
+#if defined(_WIN32)
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+  }
+};
+}
+
+struct PageCacheStats
+{
+  std::size_t hits = 0;
+  std::size_t misses = 0; // page reads
+  std::size_t writes = 0; // page writes
+
+  [[nodiscard]] double hit_rate() const { return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 1.0; }
+};
+
+// Fixed number of page frames in front of a PageFile with clock (second chance) replacement.
+//
+// Pages are pinned while in use and never evicted then. Modified pages are written back lazily:
+// when a dirty page has to be evicted, all dirty unpinned pages are written in one batch in page
+// order, so the many small modifications of inserts and removes reach the disk together.
+template<std::size_t PageSize>
+class BufferPool
+{
+private:
+  static constexpr std::uint32_t NoPage = ~std::uint32_t{ 0 };
+
+  struct Frame
+  {
+    std::uint32_t page = NoPage;
+    unsigned pins = 0;
+    bool referenced = false;
+    bool dirty = false;
+  };
+
+  util::PageFile& file;
+  std::vector<char> memory;
+  std::vector<Frame> frames;
+  std::unordered_map<std::uint32_t, std::uint32_t> table; // page -> frame
+  std::size_t hand = 0;
+  PageCacheStats counters;
+  bool failed = false;
+
+  char* data(std::uint32_t frame) { return memory.data() + std::size_t{ frame } * PageSize; }
+
+  bool writeFrame(std::uint32_t frame)
+  {
+    if (!file.write(std::uint64_t{ frames[frame].page } * PageSize, data(frame), PageSize))
+      return failed = true, false;
+    frames[frame].dirty = false;
+    ++counters.writes;
+    return true;
+  }
+
+  // Writes all dirty unpinned frames in page order
+  void writeBack()
+  {
+    std::vector<std::uint32_t> dirty;
+    for (std::uint32_t f = 0; f < frames.size(); ++f)
+      if (frames[f].dirty && !frames[f].pins)
+        dirty.push_back(f);
+    std::sort(dirty.begin(), dirty.end(), [this](std::uint32_t a, std::uint32_t b) { return frames[a].page < frames[b].page; });
+    for (const auto f : dirty)
+      writeFrame(f);
+  }
+
+  // Returns a free frame, evicting the first unreferenced unpinned page the clock hand meets
+  std::uint32_t victim()
+  {
+    for (std::size_t step = 0; step < 2 * frames.size() + 1; ++step, hand = (hand + 1) % frames.size()) {
+      auto& frame = frames[hand];
+      if (frame.pins)
+        continue;
+      if (frame.page != NoPage && frame.referenced) {
+        frame.referenced = false;
+        continue;
+      }
+      const auto f = static_cast<std::uint32_t>(hand);
+      hand = (hand + 1) % frames.size();
+      if (frame.page != NoPage) {
+        if (frame.dirty)
+          writeBack();
+        if (frame.dirty)
+          return NoPage;
+        table.erase(frame.page);
+        frame.page = NoPage;
+      }
+      return f;
+    }
+    return failed = true, NoPage; // every frame is pinned
+  }
+
+public:
+  BufferPool(util::PageFile& file_, std::size_t capacity)
+    : file(file_)
+    , memory(capacity * PageSize)
+    , frames(capacity)
+  {
+  }
+
+  // Pins page and returns its frame, reading it from the file unless create is set,
+  // in which case the page starts zeroed and dirty. Returns nullptr on failure.
+  char* pin(std::uint32_t page, bool create = false)
+  {
+    if (const auto it = table.find(page); it != table.end()) {
+      auto& frame = frames[it->second];
+      ++frame.pins;
+      frame.referenced = true;
+      ++counters.hits;
+      return data(it->second);
+    }
+    const auto f = victim();
+    if (f == NoPage)
+      return nullptr;
+    if (create) {
+      std::memset(data(f), 0, PageSize);
+    } else {
+      ++counters.misses;
+      if (file.read(std::uint64_t{ page } * PageSize, data(f), PageSize) != PageSize)
+        return failed = true, nullptr;
+    }
+    frames[f] = { page, 1, true, create };
+    table.emplace(page, f);
+    return data(f);
+  }
+
+  void unpin(std::uint32_t page, bool dirty)
+  {
+    auto& frame = frames[table.at(page)];
+    --frame.pins;
+    frame.dirty = frame.dirty || dirty;
+  }
+
+  // Writes every dirty page
+  bool flush()
+  {
+    writeBack();
+    return !failed;
+  }
+
+  [[nodiscard]] bool good() const { return !failed; }
+  [[nodiscard]] const PageCacheStats& stats() const { return counters; }
+  void reset_stats() { counters = {}; }
+  [[nodiscard]] std::size_t capacity() const { return frames.size(); }
+
+  [[nodiscard]] std::size_t size() const
+  {
+    return sizeof(*this) + memory.capacity() + frames.capacity() * sizeof(Frame) + table.size() * (sizeof(std::pair<std::uint32_t, std::uint32_t>) + 2 * sizeof(void*)) +
+           table.bucket_count() * sizeof(void*);
+  }
+};
+
+// Disk-backed dictionary for word sets larger than memory (string B-tree / B-trie style).
+//
+// Words are packed into fixed-size pages of a B+-tree: each leaf holds the sorted words of one
+// key range, i.e. one subtrie, inner pages hold shortest separating prefixes. A lookup touches one
+// page per level, O(log_B n) pages. All page accesses go through a bounded BufferPool.
+//
+// Pages are slotted: a 16-byte header, an array of 16-bit entry offsets growing forward and the
+// entries (16-bit length, key bytes, and for inner pages a 32-bit child) growing backward from the
+// end. Removes leave pages underfull instead of merging them (lazy deletion). Page 0 is the file
+// header. Modifications reach the file in batches, at the latest on flush() or destruction.
+class PagedTrie
+{
+public:
+  static constexpr std::size_t PageSize = 4096;
+  static constexpr std::size_t MaxWordLength = 1024; // longer words are rejected by insert
+
+private:
+  static constexpr std::uint32_t Magic = 0x49525450; // "PTRI"
+  static constexpr std::uint8_t Leaf = 1;
+  static constexpr std::uint8_t Inner = 2;
+  static constexpr std::size_t HeaderSize = 16;
+
+  struct Entry
+  {
+    std::string key;
+    std::uint32_t child = 0; // inner pages only
+  };
+
+  // View of a node page: kind at 0, count at 2, data_begin at 4, link at 8
+  // (leaf: next leaf or 0, inner: leftmost child)
+  class Node
+  {
+  private:
+    char* page;
+
+    template<typename T>
+    [[nodiscard]] T load(std::size_t offset) const
+    {
+      T value;
+      std::memcpy(&value, page + offset, sizeof(T));
+      return value;
+    }
+
+    template<typename T>
+    void store(std::size_t offset, T value)
+    {
+      std::memcpy(page + offset, &value, sizeof(T));
+    }
+
+    [[nodiscard]] std::size_t offset(std::size_t i) const { return load<std::uint16_t>(HeaderSize + 2 * i); }
+
+  public:
+    explicit Node(char* page_)
+      : page(page_)
+    {
+    }
+
+    [[nodiscard]] bool leaf() const { return load<std::uint8_t>(0) == Leaf; }
+    [[nodiscard]] std::size_t count() const { return load<std::uint16_t>(2); }
+    [[nodiscard]] std::uint32_t link() const { return load<std::uint32_t>(8); }
+    void set_link(std::uint32_t link) { store<std::uint32_t>(8, link); }
+
+    [[nodiscard]] std::string_view key(std::size_t i) const { return { page + offset(i) + 2, load<std::uint16_t>(offset(i)) }; }
+    [[nodiscard]] std::uint32_t child(std::size_t i) const { return load<std::uint32_t>(offset(i) + 2 + key(i).size()); }
+
+    // First entry whose key is not less than word
+    [[nodiscard]] std::size_t lower_bound(std::string_view word) const
+    {
+      std::size_t lo = 0, hi = count();
+      while (lo < hi) {
+        const auto mid = (lo + hi) / 2;
+        if (key(mid) < word)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      return lo;
+    }
+
+    // Child of an inner page covering word
+    [[nodiscard]] std::uint32_t find_child(std::string_view word) const
+    {
+      std::size_t lo = 0, hi = count(); // first separator greater than word
+      while (lo < hi) {
+        const auto mid = (lo + hi) / 2;
+        if (key(mid) <= word)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      return lo == 0 ? link() : child(lo - 1);
+    }
+
+    [[nodiscard]] std::vector<Entry> entries() const
+    {
+      std::vector<Entry> result(count());
+      for (std::size_t i = 0; i < result.size(); ++i)
+        result[i] = { std::string(key(i)), leaf() ? 0 : child(i) };
+      return result;
+    }
+
+    // Rewrites the page with the given entries; returns false if they do not fit
+    bool assign(std::uint8_t kind, std::uint32_t link, const std::vector<Entry>& entries)
+    {
+      std::size_t end = PageSize;
+      if (HeaderSize + 2 * entries.size() + bytes(kind, entries) > PageSize)
+        return false;
+      std::memset(page, 0, HeaderSize);
+      store<std::uint8_t>(0, kind);
+      store<std::uint16_t>(2, static_cast<std::uint16_t>(entries.size()));
+      set_link(link);
+      for (std::size_t i = 0; i < entries.size(); ++i) {
+        end -= entrySize(kind, entries[i].key.size());
+        write(end, kind, entries[i]);
+        store<std::uint16_t>(HeaderSize + 2 * i, static_cast<std::uint16_t>(end));
+      }
+      store<std::uint16_t>(4, static_cast<std::uint16_t>(end));
+      return true;
+    }
+
+    // Inserts an entry at position i; returns false if the page is full
+    bool insert(std::size_t i, const Entry& entry)
+    {
+      const auto kind = load<std::uint8_t>(0);
+      const auto n = count();
+      const auto size = entrySize(kind, entry.key.size());
+      auto begin = std::size_t{ load<std::uint16_t>(4) };
+      if (begin < HeaderSize + 2 * (n + 1) + size) {
+        // reclaim the space of removed entries first
+        auto all = entries();
+        if (HeaderSize + 2 * (n + 1) + bytes(kind, all) + size > PageSize)
+          return false;
+        assign(kind, link(), all);
+        begin = load<std::uint16_t>(4);
+      }
+      begin -= size;
+      write(begin, kind, entry);
+      std::memmove(page + HeaderSize + 2 * (i + 1), page + HeaderSize + 2 * i, 2 * (n - i));
+      store<std::uint16_t>(HeaderSize + 2 * i, static_cast<std::uint16_t>(begin));
+      store<std::uint16_t>(2, static_cast<std::uint16_t>(n + 1));
+      store<std::uint16_t>(4, static_cast<std::uint16_t>(begin));
+      return true;
+    }
+
+    // Removes the entry at position i, its bytes are reclaimed by the next compaction
+    void erase(std::size_t i)
+    {
+      const auto n = count();
+      std::memmove(page + HeaderSize + 2 * i, page + HeaderSize + 2 * (i + 1), 2 * (n - i - 1));
+      store<std::uint16_t>(2, static_cast<std::uint16_t>(n - 1));
+    }
+
+    static std::size_t entrySize(std::uint8_t kind, std::size_t key_size) { return 2 + key_size + (kind == Inner ? 4 : 0); }
+
+    static std::size_t bytes(std::uint8_t kind, const std::vector<Entry>& entries)
+    {
+      std::size_t total = 0;
+      for (const auto& entry : entries)
+        total += entrySize(kind, entry.key.size());
+      return total;
+    }
+
+  private:
+    void write(std::size_t at, std::uint8_t kind, const Entry& entry)
+    {
+      store<std::uint16_t>(at, static_cast<std::uint16_t>(entry.key.size()));
+      std::memcpy(page + at + 2, entry.key.data(), entry.key.size());
+      if (kind == Inner)
+        store<std::uint32_t>(at + 2 + entry.key.size(), entry.child);
+    }
+  };
+
+  // Pin of a page, released on destruction
+  class PinnedPage
+  {
+  private:
+    BufferPool<PageSize>* pool;
+    std::uint32_t page;
+    char* frame;
+    bool dirty = false;
+
+  public:
+    PinnedPage(BufferPool<PageSize>& pool_, std::uint32_t page_, bool create = false)
+      : pool(&pool_)
+      , page(page_)
+      , frame(pool_.pin(page_, create))
+    {
+    }
+
+    PinnedPage(const PinnedPage&) = delete;
+    PinnedPage& operator=(const PinnedPage&) = delete;
+
+    ~PinnedPage()
+    {
+      if (frame)
+        pool->unpin(page, dirty);
+    }
+
+    explicit operator bool() const { return frame != nullptr; }
+    [[nodiscard]] Node node() const { return Node(frame); }
+    Node modify()
+    {
+      dirty = true;
+      return Node(frame);
+    }
+  };
+
+  std::string path;
+  util::PageFile file;
+  mutable BufferPool<PageSize> pool;
+  std::uint32_t root = 1;
+  std::uint32_t page_count = 2;
+  std::uint32_t height = 1; // levels including the leaves
+  std::uint64_t words = 0;
+  bool header_dirty = false;
+
+  std::uint32_t allocate()
+  {
+    header_dirty = true;
+    return page_count++;
+  }
+
+  // Splits entries over page (keeping link) and a new right sibling; returns the separator and the sibling
+  std::pair<std::string, std::uint32_t> split(PinnedPage& page, std::uint8_t kind, std::vector<Entry> entries)
+  {
+    const auto right_id = allocate();
+    PinnedPage right(pool, right_id, true);
+    auto left = page.modify();
+
+    // split at half of the bytes
+    const auto total = Node::bytes(kind, entries);
+    std::size_t mid = 0, bytes = 0;
+    while (mid + 1 < entries.size() && bytes + Node::entrySize(kind, entries[mid].key.size()) <= total / 2)
+      bytes += Node::entrySize(kind, entries[mid++].key.size());
+    mid = std::max<std::size_t>(mid, 1);
+
+    if (kind == Leaf) {
+      // shortest prefix of the first right key that still sorts after the last left key
+      const auto& last = entries[mid - 1].key;
+      const auto& first = entries[mid].key;
+      std::size_t common = 0;
+      while (common < last.size() && last[common] == first[common])
+        ++common;
+      auto separator = first.substr(0, common + 1);
+      right.modify().assign(Leaf, left.link(), { entries.begin() + static_cast<std::ptrdiff_t>(mid), entries.end() });
+      left.assign(Leaf, right_id, { entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(mid) });
+      return { std::move(separator), right_id };
+    }
+    // the middle separator moves up, its child becomes the leftmost child of the right page
+    auto separator = std::move(entries[mid].key);
+    right.modify().assign(Inner, entries[mid].child, { entries.begin() + static_cast<std::ptrdiff_t>(mid) + 1, entries.end() });
+    left.assign(Inner, left.link(), { entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(mid) });
+    return { std::move(separator), right_id };
+  }
+
+  // Descends to the leaf covering word, recording the inner pages on the way; returns 0 on failure
+  std::uint32_t findLeaf(std::string_view word, std::vector<std::uint32_t>* inner) const
+  {
+    auto id = root;
+    for (std::uint32_t level = 1; level < height; ++level) {
+      PinnedPage page(pool, id);
+      if (!page)
+        return 0;
+      if (inner)
+        inner->push_back(id);
+      id = page.node().find_child(word);
+    }
+    return id;
+  }
+
+  bool writeHeader()
+  {
+    char header[PageSize] = {};
+    std::memcpy(header, &Magic, 4);
+    std::memcpy(header + 4, &root, 4);
+    std::memcpy(header + 8, &page_count, 4);
+    std::memcpy(header + 12, &height, 4);
+    std::memcpy(header + 16, &words, 8);
+    header_dirty = false;
+    return file.write(0, header, PageSize);
+  }
+
+public:
+  // The file is opened by open(); pool_pages frames of PageSize bytes are kept in memory
+  explicit PagedTrie(std::string path_, std::size_t pool_pages = 256)
+    : path(std::move(path_))
+    , pool(file, std::max<std::size_t>(pool_pages, 16))
+  {
+  }
+
+  PagedTrie(const PagedTrie&) = delete;
+  PagedTrie& operator=(const PagedTrie&) = delete;
+
+  ~PagedTrie() { flush(); }
+
+  // Opens the file, creating an empty dictionary if it holds none. Returns false on I/O errors
+  // or if the file is no PagedTrie.
+  bool open()
+  {
+    if (!file.open(path))
+      return false;
+    char header[PageSize];
+    const auto read = file.read(0, header, PageSize);
+    if (read == 0) {
+      PinnedPage leaf(pool, root, true);
+      leaf.modify().assign(Leaf, 0, {});
+      return writeHeader();
+    }
+    std::uint32_t magic = 0;
+    std::memcpy(&magic, header, 4);
+    if (read != PageSize || magic != Magic)
+      return false;
+    std::memcpy(&root, header + 4, 4);
+    std::memcpy(&page_count, header + 8, 4);
+    std::memcpy(&height, header + 12, 4);
+    std::memcpy(&words, header + 16, 8);
+    return true;
+  }
+
+  bool insert(const std::string& word)
+  {
+    if (word.size() > MaxWordLength)
+      return false;
+    std::vector<std::uint32_t> inner;
+    const auto leaf_id = findLeaf(word, &inner);
+    if (!leaf_id)
+      return false;
+    PinnedPage leaf(pool, leaf_id);
+    if (!leaf)
+      return false;
+    const auto pos = leaf.node().lower_bound(word);
+    if (pos < leaf.node().count() && leaf.node().key(pos) == word)
+      return false;
+    ++words;
+    header_dirty = true;
+    if (leaf.modify().insert(pos, { word, 0 }))
+      return true;
+
+    auto entries = leaf.node().entries();
+    entries.insert(entries.begin() + static_cast<std::ptrdiff_t>(pos), { word, 0 });
+    auto [separator, right] = split(leaf, Leaf, std::move(entries));
+
+    // push the separator up until a page has room for it
+    while (!inner.empty()) {
+      PinnedPage parent(pool, inner.back());
+      inner.pop_back();
+      if (!parent)
+        return false;
+      const auto at = parent.node().lower_bound(separator);
+      if (parent.modify().insert(at, { separator, right }))
+        return true;
+      auto parent_entries = parent.node().entries();
+      parent_entries.insert(parent_entries.begin() + static_cast<std::ptrdiff_t>(at), { std::move(separator), right });
+      std::tie(separator, right) = split(parent, Inner, std::move(parent_entries));
+    }
+    const auto new_root = allocate();
+    PinnedPage page(pool, new_root, true);
+    page.modify().assign(Inner, root, { { std::move(separator), right } });
+    root = new_root;
+    ++height;
+    return true;
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    const auto leaf_id = findLeaf(word, nullptr);
+    if (!leaf_id)
+      return false;
+    PinnedPage leaf(pool, leaf_id);
+    if (!leaf)
+      return false;
+    const auto node = leaf.node();
+    const auto pos = node.lower_bound(word);
+    return pos < node.count() && node.key(pos) == word;
+  }
+
+  // Remove a word. Like the other variants, returns true only if the word was found and the trie is empty afterwards.
+  bool remove(const std::string& word)
+  {
+    const auto leaf_id = findLeaf(word, nullptr);
+    if (!leaf_id)
+      return false;
+    PinnedPage leaf(pool, leaf_id);
+    if (!leaf)
+      return false;
+    const auto pos = leaf.node().lower_bound(word);
+    if (pos == leaf.node().count() || leaf.node().key(pos) != word)
+      return false;
+    leaf.modify().erase(pos);
+    --words;
+    header_dirty = true;
+    return words == 0;
+  }
+
+  // Writes all modified pages and the header to the file
+  bool flush()
+  {
+    bool ok = pool.flush();
+    if (header_dirty)
+      ok = writeHeader() && ok;
+    return ok;
+  }
+
+  // Call visit(word) for every stored word in lexicographic order
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    auto id = root;
+    for (std::uint32_t level = 1; level < height; ++level) {
+      PinnedPage page(pool, id);
+      if (!page)
+        return;
+      id = page.node().link();
+    }
+    while (id) {
+      std::vector<Entry> entries;
+      {
+        PinnedPage page(pool, id);
+        if (!page)
+          return;
+        entries = page.node().entries();
+        id = page.node().link();
+      }
+      for (const auto& entry : entries)
+        visit(std::as_const(entry.key));
+    }
+  }
+
+  // Bytes held in memory (buffer pool), the dictionary itself lives in the file
+  [[nodiscard]] std::size_t size() const { return sizeof(*this) + pool.size(); }
+
+  [[nodiscard]] std::size_t file_size() const { return std::size_t{ page_count } * PageSize; }
+  [[nodiscard]] std::size_t word_count() const { return words; }
+  [[nodiscard]] bool good() const { return pool.good(); }
+
+  [[nodiscard]] const PageCacheStats& cache_stats() const { return pool.stats(); }
+  void reset_cache_stats() { pool.reset_stats(); }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm> // for std::min
+#include <atomic>    // for std::atomic
+#include <cstddef>   // for std::size_t
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+namespace util {
+// Runs task(i) for every i in [0, n) on up to hardware_concurrency threads, the calling thread
+// included. Used for the disjoint top-level branches of a trie, so tasks must not share nodes.
+template<typename Task>
+void
+parallel_branches(std::size_t n, Task&& task)
+{
+  const auto threads = std::min<std::size_t>(n, std::max(1u, std::thread::hardware_concurrency()));
+  std::atomic<std::size_t> next{ 0 };
+  const auto work = [&] {
+    for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < n; i = next.fetch_add(1, std::memory_order_relaxed))
+      task(i);
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t t = 1; t < threads; ++t)
+    pool.emplace_back(work);
+  work();
+  for (auto& thread : pool)
+    thread.join();
+}
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>     // std::lower_bound
+#include <atomic>        // std::atomic, std::atomic_load_explicit, std::atomic_store_explicit
+#include <cstddef>       // std::size_t
+#include <memory>        // std::shared_ptr, std::make_shared
+#include <mutex>         // std::mutex, std::lock_guard
+#include <string>        // std::string
+#include <unordered_set> // std::unordered_set
+#include <utility>       // std::pair, std::move, std::as_const
+#include <vector>        // std::vector
+
+// Persistent (path-copying) trie.
+//
+// Published nodes are immutable. insert and remove copy only the nodes on the root-to-leaf path,
+// share every other subtree with the previous version and publish the new root atomically.
+// Readers and snapshots hold a reference to a root and never lock. A version is reclaimed by
+// reference counting once the last snapshot or reader holding it is gone.
+// Writers are serialized by a mutex.
+class PersistentTrie
+{
+private:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+  using Child = std::pair<unsigned char, NodePtr>;
+
+  struct Node
+  {
+    bool is_end = false;
+    std::vector<Child> children; // sorted by symbol
+  };
+
+  // approximation of the make_shared control block (vtable pointer and two reference counts)
+  static constexpr std::size_t ControlBlockSize = 2 * sizeof(void*);
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+  std::atomic<NodePtr> root;
+#else
+  NodePtr root;
+#endif
+  std::mutex writer;
+  std::size_t written_nodes = 0;
+  std::size_t written_bytes = 0;
+
+  NodePtr load() const
+  {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return root.load(std::memory_order_acquire);
+#else
+    return std::atomic_load_explicit(&root, std::memory_order_acquire);
+#endif
+  }
+
+  void publish(NodePtr next)
+  {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    root.store(std::move(next), std::memory_order_release);
+#else
+    std::atomic_store_explicit(&root, std::move(next), std::memory_order_release);
+#endif
+  }
+
+public:
+  // Immutable point-in-time view of a PersistentTrie.
+  class Snapshot
+  {
+  private:
+    friend class PersistentTrie;
+
+    NodePtr root;
+
+    explicit Snapshot(NodePtr root_)
+      : root(std::move(root_))
+    {
+    }
+
+  public:
+    [[nodiscard]] bool contains(const std::string& word) const { return containsHelper(root.get(), word); }
+
+    [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()); }
+
+    template<typename Visitor>
+    void for_each(Visitor&& visit) const
+    {
+      std::string word;
+      forEachHelper(root.get(), word, visit);
+    }
+  };
+
+  PersistentTrie()
+    : root(std::make_shared<const Node>())
+  {
+  }
+
+  PersistentTrie(const PersistentTrie&) = delete;
+  PersistentTrie& operator=(const PersistentTrie&) = delete;
+
+  // Insert a word (excluding trailing 0-byte or '$')
+  bool insert(const std::string& word)
+  {
+    std::lock_guard lock(writer);
+    auto next = insertHelper(load().get(), word, 0);
+    if (!next)
+      return false; // already contained, the current version stays
+    publish(std::move(next));
+    return true;
+  }
+
+  // Check if word is contained (in the latest version)
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    const auto current = load();
+    return containsHelper(current.get(), word);
+  }
+
+  // Remove a word. Like the other variants, returns true only if the word was found and the trie is empty afterwards.
+  bool remove(const std::string& word)
+  {
+    std::lock_guard lock(writer);
+    const auto current = load();
+    auto next = removeHelper(current, word, 0);
+    if (next == current)
+      return false; // not found
+    const bool empty = !next;
+    publish(empty ? std::make_shared<const Node>() : std::move(next));
+    return empty;
+  }
+
+  // Memory of the latest version, without the nodes only retained by older snapshots
+  [[nodiscard]] std::size_t size() const
+  {
+    const auto current = load();
+    return sizeHelper(current.get());
+  }
+
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    snapshot().for_each(std::forward<Visitor>(visit));
+  }
+
+  // O(1) consistent view of the latest version that stays valid while writers go on
+  [[nodiscard]] Snapshot snapshot() const { return Snapshot(load()); }
+
+  // Memory held by the union of the given versions, nodes shared between them counted once
+  [[nodiscard]] static std::size_t retained_size(const std::vector<Snapshot>& snapshots)
+  {
+    std::unordered_set<const Node*> visited;
+    std::vector<const Node*> stack;
+    std::size_t total = 0;
+    for (const auto& s : snapshots)
+      stack.push_back(s.root.get());
+    while (!stack.empty()) {
+      const Node* node = stack.back();
+      stack.pop_back();
+      if (!visited.insert(node).second)
+        continue;
+      total += nodeSize(*node);
+      for (const auto& child : node->children)
+        stack.push_back(child.second.get());
+    }
+    return total;
+  }
+
+  // Nodes and bytes allocated by insert/remove so far (write amplification), read while no writer is active
+  [[nodiscard]] std::size_t nodes_written() const { return written_nodes; }
+  [[nodiscard]] std::size_t bytes_written() const { return written_bytes; }
+
+private:
+  static std::size_t nodeSize(const Node& node) { return ControlBlockSize + sizeof(Node) + node.children.capacity() * sizeof(Child); }
+
+  static const Child* findChild(const Node* node, unsigned char c)
+  {
+    auto it = std::lower_bound(node->children.begin(), node->children.end(), c, [](const Child& child, unsigned char s) { return child.first < s; });
+    return it != node->children.end() && it->first == c ? &*it : nullptr;
+  }
+
+  // copy of node (or a new empty node) that is not published yet
+  std::shared_ptr<Node> copyNode(const Node* node)
+  {
+    auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    ++written_nodes;
+    written_bytes += nodeSize(*copy);
+    return copy;
+  }
+
+  // Returns the new version of node with word inserted, or nullptr if word is already contained
+  NodePtr insertHelper(const Node* node, const std::string& word, std::size_t index)
+  {
+    if (index == word.size()) {
+      if (node && node->is_end)
+        return nullptr;
+      auto copy = copyNode(node);
+      copy->is_end = true;
+      return copy;
+    }
+    const auto c = static_cast<unsigned char>(word[index]);
+    const Child* child = node ? findChild(node, c) : nullptr;
+    auto next_child = insertHelper(child ? child->second.get() : nullptr, word, index + 1);
+    if (!next_child)
+      return nullptr;
+
+    auto copy = copyNode(node);
+    auto it = std::lower_bound(copy->children.begin(), copy->children.end(), c, [](const Child& ch, unsigned char s) { return ch.first < s; });
+    if (it != copy->children.end() && it->first == c)
+      it->second = std::move(next_child);
+    else
+      copy->children.insert(it, { c, std::move(next_child) });
+    return copy;
+  }
+
+  // Returns the new version of node with word removed: node itself if word is not contained,
+  // nullptr if the node is left without word and children (caller can prune)
+  NodePtr removeHelper(const NodePtr& node, const std::string& word, std::size_t index)
+  {
+    if (index == word.size()) {
+      if (!node->is_end)
+        return node;
+      if (node->children.empty())
+        return nullptr;
+      auto copy = copyNode(node.get());
+      copy->is_end = false;
+      return copy;
+    }
+    const Child* child = findChild(node.get(), static_cast<unsigned char>(word[index]));
+    if (!child)
+      return node;
+    auto next_child = removeHelper(child->second, word, index + 1);
+    if (next_child == child->second)
+      return node;
+    if (!next_child && node->children.size() == 1 && !node->is_end)
+      return nullptr;
+
+    auto copy = copyNode(node.get());
+    auto it = copy->children.begin() + (child - node->children.data());
+    if (next_child)
+      it->second = std::move(next_child);
+    else
+      copy->children.erase(it);
+    return copy;
+  }
+
+  static bool containsHelper(const Node* node, const std::string& word)
+  {
+    for (char c : word) {
+      const Child* child = findChild(node, static_cast<unsigned char>(c));
+      if (!child)
+        return false;
+      node = child->second.get();
+    }
+    return node->is_end;
+  }
+
+  static std::size_t sizeHelper(const Node* node)
+  {
+    std::size_t total = nodeSize(*node);
+    for (const auto& child : node->children)
+      total += sizeHelper(child.second.get());
+    return total;
+  }
+
+  template<typename Visitor>
+  static void forEachHelper(const Node* node, std::string& word, Visitor& visit)
+  {
+    if (node->is_end)
+      visit(std::as_const(word));
+    for (const auto& child : node->children) {
+      word.push_back(static_cast<char>(child.first));
+      forEachHelper(child.second.get(), word, visit);
+      word.pop_back();
+    }
+  }
+};
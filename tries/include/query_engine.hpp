@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>   // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <string>  // for std::string
+#include <vector>  // for std::vector
+
+#include "query_protocol.hpp"
+
+namespace util {
+// Appends "true\n" or "false\n" for each of the first count bits, eight at a time
+inline void
+append_results(const std::vector<std::uint64_t>& bits, std::size_t count, std::string& results)
+{
+  static const auto table = [] {
+    std::array<std::string, 256> lines;
+    for (std::size_t byte = 0; byte < lines.size(); ++byte)
+      for (std::size_t k = 0; k < 8; ++k)
+        lines[byte] += (byte >> k) & 1 ? "true\n" : "false\n";
+    return lines;
+  }();
+
+  results.reserve(results.size() + count * 6);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    results += table[(bits[i >> 6] >> (i & 63)) & 0xFF];
+  for (; i < count; ++i)
+    results += (bits[i >> 6] >> (i & 63)) & 1 ? "true\n" : "false\n";
+}
+}
+
+// Batch executor bound to the concrete trie type, for run_query_batches and serve.
+//
+// Consecutive queries with the same operation form a run, and every run is one loop over a
+// direct (inlinable) member call instead of a virtual call and a switch per query. The results
+// are packed into a bitset and formatted in bulk. Queries with another operation than 'c', 'i'
+// or 'd' yield false, like in the TrieInterface path.
+template<typename Trie>
+class QueryEngine
+{
+private:
+  Trie& trie;
+  std::vector<std::uint64_t> bits;
+
+  template<char Operation>
+  void executeRun(const QueryBatch& batch, std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; ++i) {
+      bool result;
+      if constexpr (Operation == 'c')
+        result = trie.contains(batch[i].word);
+      else if constexpr (Operation == 'i')
+        result = trie.insert(batch[i].word);
+      else
+        result = trie.remove(batch[i].word);
+      bits[i >> 6] |= static_cast<std::uint64_t>(result) << (i & 63);
+    }
+  }
+
+public:
+  explicit QueryEngine(Trie& trie_)
+    : trie(trie_)
+  {
+  }
+
+  void operator()(const QueryBatch& batch, std::string& results)
+  {
+    bits.assign((batch.size() + 63) / 64, 0);
+    for (std::size_t begin = 0, end = 0; begin < batch.size(); begin = end) {
+      const auto operation = batch[begin].operation;
+      end = begin + 1;
+      while (end < batch.size() && batch[end].operation == operation)
+        ++end;
+      switch (operation) {
+        case 'c':
+          executeRun<'c'>(batch, begin, end);
+          break;
+        case 'i':
+          executeRun<'i'>(batch, begin, end);
+          break;
+        case 'd':
+          executeRun<'d'>(batch, begin, end);
+          break;
+        default:
+          break;
+      }
+    }
+    util::append_results(bits, batch.size(), results);
+  }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cctype>      // for std::isalnum
+#include <cstddef>     // for std::size_t
+#include <string>      // for std::string
+#include <string_view> // for std::string_view
+#include <vector>      // for std::vector
+
+// Strips trailing non-alphanumeric characters.
+inline void
+trim_back(std::string& line)
+{
+  while (!line.empty() && !std::isalnum(static_cast<unsigned char>(line.back())))
+    line.pop_back();
+}
+
+// Splits a query line "<word> <operation>" into word and operation.
+// Returns false for lines that do not hold a query.
+inline bool
+parse_query(std::string& line, char& operation)
+{
+  trim_back(line);
+  if (line.empty())
+    return false;
+  operation = line.back();
+  line.pop_back();
+  trim_back(line);
+  return !line.empty();
+}
+
+struct Query
+{
+  std::string word;
+  char operation;
+};
+
+using QueryBatch = std::vector<Query>;
+
+// Binary framing of queries sent to a ti_programm server (-serve).
+//
+// A request is the operation byte ('c', 'i' or 'd'), the word length as 16-bit little endian
+// and the word. The server answers every request with one byte, 1 for true and 0 for false,
+// in request order per connection. Clients may pipeline any number of requests.
+namespace util {
+constexpr std::size_t RequestHeaderSize = 3;
+constexpr std::size_t MaxRequestWord = 0xFFFF;
+
+inline bool
+valid_operation(char operation)
+{
+  return operation == 'c' || operation == 'i' || operation == 'd';
+}
+
+inline void
+append_request(std::string& out, char operation, std::string_view word)
+{
+  out.push_back(operation);
+  out.push_back(static_cast<char>(word.size() & 0xFF));
+  out.push_back(static_cast<char>(word.size() >> 8));
+  out.append(word);
+}
+
+// Parses the request at the front of data. Returns its size in bytes, or 0 if data holds no
+// complete request yet.
+inline std::size_t
+parse_request(std::string_view data, char& operation, std::string_view& word)
+{
+  if (data.size() < RequestHeaderSize)
+    return 0;
+  const auto length = static_cast<std::size_t>(static_cast<unsigned char>(data[1])) | static_cast<std::size_t>(static_cast<unsigned char>(data[2])) << 8;
+  if (data.size() < RequestHeaderSize + length)
+    return 0;
+  operation = data[0];
+  word = data.substr(RequestHeaderSize, length);
+  return RequestHeaderSize + length;
+}
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t
+#include <cstring>   // for std::memcpy
+#include <exception> // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <string>    // for std::string
+#include <thread>    // for std::thread
+#include <utility>   // for std::move
+#include <vector>    // for std::vector
+
+#include "array_trie.hpp"
+#include "cpu_topology.hpp"
+#include "huge_pages.hpp"
+
+// Read-only copy of an ArrayTrie in one HugePageRegion.
+//
+// Nodes take 256 bytes instead of 512: 63 32-bit child indices (0 for none, the root is node 0
+// and never a child) and the end flag. They are stored in depth-first order, so a path and the
+// subtries next to it share pages. Lookups behave exactly like ArrayTrie::contains.
+class FlatArrayTrie
+{
+private:
+  struct Node
+  {
+    std::uint32_t children[63];
+    std::uint32_t is_end;
+  };
+  static_assert(sizeof(Node) == 256);
+
+  util::HugePageRegion region;
+  std::size_t num_nodes = 0;
+  std::size_t num_words = 0;
+
+  [[nodiscard]] const Node* nodes() const { return static_cast<const Node*>(region.data()); }
+
+public:
+  FlatArrayTrie() = default;
+
+  // huge selects transparent huge pages for the nodes (see util::HugePageRegion)
+  template<bool CountWords>
+  explicit FlatArrayTrie(const BasicArrayTrie<CountWords>& trie, bool huge = true)
+  {
+    // for_each visits the nodes depth first, so every word adds the nodes after its common
+    // prefix with the previous word in pre-order
+    std::string previous;
+    std::size_t count = 1;
+    trie.for_each([&](const std::string& word) {
+      std::size_t common = 0;
+      while (common < previous.size() && common < word.size() && previous[common] == word[common])
+        ++common;
+      count += word.size() - common;
+      previous = word;
+    });
+
+    region = util::HugePageRegion(count * sizeof(Node), huge);
+    auto* out = static_cast<Node*>(region.data());
+    std::vector<std::uint32_t> path{ 0 }; // node of each prefix length of the previous word
+    previous.clear();
+    num_nodes = 1;
+    trie.for_each([&](const std::string& word) {
+      std::size_t common = 0;
+      while (common < previous.size() && common < word.size() && previous[common] == word[common])
+        ++common;
+      path.resize(common + 1);
+      for (std::size_t d = common; d < word.size(); ++d) {
+        const auto node = static_cast<std::uint32_t>(num_nodes++);
+        out[path.back()].children[util::index(word[d])] = node;
+        path.push_back(node);
+      }
+      out[path.back()].is_end = 1;
+      ++num_words;
+      previous = word;
+    });
+  }
+
+  // Copy into a new region, placed on the node of the calling thread
+  [[nodiscard]] FlatArrayTrie clone(bool huge = true) const
+  {
+    FlatArrayTrie copy;
+    copy.region = util::HugePageRegion(num_nodes * sizeof(Node), huge);
+    if (num_nodes)
+      std::memcpy(copy.region.data(), region.data(), num_nodes * sizeof(Node));
+    copy.num_nodes = num_nodes;
+    copy.num_words = num_words;
+    return copy;
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    const Node* base = nodes();
+    if (!base)
+      return false;
+    std::uint32_t curr = 0;
+    for (char c : word) {
+      curr = base[curr].children[util::index(c)];
+      if (!curr)
+        return false;
+    }
+    return base[curr].is_end;
+  }
+
+  [[nodiscard]] std::size_t size() const { return sizeof(*this) + region.size(); }
+  [[nodiscard]] std::size_t node_count() const { return num_nodes; }
+  [[nodiscard]] std::size_t word_count() const { return num_words; }
+};
+
+// Read-only ArrayTrie with one FlatArrayTrie replica in the memory of every NUMA node.
+//
+// Each replica is copied by a thread pinned to its node, so first touch places its pages there,
+// and contains() reads the replica of the node the calling thread runs on. Threads that stay on
+// one node can hold on to local() instead. Without replicate, or on a machine with a single
+// node, there is exactly one replica and no routing.
+class ReplicatedArrayTrie
+{
+private:
+  std::vector<FlatArrayTrie> replicas;
+
+public:
+  template<bool CountWords>
+  explicit ReplicatedArrayTrie(const BasicArrayTrie<CountWords>& trie, bool huge = true, bool replicate = true)
+  {
+    const auto& topology = CpuTopology::system();
+    const auto num_replicas = replicate ? topology.nodes.size() : std::size_t{ 1 };
+    replicas.resize(num_replicas);
+    // an exception must not leave a thread (std::terminate), it is rethrown once all are joined
+    std::vector<std::exception_ptr> failures(num_replicas);
+    const auto build = [&] {
+      try {
+        pin_current_thread(topology.nodes.front());
+        replicas[0] = FlatArrayTrie(trie, huge);
+      } catch (...) {
+        failures[0] = std::current_exception();
+      }
+    };
+    const auto copy = [&](std::size_t n) {
+      try {
+        pin_current_thread(topology.nodes[n]);
+        replicas[n] = replicas[0].clone(huge);
+      } catch (...) {
+        failures[n] = std::current_exception();
+      }
+    };
+    std::thread(build).join();
+    if (failures[0])
+      std::rethrow_exception(failures[0]);
+    std::vector<std::thread> copiers;
+    copiers.reserve(num_replicas);
+    try {
+      for (std::size_t n = 1; n < num_replicas; ++n)
+        copiers.emplace_back(copy, n);
+    } catch (...) {
+      for (auto& copier : copiers)
+        copier.join();
+      throw;
+    }
+    for (auto& copier : copiers)
+      copier.join();
+    for (const auto& failure : failures)
+      if (failure)
+        std::rethrow_exception(failure);
+  }
+
+  [[nodiscard]] const FlatArrayTrie& local() const
+  {
+    const auto node = replicas.size() > 1 ? CpuTopology::system().current_node() : 0;
+    return replicas[node < replicas.size() ? node : 0];
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const { return local().contains(word); }
+
+  [[nodiscard]] const FlatArrayTrie& replica(std::size_t node) const { return replicas[node]; }
+  [[nodiscard]] std::size_t num_replicas() const { return replicas.size(); }
+
+  [[nodiscard]] std::size_t size() const
+  {
+    std::size_t total = sizeof(*this);
+    for (const auto& replica : replicas)
+      total += replica.size();
+    return total;
+  }
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>    // for std::max
+#include <atomic>       // for std::atomic, std::memory_order_*
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <memory>       // for std::unique_ptr, std::make_unique
+#include <mutex>        // for std::unique_lock
+#include <shared_mutex> // for std::shared_lock
+#include <string>       // for std::string
+#include <thread>       // for std::this_thread::yield, std::thread::hardware_concurrency
+#include <vector>       // for std::vector
+
+#include "query_protocol.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace util {
+// Reader-writer spin lock in one word: the writer bit and the number of readers. A writer sets
+// its bit first and then waits for the readers to leave, new readers wait for the writer, so
+// writers are not starved. Waiting threads yield, the holder may be descheduled.
+class RwSpinLock
+{
+private:
+  static constexpr std::uint32_t Writer = 1u << 31;
+  std::atomic<std::uint32_t> state{ 0 };
+
+public:
+  void lock()
+  {
+    auto expected = state.load(std::memory_order_relaxed);
+    while (expected & Writer || !state.compare_exchange_weak(expected, expected | Writer, std::memory_order_acquire, std::memory_order_relaxed)) {
+      std::this_thread::yield();
+      expected = state.load(std::memory_order_relaxed);
+    }
+    while (state.load(std::memory_order_acquire) != Writer)
+      std::this_thread::yield();
+  }
+
+  void unlock() { state.store(0, std::memory_order_release); }
+
+  void lock_shared()
+  {
+    auto expected = state.load(std::memory_order_relaxed);
+    while (expected & Writer || !state.compare_exchange_weak(expected, expected + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      std::this_thread::yield();
+      expected = state.load(std::memory_order_relaxed);
+    }
+  }
+
+  void unlock_shared() { state.fetch_sub(1, std::memory_order_release); }
+};
+}
+
+// Concurrent wrapper around any variant, partitioned into shards by the first two symbols.
+//
+// Every shard is a separate Trie holding whole subtries of depth two, behind its own reader-writer
+// spin lock on its own cache line, so writers to different shards do not contend. apply_batch
+// groups a batch by shard and executes the shards as tasks of a work-stealing pool, each under a
+// single lock acquisition.
+//
+// remove returns true if the word was present: the variants' "trie empty afterwards" is not
+// meaningful while other shards change concurrently.
+template<typename Trie>
+class ShardedTrie
+{
+private:
+  struct alignas(64) Shard
+  {
+    mutable util::RwSpinLock lock;
+    Trie trie;
+  };
+
+  std::unique_ptr<Shard[]> shards;
+  std::size_t num_shards;
+  util::WorkStealingPool pool;
+
+  static bool removeFound(Trie& trie, const std::string& word)
+  {
+    if (!trie.contains(word))
+      return false;
+    trie.remove(word);
+    return true;
+  }
+
+public:
+  explicit ShardedTrie(std::size_t shards_ = 64, std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    : shards(std::make_unique<Shard[]>(shards_ ? shards_ : 1))
+    , num_shards(shards_ ? shards_ : 1)
+    , pool(threads)
+  {
+  }
+
+  // Shard of the subtrie holding word, from a multiplicative hash of its first two symbols
+  [[nodiscard]] std::size_t shard_of(const std::string& word) const
+  {
+    const auto first = word.empty() ? 0u : static_cast<unsigned char>(word[0]);
+    const auto second = word.size() < 2 ? 0u : static_cast<unsigned char>(word[1]);
+    const auto prefix = static_cast<std::uint64_t>(first << 8 | second) + 1;
+    return static_cast<std::size_t>((prefix * 0x9E3779B97F4A7C15ull) >> 32) % num_shards;
+  }
+
+  [[nodiscard]] std::size_t shard_count() const { return num_shards; }
+
+  [[nodiscard]] std::size_t thread_count() const { return pool.thread_count(); }
+
+  // Tasks of apply_batch executed by another thread than the one they were assigned to
+  [[nodiscard]] std::size_t steals() const { return pool.steals(); }
+
+  bool insert(const std::string& word)
+  {
+    auto& shard = shards[shard_of(word)];
+    std::unique_lock lock(shard.lock);
+    return shard.trie.insert(word);
+  }
+
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    const auto& shard = shards[shard_of(word)];
+    std::shared_lock lock(shard.lock);
+    return shard.trie.contains(word);
+  }
+
+  bool remove(const std::string& word)
+  {
+    auto& shard = shards[shard_of(word)];
+    std::unique_lock lock(shard.lock);
+    return removeFound(shard.trie, word);
+  }
+
+  // Executes the queries of batch ('c', 'i' or 'd', others yield false) and stores their results
+  // in batch order, 1 for true. The queries of one shard run in batch order, so the results equal
+  // those of executing the batch one query after the other. Shards without mutations in the batch
+  // are only locked for reading.
+  void apply_batch(const QueryBatch& batch, std::vector<std::uint8_t>& results)
+  {
+    results.assign(batch.size(), 0);
+
+    // counting sort of the query indices by shard, stable
+    std::vector<std::size_t> offsets(num_shards + 1, 0);
+    std::vector<std::uint32_t> shard_ids(batch.size());
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      shard_ids[i] = static_cast<std::uint32_t>(shard_of(batch[i].word));
+      ++offsets[shard_ids[i] + 1];
+    }
+    for (std::size_t s = 0; s < num_shards; ++s)
+      offsets[s + 1] += offsets[s];
+    std::vector<std::size_t> order(batch.size());
+    {
+      auto cursor = offsets;
+      for (std::size_t i = 0; i < batch.size(); ++i)
+        order[cursor[shard_ids[i]]++] = i;
+    }
+
+    pool.run(num_shards, [&](std::size_t s) {
+      const auto begin = offsets[s], end = offsets[s + 1];
+      if (begin == end)
+        return;
+      auto& shard = shards[s];
+      bool writes = false;
+      for (auto k = begin; k < end && !writes; ++k)
+        writes = batch[order[k]].operation != 'c';
+
+      if (!writes) {
+        std::shared_lock lock(shard.lock);
+        for (auto k = begin; k < end; ++k)
+          results[order[k]] = shard.trie.contains(batch[order[k]].word);
+        return;
+      }
+      std::unique_lock lock(shard.lock);
+      for (auto k = begin; k < end; ++k) {
+        const auto& [word, operation] = batch[order[k]];
+        bool result = false;
+        if (operation == 'c')
+          result = shard.trie.contains(word);
+        else if (operation == 'i')
+          result = shard.trie.insert(word);
+        else if (operation == 'd')
+          result = removeFound(shard.trie, word);
+        results[order[k]] = result;
+      }
+    });
+  }
+
+  // Approximate memory usage of all shards
+  [[nodiscard]] std::size_t size() const
+  {
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < num_shards; ++s) {
+      std::shared_lock lock(shards[s].lock);
+      total += shards[s].trie.size();
+    }
+    return total;
+  }
+};
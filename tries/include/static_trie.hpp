@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>            // for std::array
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint8_t, std::uint16_t, std::uint32_t
+#include <initializer_list> // for std::initializer_list
+#include <string_view>      // for std::string_view
+#include <type_traits>      // for std::conditional_t
+
+#include "array_trie.hpp" // for util::index
+
+namespace util {
+// String literal usable as a template argument, e.g. StaticTrie<"GET", "PUT">
+template<std::size_t N>
+struct fixed_string
+{
+  char chars[N] = {};
+
+  constexpr fixed_string(const char (&literal)[N])
+  {
+    for (std::size_t i = 0; i < N; ++i)
+      chars[i] = literal[i];
+  }
+
+  [[nodiscard]] constexpr std::string_view view() const { return { chars, N - 1 }; }
+};
+
+// Flattened transition table of a StaticTrie: row s holds the successor of state s for every
+// util::index symbol. State 0 is a dead state looping on itself, state 1 the root.
+template<std::size_t States, typename State>
+struct static_trie_tables
+{
+  std::array<std::array<State, 63>, States> next{};
+  std::array<bool, States> is_end{};
+  std::size_t states = 2;
+};
+
+template<std::size_t States, typename State>
+constexpr static_trie_tables<States, State>
+build_static_trie(std::initializer_list<std::string_view> words)
+{
+  static_trie_tables<States, State> tables{};
+  for (const auto word : words) {
+    std::size_t state = 1;
+    for (char c : word) {
+      auto& next = tables.next[state][index(c)];
+      if (!next)
+        next = static_cast<State>(tables.states++);
+      state = next;
+    }
+    tables.is_end[state] = true;
+  }
+  return tables;
+}
+}
+
+// Trie over a fixed keyword set, built entirely at compile time.
+//
+// Uses the util::index mapping of ArrayTrie. Every state is a dense row of 63 successors, so
+// each character is one indexed load, like a switch compiled to a jump table. Missing edges lead
+// to the dead state 0 instead of leaving the loop early, so contains has no data-dependent
+// branches besides the loop over the word.
+template<util::fixed_string... Words>
+class StaticTrie
+{
+private:
+  static constexpr std::size_t MaxStates = 2 + (std::size_t{ 0 } + ... + Words.view().size());
+
+public:
+  static constexpr std::size_t num_states = util::build_static_trie<MaxStates, std::uint32_t>({ Words.view()... }).states;
+
+  using State = std::conditional_t<num_states <= 0x100, std::uint8_t, std::conditional_t<num_states <= 0x10000, std::uint16_t, std::uint32_t>>;
+
+private:
+  static constexpr auto tables = util::build_static_trie<num_states, State>({ Words.view()... });
+
+public:
+  [[nodiscard]] static constexpr bool contains(std::string_view word)
+  {
+    State state = 1;
+    for (char c : word)
+      state = tables.next[state][util::index(c)];
+    return tables.is_end[state];
+  }
+
+  [[nodiscard]] static constexpr std::size_t size() { return sizeof(tables.next) + sizeof(tables.is_end); }
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>   // std::find_if
+#include <cstddef>     // std::size_t
+#include <memory>      // std::unique_ptr, std::make_unique
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <utility>     // std::as_const, std::move
+#include <vector>      // std::vector
+
+// Trie with tail compression.
+//
+// Once the path of a word becomes unique, the remaining characters are not stored as a chain of
+// nodes but as a packed byte string in a contiguous tail pool, referenced by the edge leaving the
+// last branching node. Insert splits a tail where a new word diverges inside it, remove merges a
+// subtree left with a single word back into a tail. Pool bytes no longer referenced are compacted
+// away once they make up half of the pool.
+class TailTrie
+{
+private:
+  struct Node;
+
+  // Edge to a child node or, if node is null, to the single word continuing with
+  // symbol followed by tail_pool[tail_offset, tail_offset + tail_length)
+  struct Child
+  {
+    unsigned char symbol;
+    std::size_t tail_offset = 0; // full width, the pool may outgrow 4 GiB
+    std::size_t tail_length = 0;
+    std::unique_ptr<Node> node;
+  };
+
+  struct Node
+  {
+    bool is_end = false;
+    std::vector<Child> children;
+  };
+
+  // compact only pools of some size, small ones are cheap to keep
+  static constexpr std::size_t MinCompactBytes = 4096;
+
+  std::unique_ptr<Node> root;
+  std::string tail_pool;
+  std::size_t dead_bytes = 0; // pool bytes no longer referenced by a tail
+
+  template<typename NodeType>
+  static auto findChild(NodeType* node, unsigned char c)
+  {
+    return std::find_if(node->children.begin(), node->children.end(), [c](const Child& child) { return child.symbol == c; });
+  }
+
+public:
+  TailTrie()
+    : root(std::make_unique<Node>())
+  {
+  }
+
+  // Insert a word (excluding trailing 0-byte or '$')
+  bool insert(const std::string& word)
+  {
+    Node* curr = root.get();
+    for (std::size_t i = 0; i < word.size(); ++i) {
+      auto uc = static_cast<unsigned char>(word[i]);
+      auto it = findChild(curr, uc);
+      if (it == curr->children.end()) {
+        // Not found -> the rest of the word becomes a tail
+        curr->children.push_back(makeTail(uc, word, i + 1));
+        return true;
+      }
+      if (!it->node)
+        return splitTail(*it, word, i + 1);
+      curr = it->node.get();
+    }
+    // Mark end of word
+    bool wasEnd = curr->is_end;
+    curr->is_end = true;
+    return !wasEnd;
+  }
+
+  // Check if word is contained
+  [[nodiscard]] bool contains(const std::string& word) const
+  {
+    const Node* curr = root.get();
+    for (std::size_t i = 0; i < word.size(); ++i) {
+      auto it = findChild(curr, static_cast<unsigned char>(word[i]));
+      if (it == curr->children.end())
+        return false;
+      if (!it->node)
+        return tailOf(*it) == std::string_view(word).substr(i + 1);
+      curr = it->node.get();
+    }
+    return curr->is_end;
+  }
+
+  // Remove a word. Like the other variants, returns true only if the word was found and the trie is empty afterwards.
+  bool remove(const std::string& word)
+  {
+    bool found = false;
+    removeHelper(root.get(), word, 0, found);
+    if (!found)
+      return false;
+    compactIfSparse();
+    return root->children.empty() && !root->is_end;
+  }
+
+  [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()) + tail_pool.capacity(); }
+
+  // Call visit(word) for every stored word (in insertion order of the children)
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    std::string word;
+    forEachHelper(root.get(), word, visit);
+  }
+
+private:
+  [[nodiscard]] std::string_view tailOf(const Child& child) const { return { tail_pool.data() + child.tail_offset, child.tail_length }; }
+
+  Child makeTail(unsigned char symbol, std::string_view rest)
+  {
+    Child child{ symbol, tail_pool.size(), rest.size(), nullptr };
+    tail_pool.append(rest);
+    return child;
+  }
+
+  Child makeTail(unsigned char symbol, const std::string& word, std::size_t from) { return makeTail(symbol, std::string_view(word).substr(from)); }
+
+  // Inserts word[from..] below the tail edge: the common prefix of tail and word becomes a chain of
+  // nodes, the remainders of both become tails of its last node. Returns false if word equals the tail.
+  bool splitTail(Child& edge, const std::string& word, std::size_t from)
+  {
+    const auto tail = tailOf(edge);
+    const auto rest = std::string_view(word).substr(from);
+    if (tail == rest)
+      return false;
+    std::size_t k = 0;
+    while (k < tail.size() && k < rest.size() && tail[k] == rest[k])
+      ++k;
+
+    auto top = std::make_unique<Node>();
+    Node* curr = top.get();
+    for (std::size_t j = 0; j < k; ++j) {
+      curr->children.push_back({ static_cast<unsigned char>(tail[j]), 0, 0, std::make_unique<Node>() });
+      curr = curr->children.back().node.get();
+    }
+    // the old tail keeps its pool bytes behind the common prefix
+    if (k == tail.size()) {
+      curr->is_end = true;
+    } else {
+      curr->children.push_back({ static_cast<unsigned char>(tail[k]), edge.tail_offset + k + 1, tail.size() - k - 1, nullptr });
+    }
+    // makeTail may reallocate the pool, tail is not used below
+    if (k == rest.size())
+      curr->is_end = true;
+    else
+      curr->children.push_back(makeTail(static_cast<unsigned char>(rest[k]), word, from + k + 1));
+
+    dead_bytes += k < edge.tail_length ? k + 1 : k;
+    edge.node = std::move(top);
+    edge.tail_offset = edge.tail_length = 0;
+    compactIfSparse();
+    return true;
+  }
+
+  // Recursive helper for remove, found tells whether the word was contained
+  void removeHelper(Node* node, const std::string& word, std::size_t index, bool& found)
+  {
+    if (index == word.size()) {
+      found = node->is_end;
+      node->is_end = false;
+      return;
+    }
+    auto it = findChild(node, static_cast<unsigned char>(word[index]));
+    if (it == node->children.end())
+      return;
+    if (!it->node) {
+      if (tailOf(*it) == std::string_view(word).substr(index + 1)) {
+        found = true;
+        dead_bytes += it->tail_length;
+        node->children.erase(it);
+      }
+      return;
+    }
+    removeHelper(it->node.get(), word, index + 1, found);
+    if (found)
+      mergeChild(*node, it);
+  }
+
+  // Prunes the child node of the edge once it holds no word or turns it back into a tail once it holds a single one
+  void mergeChild(Node& node, std::vector<Child>::iterator edge)
+  {
+    const Node* child = edge->node.get();
+    if (child->children.empty()) {
+      if (!child->is_end) {
+        node.children.erase(edge);
+        return;
+      }
+      edge->node.reset(); // the word ends right behind the symbol
+      edge->tail_offset = edge->tail_length = 0;
+      return;
+    }
+    if (child->is_end || child->children.size() != 1 || child->children.front().node)
+      return;
+
+    const Child& only = child->children.front();
+    std::string merged(1, static_cast<char>(only.symbol));
+    merged.append(tailOf(only));
+    dead_bytes += only.tail_length;
+    edge->node.reset();
+    const auto tail = makeTail(edge->symbol, merged);
+    edge->tail_offset = tail.tail_offset;
+    edge->tail_length = tail.tail_length;
+  }
+
+  void compactIfSparse()
+  {
+    if (dead_bytes < MinCompactBytes || dead_bytes * 2 < tail_pool.size())
+      return;
+    std::string compacted;
+    compacted.reserve(tail_pool.size() - dead_bytes);
+    compactHelper(root.get(), compacted);
+    tail_pool = std::move(compacted);
+    dead_bytes = 0;
+  }
+
+  void compactHelper(Node* node, std::string& compacted)
+  {
+    for (auto& child : node->children) {
+      if (child.node) {
+        compactHelper(child.node.get(), compacted);
+        continue;
+      }
+      const auto offset = compacted.size();
+      compacted.append(tailOf(child));
+      child.tail_offset = offset;
+    }
+  }
+
+  [[nodiscard]] std::size_t sizeHelper(const Node* node) const
+  {
+    std::size_t total = sizeof(*node);
+    total += node->children.capacity() * sizeof(Child);
+    for (auto& child : node->children)
+      if (child.node)
+        total += sizeHelper(child.node.get());
+    return total;
+  }
+
+  template<typename Visitor>
+  void forEachHelper(const Node* node, std::string& word, Visitor& visit) const
+  {
+    if (node->is_end)
+      visit(std::as_const(word));
+    for (auto& child : node->children) {
+      word.push_back(static_cast<char>(child.symbol));
+      if (child.node) {
+        forEachHelper(child.node.get(), word, visit);
+      } else {
+        const auto tail = tailOf(child);
+        word.append(tail);
+        visit(std::as_const(word));
+        word.resize(word.size() - tail.size());
+      }
+      word.pop_back();
+    }
+  }
+};
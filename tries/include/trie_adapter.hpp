@@ -2,6 +2,9 @@
 
 #include <cstddef> // for std::size_t
 #include <string>  // for std::string
+#include <utility> // for std::forward
+
+#include "trie_stats.hpp"
 
 class TrieInterface
 {
@@ -15,6 +18,8 @@ public:
   [[nodiscard]] virtual bool remove(const std::string&) = 0;
 
   [[nodiscard]] virtual std::size_t size() const = 0;
+
+  [[nodiscard]] virtual TrieStats stats() const = 0;
 };
 
 template<typename T>
@@ -24,6 +29,14 @@ private:
   T trie;
 
 public:
+  template<typename... Args>
+  explicit TrieAdapter(Args&&... args)
+    : trie(std::forward<Args>(args)...)
+  {
+  }
+
+  T& get() { return trie; }
+
   [[nodiscard]] bool insert(const std::string& w) override { return trie.insert(w); }
 
   [[nodiscard]] bool contains(const std::string& w) const override { return trie.contains(w); }
@@ -31,4 +44,13 @@ public:
   [[nodiscard]] bool remove(const std::string& w) override { return trie.remove(w); }
 
   [[nodiscard]] std::size_t size() const override { return trie.size(); }
+
+  // empty stats for tries without stats()
+  [[nodiscard]] TrieStats stats() const override
+  {
+    if constexpr (requires { trie.stats(); })
+      return trie.stats();
+    else
+      return {};
+  }
 };
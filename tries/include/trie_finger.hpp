@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm> // for std::min, std::mismatch
+#include <cstddef>   // for std::size_t
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
+// Remembered path of the previous operation of a finger search.
+//
+// Consecutive keys of a sorted or correlated query stream share long prefixes. Instead of starting
+// at the root, an operation given a finger resumes from the deepest remembered node on the common
+// prefix with the previous key and leaves its own path behind for the next one.
+//
+// A finger belongs to one trie. The trie bumps its epoch whenever nodes are freed or relocated
+// (removes, compaction); a finger from an older epoch restarts at the root. Removes through a
+// finger prune along its path and keep it valid.
+template<typename Node>
+class TrieFinger
+{
+private:
+  std::vector<Node*> path; // path[i] is the node reached by key[0, i)
+  std::string key;
+  std::size_t epoch = 0;
+
+public:
+  // Returns the deepest remembered node on the common prefix of word and the previous key and
+  // sets depth to the length of that prefix.
+  Node* resume(Node* root, std::size_t trie_epoch, const std::string& word, std::size_t& depth)
+  {
+    if (path.empty() || epoch != trie_epoch) {
+      path.assign(1, root);
+      key.clear();
+      epoch = trie_epoch;
+    }
+    const auto limit = std::min(key.size(), word.size());
+    depth = static_cast<std::size_t>(std::mismatch(key.begin(), key.begin() + static_cast<std::ptrdiff_t>(limit), word.begin()).first - key.begin());
+    truncate(depth);
+    return path.back();
+  }
+
+  // Appends the node reached by symbol c to the path
+  void descend(Node* node, char c)
+  {
+    path.push_back(node);
+    key.push_back(c);
+  }
+
+  // Drops the path below the given depth
+  void truncate(std::size_t depth)
+  {
+    path.resize(depth + 1);
+    key.resize(depth);
+  }
+
+  [[nodiscard]] Node* node(std::size_t depth) const { return path[depth]; }
+
+  // Keeps the finger valid across an epoch bump caused by its own operation
+  void sync(std::size_t trie_epoch) { epoch = trie_epoch; }
+
+  // Forgets the path, the next operation starts at the root
+  void reset() { path.clear(); }
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>  // for std::atomic, std::memory_order_relaxed
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector>  // for std::vector
+
+// Operation tracing of the tries, compiled in with TRIES_TRACE=1 (cmake -DTRIES_TRACE=ON).
+// Without it TRIES_TRACE_ADD expands to nothing and its arguments are not evaluated.
+#if !defined(TRIES_TRACE)
+#define TRIES_TRACE 0
+#endif
+
+namespace util {
+// Counted events of all tries since the last reset_trace()
+struct TraceCounters
+{
+  std::uint64_t operations = 0;    // insert, contains and remove calls
+  std::uint64_t nodes_visited = 0; // nodes reached on the way down, the root included
+  std::uint64_t allocations = 0;   // nodes allocated by insert
+  std::uint64_t frees = 0;         // nodes pruned by remove
+  std::uint64_t searches = 0;      // child lookups
+  std::uint64_t probes = 0;        // children (VectorTrie) or bucket entries (HashTrie) compared by them
+  std::uint64_t prunes = 0;        // removes that pruned at least one node, frees / prunes is the mean prune depth
+
+  [[nodiscard]] double per_operation(std::uint64_t count) const { return operations ? static_cast<double>(count) / static_cast<double>(operations) : 0.0; }
+  [[nodiscard]] double probes_per_search() const { return searches ? static_cast<double>(probes) / static_cast<double>(searches) : 0.0; }
+  [[nodiscard]] double prune_depth() const { return prunes ? static_cast<double>(frees) / static_cast<double>(prunes) : 0.0; }
+};
+
+#if TRIES_TRACE
+// Process-wide and relaxed, so concurrent readers may be traced as well
+struct TraceState
+{
+  std::atomic<std::uint64_t> operations{ 0 };
+  std::atomic<std::uint64_t> nodes_visited{ 0 };
+  std::atomic<std::uint64_t> allocations{ 0 };
+  std::atomic<std::uint64_t> frees{ 0 };
+  std::atomic<std::uint64_t> searches{ 0 };
+  std::atomic<std::uint64_t> probes{ 0 };
+  std::atomic<std::uint64_t> prunes{ 0 };
+};
+
+inline TraceState trace_state;
+
+inline void
+trace_add(std::atomic<std::uint64_t>& counter, std::uint64_t n)
+{
+  counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+#define TRIES_TRACE_ADD(counter, n) (::util::trace_add(::util::trace_state.counter, (n)))
+#else
+#define TRIES_TRACE_ADD(counter, n) ((void)0)
+#endif
+
+constexpr bool TraceEnabled = TRIES_TRACE;
+
+// Current counters, all zero without TRIES_TRACE
+inline TraceCounters
+trace_snapshot()
+{
+  TraceCounters counters;
+#if TRIES_TRACE
+  counters.operations = trace_state.operations.load(std::memory_order_relaxed);
+  counters.nodes_visited = trace_state.nodes_visited.load(std::memory_order_relaxed);
+  counters.allocations = trace_state.allocations.load(std::memory_order_relaxed);
+  counters.frees = trace_state.frees.load(std::memory_order_relaxed);
+  counters.searches = trace_state.searches.load(std::memory_order_relaxed);
+  counters.probes = trace_state.probes.load(std::memory_order_relaxed);
+  counters.prunes = trace_state.prunes.load(std::memory_order_relaxed);
+#endif
+  return counters;
+}
+
+inline void
+reset_trace()
+{
+#if TRIES_TRACE
+  trace_state.operations = 0;
+  trace_state.nodes_visited = 0;
+  trace_state.allocations = 0;
+  trace_state.frees = 0;
+  trace_state.searches = 0;
+  trace_state.probes = 0;
+  trace_state.prunes = 0;
+#endif
+}
+}
+
+// Shape of a trie at one point in time, see stats() of the tries.
+// bytes_per_depth uses the estimate of size(), so its sum equals size().
+struct TrieStats
+{
+  std::size_t words = 0;
+  std::vector<std::size_t> nodes_per_depth; // the root is depth 0
+  std::vector<std::size_t> bytes_per_depth;
+  std::vector<std::size_t> fanout; // nodes by number of children
+  util::TraceCounters trace;       // trace_snapshot() taken with the stats
+
+  void add_node(std::size_t depth, std::size_t children, std::size_t bytes, bool is_end)
+  {
+    if (nodes_per_depth.size() <= depth) {
+      nodes_per_depth.resize(depth + 1);
+      bytes_per_depth.resize(depth + 1);
+    }
+    if (fanout.size() <= children)
+      fanout.resize(children + 1);
+    ++nodes_per_depth[depth];
+    bytes_per_depth[depth] += bytes;
+    ++fanout[children];
+    words += is_end ? 1 : 0;
+  }
+
+  [[nodiscard]] std::size_t nodes() const
+  {
+    std::size_t total = 0;
+    for (const auto count : nodes_per_depth)
+      total += count;
+    return total;
+  }
+
+  [[nodiscard]] std::size_t bytes() const
+  {
+    std::size_t total = 0;
+    for (const auto count : bytes_per_depth)
+      total += count;
+    return total;
+  }
+
+  // Length of the longest stored path
+  [[nodiscard]] std::size_t height() const { return nodes_per_depth.empty() ? 0 : nodes_per_depth.size() - 1; }
+};
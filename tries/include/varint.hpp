@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint> // for std::uint64_t
+#include <cstdio>  // for std::FILE, std::fgetc, EOF
+#include <string>  // for std::string
+
+// LEB128 varints: 7 bits per byte, least significant group first, the high bit set on all but the
+// last byte. Used by the DurableTrie log and snapshots, FrontCodedDictionary and the runs of
+// ti_programm's spill-and-merge construction.
+namespace util {
+inline void
+appendVarint(std::string& out, std::uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Returns false at the end of file or after 64 bits without a last byte
+inline bool
+readVarint(std::FILE* file, std::uint64_t& value)
+{
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    const int c = std::fgetc(file);
+    if (c == EOF)
+      return false;
+    value |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Decodes the varint at p and advances p past it, without bounds checks
+inline std::uint64_t
+decodeVarint(const char*& p)
+{
+  std::uint64_t value = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    const auto byte = static_cast<unsigned char>(*p++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+}
+}
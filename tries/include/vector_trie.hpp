@@ -2,11 +2,17 @@
 
 #include <algorithm> // std::find_if
 #include <cstddef>   // std::size_t
+#include <limits>    // std::numeric_limits
 #include <memory>    // std::unique_ptr, std::make_unique
 #include <string>    // std::string
-#include <utility>   // std::pair
+#include <utility>   // std::pair, std::as_const
 #include <vector>    // std::vector
 
+#include "node_compactor.hpp"
+#include "parallel_branches.hpp"
+#include "trie_finger.hpp"
+#include "trie_stats.hpp"
+
 class VectorTrie
 {
 private:
@@ -17,8 +23,12 @@ private:
   };
 
   std::unique_ptr<Node> root;
+  NodeCompactor<Node> compactor;
+  std::size_t epoch = 0; // bumped whenever nodes are freed or relocated, see TrieFinger
 
 public:
+  using Finger = TrieFinger<Node>;
+
   VectorTrie()
     : root(std::make_unique<Node>())
   {
@@ -27,6 +37,8 @@ public:
   // Insert a word (excluding trailing 0-byte or '$')
   bool insert(const std::string& word)
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() + 1);
     Node* curr = root.get();
     bool insertedNewNode = false;
 
@@ -34,10 +46,12 @@ public:
       auto uc = static_cast<unsigned char>(c);
 
       // Search in curr->children for c
-      auto it = std::find_if(curr->children.begin(), curr->children.end(), [uc](auto& p) { return p.first == uc; });
+      auto it = findChild(*curr, uc);
       if (it == curr->children.end()) {
-        // Not found -> create new child
+        // Not found -> create new child (may move the children vector)
+        compactor.restart();
         curr->children.push_back({ c, std::make_unique<Node>() });
+        TRIES_TRACE_ADD(allocations, 1);
         curr = curr->children.back().second.get();
         insertedNewNode = true;
       } else {
@@ -56,38 +70,272 @@ public:
   // Check if word is contained
   bool contains(const std::string& word) const
   {
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
     const Node* curr = root.get();
     for (char c : word) {
       auto uc = static_cast<unsigned char>(c);
-      auto it = std::find_if(curr->children.begin(), curr->children.end(), [uc](auto& p) { return p.first == uc; });
+      auto it = findChild(*curr, uc);
       if (it == curr->children.end()) {
         return false;
       }
       curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
     }
     return curr->is_end;
   }
 
   // Remove a word (return true if removal was successful)
-  bool remove(const std::string& word) { return removeHelper(root.get(), word, 0); }
+  bool remove(const std::string& word)
+  {
+    TRIES_TRACE_ADD(operations, 1);
+    compactor.restart();
+    ++epoch;
+    return removeHelper(root.get(), word, 0);
+  }
+
+  // insert, resuming from the path of the finger's previous operation
+  bool insert(const std::string& word, Finger& finger)
+  {
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, word.size() - depth + 1);
+    bool insertedNewNode = false;
+    for (; depth < word.size(); ++depth) {
+      const auto uc = static_cast<unsigned char>(word[depth]);
+      auto it = findChild(*curr, uc);
+      if (it == curr->children.end()) {
+        compactor.restart();
+        curr->children.push_back({ uc, std::make_unique<Node>() });
+        TRIES_TRACE_ADD(allocations, 1);
+        curr = curr->children.back().second.get();
+        insertedNewNode = true;
+      } else {
+        curr = it->second.get();
+      }
+      finger.descend(curr, word[depth]);
+    }
+    bool wasEnd = curr->is_end;
+    curr->is_end = true;
+    return (!wasEnd) || insertedNewNode;
+  }
+
+  // contains, resuming from the path of the finger's previous operation
+  bool contains(const std::string& word, Finger& finger) const
+  {
+    std::size_t depth = 0;
+    const Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      const auto uc = static_cast<unsigned char>(word[depth]);
+      auto it = findChild(*curr, uc);
+      if (it == curr->children.end())
+        return false;
+      curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(it->second.get(), word[depth]);
+    }
+    return curr->is_end;
+  }
+
+  // remove, resuming from the path of the finger's previous operation and pruning along it
+  bool remove(const std::string& word, Finger& finger)
+  {
+    compactor.restart();
+    std::size_t depth = 0;
+    Node* curr = finger.resume(root.get(), epoch, word, depth);
+    TRIES_TRACE_ADD(operations, 1);
+    TRIES_TRACE_ADD(nodes_visited, 1);
+    for (; depth < word.size(); ++depth) {
+      const auto uc = static_cast<unsigned char>(word[depth]);
+      auto it = findChild(*curr, uc);
+      if (it == curr->children.end())
+        return false;
+      curr = it->second.get();
+      TRIES_TRACE_ADD(nodes_visited, 1);
+      finger.descend(curr, word[depth]);
+    }
+    if (!curr->is_end)
+      return false;
+    curr->is_end = false;
+    if (depth == 0 || !curr->children.empty())
+      return depth == 0 && curr->children.empty();
+
+    // the other fingers may hold pruned nodes
+    finger.sync(++epoch);
+    [[maybe_unused]] const auto leaf_depth = depth;
+    while (depth > 0 && !curr->is_end && curr->children.empty()) {
+      finger.truncate(--depth);
+      curr = finger.node(depth);
+      curr->children.erase(findChild(*curr, static_cast<unsigned char>(word[depth])));
+      TRIES_TRACE_ADD(frees, 1);
+    }
+    // like removeHelper, count a prune only if a node was freed
+    TRIES_TRACE_ADD(prunes, depth < leaf_depth ? 1 : 0);
+    return depth == 0 && !curr->is_end && curr->children.empty();
+  }
 
   [[nodiscard]] std::size_t size() const { return sizeHelper(root.get()); }
 
+  // Nodes, words and size() by depth and the fanout histogram, with the current trace counters
+  [[nodiscard]] TrieStats stats() const
+  {
+    TrieStats result;
+    statsHelper(root.get(), 0, result);
+    result.trace = util::trace_snapshot();
+    return result;
+  }
+
+  // Adds every word of other (a different trie), taking over its subtrees where this trie has
+  // none instead of copying them. other is empty afterwards. Top-level branches present in both
+  // tries are merged in parallel.
+  void unite(VectorTrie&& other)
+  {
+    compactor.restart();
+    other.compactor.restart();
+    ++epoch;
+    ++other.epoch;
+    std::vector<std::pair<Node*, Node*>> shared;
+    uniteHelper(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) { uniteHelper(*shared[i].first, *shared[i].second, nullptr); });
+    other.root = std::make_unique<Node>();
+  }
+
+  // Keeps only the words also contained in other (a different trie)
+  void intersect(const VectorTrie& other) { filter<true>(other); }
+
+  // Removes every word contained in other (a different trie)
+  void subtract(const VectorTrie& other) { filter<false>(other); }
+
+  // Relocates all nodes into fresh memory in depth-first order and shrinks every children vector to its size
+  void compact()
+  {
+    compactor.restart();
+    compact_step(std::numeric_limits<std::size_t>::max());
+  }
+
+  // Incremental compact() in slices of at most budget nodes; returns true once a pass is complete.
+  // Inserting a new node or removing restarts the pass.
+  bool compact_step(std::size_t budget)
+  {
+    ++epoch;
+    const auto relocate = [](Node& old) {
+      auto fresh = std::make_unique<Node>();
+      fresh->is_end = old.is_end;
+      fresh->children.reserve(old.children.size());
+      for (auto& child : old.children)
+        fresh->children.emplace_back(child.first, std::move(child.second));
+      return fresh;
+    };
+    return compactor.step(root, budget, relocate, [](Node& node, auto&& visit) {
+      for (auto& child : node.children)
+        visit(child.second);
+    });
+  }
+
+  // Call visit(word) for every stored word (in insertion order of the children)
+  template<typename Visitor>
+  void for_each(Visitor&& visit) const
+  {
+    std::string word;
+    forEachHelper(root.get(), word, visit);
+  }
+
 private:
+  using Slot = std::unique_ptr<Node>*;
+
+  static decltype(Node::children)::const_iterator findChild(const Node& node, unsigned char uc)
+  {
+    const auto it = std::find_if(node.children.begin(), node.children.end(), [uc](auto& p) { return p.first == uc; });
+    TRIES_TRACE_ADD(searches, 1);
+    TRIES_TRACE_ADD(probes, static_cast<std::size_t>(it - node.children.begin()) + (it != node.children.end() ? 1u : 0u));
+    return it;
+  }
+
+  // Merges b into a. With shared set, subtrees present in both are collected instead of merged.
+  static void uniteHelper(Node& a, Node& b, std::vector<std::pair<Node*, Node*>>* shared)
+  {
+    a.is_end = a.is_end || b.is_end;
+    for (auto& [symbol, child] : b.children) {
+      const auto it = findChild(a, symbol);
+      if (it == a.children.end())
+        a.children.emplace_back(symbol, std::move(child));
+      else if (shared)
+        shared->emplace_back(it->second.get(), child.get());
+      else
+        uniteHelper(*it->second, *child, nullptr);
+    }
+  }
+
+  template<bool Intersect>
+  void filter(const VectorTrie& other)
+  {
+    compactor.restart();
+    ++epoch;
+    std::vector<std::pair<Slot, const Node*>> shared;
+    filterHelper<Intersect>(*root, *other.root, &shared);
+    util::parallel_branches(shared.size(), [&shared](std::size_t i) {
+      if (filterHelper<Intersect>(**shared[i].first, *shared[i].second, nullptr))
+        shared[i].first->reset();
+    });
+    std::erase_if(root->children, [](const auto& p) noexcept { return !p.second; });
+  }
+
+  // Intersects a with b or subtracts b from a; returns true if a holds no word afterwards.
+  // With shared set, subtrees present in both are collected instead of filtered and a is not
+  // compacted, so the collected slots stay valid.
+  template<bool Intersect>
+  static bool filterHelper(Node& a, const Node& b, std::vector<std::pair<Slot, const Node*>>* shared)
+  {
+    a.is_end = Intersect ? a.is_end && b.is_end : a.is_end && !b.is_end;
+    for (auto& [symbol, child] : a.children) {
+      const auto it = findChild(b, symbol);
+      if (it == b.children.end()) {
+        if (Intersect)
+          child.reset();
+      } else if (shared) {
+        shared->emplace_back(&child, it->second.get());
+      } else if (filterHelper<Intersect>(*child, *it->second, nullptr)) {
+        child.reset();
+      }
+    }
+    if (shared)
+      return false;
+    std::erase_if(a.children, [](const auto& p) noexcept { return !p.second; });
+    return !a.is_end && a.children.empty();
+  }
+
+  template<typename Visitor>
+  static void forEachHelper(const Node* node, std::string& word, Visitor& visit)
+  {
+    if (node->is_end)
+      visit(std::as_const(word));
+    for (auto& child : node->children) {
+      word.push_back(static_cast<char>(child.first));
+      forEachHelper(child.second.get(), word, visit);
+      word.pop_back();
+    }
+  }
+
   // Recursive helper for remove
   bool removeHelper(Node* node, const std::string& word, size_t index)
   {
     if (!node)
       return false;
+    TRIES_TRACE_ADD(nodes_visited, 1);
     if (index == word.size()) {
       if (!node->is_end)
         return false; // not found
       node->is_end = false;
+      if (index > 0 && node->children.empty())
+        TRIES_TRACE_ADD(prunes, 1);
       // Return true if this node has no children (caller can prune)
       return node->children.empty();
     }
     auto c = static_cast<unsigned char>(word[index]);
-    auto it = std::find_if(node->children.begin(), node->children.end(), [c](auto& p) { return p.first == c; });
+    auto it = findChild(*node, c);
     if (it == node->children.end()) {
       return false;
     }
@@ -97,6 +345,7 @@ private:
     if (shouldPrune) {
       // remove the pair from the vector
       node->children.erase(it);
+      TRIES_TRACE_ADD(frees, 1);
       // Return true if node has no children and is not end
       return (node->children.empty() && !node->is_end);
     }
@@ -114,4 +363,11 @@ private:
     }
     return total;
   }
+
+  static void statsHelper(const Node* node, std::size_t depth, TrieStats& stats)
+  {
+    stats.add_node(depth, node->children.size(), sizeof(*node) + node->children.capacity() * sizeof(std::pair<unsigned char, std::unique_ptr<Node>>), node->is_end);
+    for (auto& child : node->children)
+      statsHelper(child.second.get(), depth + 1, stats);
+  }
 };
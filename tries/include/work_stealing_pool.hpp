@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>          // for std::max
+#include <atomic>             // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef>            // for std::size_t
+#include <deque>              // for std::deque
+#include <exception>          // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <memory>             // for std::unique_ptr, std::make_unique
+#include <mutex>              // for std::mutex, std::lock_guard, std::unique_lock
+#include <thread>             // for std::thread
+#include <type_traits>        // for std::remove_reference_t
+#include <utility>            // for std::exchange
+#include <vector>             // for std::vector
+
+namespace util {
+// Fixed set of worker threads executing task(i) for i in [0, n) per run(), the calling thread
+// included. The indices are split into contiguous blocks, one deque per thread: a thread takes
+// from the back of its own deque and, once that is empty, steals from the front of the others,
+// so tasks of unequal cost (e.g. shards of different size) are balanced. Tasks of one run must
+// not depend on each other. run() calls from several threads are serialized. If tasks throw, the
+// other tasks still run and run() rethrows the first exception once all threads are done.
+class WorkStealingPool
+{
+private:
+  struct alignas(64) Queue
+  {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+  };
+
+  std::vector<std::thread> threads;
+  std::unique_ptr<Queue[]> queues; // threads.size() + 1, the last one is the caller's
+  void (*job)(void*, std::size_t) = nullptr; // calls the task of the current run
+  void* context = nullptr;                    // the task
+
+  std::mutex run_mutex;
+  std::mutex state_mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::size_t generation = 0; // bumped by every run()
+  std::size_t busy = 0;       // workers inside the current run
+  std::exception_ptr failure; // first exception thrown by a task of the current run
+  bool stopping = false;
+  std::atomic<std::size_t> stolen{ 0 };
+
+  bool take(std::size_t self, std::size_t& task)
+  {
+    {
+      auto& own = queues[self];
+      std::lock_guard lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = own.tasks.back();
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+    const auto count = threads.size() + 1;
+    for (std::size_t k = 1; k < count; ++k) {
+      auto& victim = queues[(self + k) % count];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // tasks are only added before a run starts, so empty deques mean this thread is done
+  void work(std::size_t self)
+  {
+    std::size_t task;
+    while (take(self, task)) {
+      try {
+        job(context, task);
+      } catch (...) {
+        std::lock_guard lock(state_mutex);
+        if (!failure)
+          failure = std::current_exception();
+      }
+    }
+  }
+
+  // Waits until every worker that joined the run has left it, the job must outlive them
+  void finish()
+  {
+    std::unique_lock lock(state_mutex);
+    idle.wait(lock, [&] { return busy == 0; });
+    if (failure)
+      std::rethrow_exception(std::exchange(failure, nullptr));
+  }
+
+  void workerLoop(std::size_t self)
+  {
+    std::size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock lock(state_mutex);
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping)
+          return;
+        seen = generation;
+        ++busy;
+      }
+      work(self);
+      {
+        std::lock_guard lock(state_mutex);
+        --busy;
+      }
+      idle.notify_all();
+    }
+  }
+
+public:
+  // Starts threads - 1 workers, the caller of run() is the last thread
+  explicit WorkStealingPool(std::size_t num_threads = std::max(1u, std::thread::hardware_concurrency()))
+    : queues(std::make_unique<Queue[]>(std::max<std::size_t>(num_threads, 1)))
+  {
+    for (std::size_t t = 0; t + 1 < num_threads; ++t)
+      threads.emplace_back([this, t] { workerLoop(t); });
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  ~WorkStealingPool()
+  {
+    {
+      std::lock_guard lock(state_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  [[nodiscard]] std::size_t thread_count() const { return threads.size() + 1; }
+
+  // Tasks taken from another thread's deque since construction
+  [[nodiscard]] std::size_t steals() const { return stolen.load(std::memory_order_relaxed); }
+
+  // Runs task(i) for every i in [0, n) and returns once all are done, rethrowing the first
+  // exception of a task
+  template<typename Task>
+  void run(std::size_t n, Task&& task)
+  {
+    std::lock_guard run_lock(run_mutex);
+    const auto count = thread_count();
+    // a worker still leaving the previous run may already take these tasks, so the job comes first
+    using TaskType = std::remove_reference_t<Task>;
+    job = [](void* task_, std::size_t i) { (*static_cast<TaskType*>(task_))(i); };
+    context = const_cast<void*>(static_cast<const void*>(&task));
+    try {
+      for (std::size_t q = 0; q < count; ++q) {
+        std::lock_guard lock(queues[q].mutex);
+        for (auto i = q * n / count; i < (q + 1) * n / count; ++i)
+          queues[q].tasks.push_back(i);
+      }
+    } catch (...) {
+      // no task may run after the exception left run()
+      for (std::size_t q = 0; q < count; ++q) {
+        std::lock_guard lock(queues[q].mutex);
+        queues[q].tasks.clear();
+      }
+      finish();
+      throw;
+    }
+
+    if (!threads.empty()) {
+      {
+        std::lock_guard lock(state_mutex);
+        ++generation;
+      }
+      wake.notify_all();
+    }
+    work(count - 1);
+    finish();
+  }
+};
+}